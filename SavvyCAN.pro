@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT = core gui printsupport qml serialbus serialport widgets help network opengl
+QT = core concurrent gui printsupport qml serialbus serialport widgets help network opengl
 
 CONFIG(release, debug|release):DEFINES += QT_NO_DEBUG_OUTPUT
 
@@ -22,6 +22,7 @@ ICON = icons/SavvyIcon.icns
 SOURCES += main.cpp\
     canbridgewindow.cpp \
     connections/canserver.cpp \
+    continuouslogger.cpp \
     connections/lawicel_serial.cpp \
     connections/mqtt_bus.cpp \
     dbc/dbcnodeduplicateeditor.cpp \
@@ -48,6 +49,8 @@ SOURCES += main.cpp\
     candatagrid.cpp \
     framesenderwindow.cpp \
     framefileio.cpp \
+    frameexporter.cpp \
+    loadfilterdialog.cpp \
     mainsettingsdialog.cpp \
     firmwareuploaderwindow.cpp \
     scriptingwindow.cpp \
@@ -67,6 +70,8 @@ SOURCES += main.cpp\
     dbc/dbcmessageeditor.cpp \
     dbc/dbc_classes.cpp \
     dbc/dbchandler.cpp \
+    dbc/signaldecoder.cpp \
+    dbc/dbcsnapshot.cpp \
     dbc/dbcloadsavewindow.cpp \
     dbc/dbcmaineditor.cpp \
     dbc/dbcnodeeditor.cpp \
@@ -84,6 +89,9 @@ SOURCES += main.cpp\
     connections/canconnectionmodel.cpp \
     connections/connectionwindow.cpp \
     re/graphingwindow.cpp \
+    re/graphbuildjob.cpp \
+    re/valuelabellayer.cpp \
+    re/spreadsheetexportjob.cpp \
     re/newgraphdialog.cpp \
     bisectwindow.cpp \
     signalviewerwindow.cpp \
@@ -98,7 +106,7 @@ SOURCES += main.cpp\
     connections/newconnectiondialog.cpp \
     re/temporalgraphwindow.cpp \
     filterutility.cpp \
-    pcaplite.cpp
+    pcaphandler.cpp
 
 HEADERS  += mainwindow.h \
     can_structs.h \
@@ -139,6 +147,8 @@ HEADERS  += mainwindow.h \
     framesenderwindow.h \
     can_trigger_structs.h \
     framefileio.h \
+    frameexporter.h \
+    loadfilterdialog.h \
     config.h \
     mainsettingsdialog.h \
     firmwareuploaderwindow.h \
@@ -146,6 +156,12 @@ HEADERS  += mainwindow.h \
     scriptcontainer.h \
     canfilter.h \
     utils/lfqueue.h \
+    utils/fastformat.h \
+    utils/bitextractor.h \
+    utils/minmaxpyramid.h \
+    utils/plotrendering.h \
+    utils/temporalbins.h \
+    utils/frameidindex.h \
     motorcontrollerconfigwindow.h \
     connections/canconnection.h \
     connections/serialbusconnection.h \
@@ -158,6 +174,8 @@ HEADERS  += mainwindow.h \
     re/sniffer/snifferwindow.h \
     dbc/dbc_classes.h \
     dbc/dbchandler.h \
+    dbc/signaldecoder.h \
+    dbc/dbcsnapshot.h \
     dbc/dbcloadsavewindow.h \
     dbc/dbcmaineditor.h \
     dbc/dbcsignaleditor.h \
@@ -175,6 +193,9 @@ HEADERS  += mainwindow.h \
     connections/canconnectionmodel.h \
     connections/connectionwindow.h \
     re/graphingwindow.h \
+    re/graphbuildjob.h \
+    re/valuelabellayer.h \
+    re/spreadsheetexportjob.h \
     re/newgraphdialog.h \
     bisectwindow.h \
     signalviewerwindow.h \
@@ -190,7 +211,7 @@ HEADERS  += mainwindow.h \
     connections/newconnectiondialog.h \
     re/temporalgraphwindow.h \
     filterutility.h \
-    pcaplite.h
+    pcaphandler.h
 
 FORMS    += ui/candatagrid.ui \
     ui/canbridgewindow.ui \
@@ -214,6 +235,7 @@ FORMS    += ui/candatagrid.ui \
     ui/graphingwindow.ui \
     ui/isotp_interpreterwindow.ui \
     ui/mainsettingsdialog.ui \
+    ui/loadfilterdialog.ui \
     ui/mainwindow.ui \
     ui/motorcontrollerconfigwindow.ui \
     ui/newgraphdialog.ui \
@@ -3,6 +3,7 @@
 #include <QFile>
 #include <QString>
 #include <QtEndian>
+#include "framefileio.h"
 
 #define BLF_REMOTE_FLAG 0x80
 
@@ -120,7 +121,7 @@ bool BLFHandler::loadBLF(QString filename, QVector<CANFrame>* frames)
                             frame.setPayload(bytes);
                             //Should we divide by a thousand or a million? Unsure here. It appears some logs are stamped in microseconds and some in milliseconds?
                             frame.setTimeStamp(QCanBusFrame::TimeStamp(0, obj.header.v1Obj.uncompSize / 1000.0)); //uncompsize field also used for timestamp oddly enough
-                            frames->append(frame);
+                            if (FrameFileIO::passesLoadFilter(frame)) frames->append(frame);
                         }
                         else if (obj.header.base.objType == BLF_CAN_MSG2)
                         {
@@ -141,7 +142,7 @@ bool BLFHandler::loadBLF(QString filename, QVector<CANFrame>* frames)
                             frame.setPayload(bytes);
                             //Should we divide by a thousand or a million? Unsure here. It appears some logs are stamped in microseconds and some in milliseconds?
                             frame.setTimeStamp(QCanBusFrame::TimeStamp(0, obj.header.v1Obj.uncompSize / 1000.0)); //uncompsize field also used for timestamp oddly enough
-                            frames->append(frame);
+                            if (FrameFileIO::passesLoadFilter(frame)) frames->append(frame);
                         }
                         else
                         {
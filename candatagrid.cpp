@@ -62,6 +62,7 @@ CANDataGrid::CANDataGrid(QWidget *parent) :
     ui(new Ui::CANDataGrid)
 {
     ui->setupUi(this);
+    setAttribute(Qt::WA_OpaquePaintEvent); //gridCache covers the whole widget, no need for Qt to clear it first
 
     gridMode = GridMode::CHANGED_BITS;
 
@@ -86,6 +87,8 @@ CANDataGrid::CANDataGrid(QWidget *parent) :
     grayBrush = QBrush(QColor(230,230,230));
     xOffset = 0;
     yOffset = 0;
+    cachedBytesToDraw = 0;
+    cachedMode = gridMode;
 
     //generate the palette
 
@@ -223,13 +226,52 @@ int CANDataGrid::getUsedSignalNum(int bit)
     return usedSignalNum[bit];
 }
 
+void CANDataGrid::changeEvent(QEvent *event)
+{
+    //colors or fonts of the labels might have changed, have the whole grid drawn again
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange || event->type() == QEvent::StyleChange)
+        gridCache = QPixmap();
+    QWidget::changeEvent(event);
+}
+
+/*
+ * The grid is drawn into gridCache and the widget just gets that copied over. As long as the size and layout stay the same
+ * only the cells which look different than they did last time get drawn again, which during playback is only a handful
+ * of them. Signal view is always drawn in full as the signal names run across cells, it only changes when another
+ * message gets picked anyway.
+*/
 void CANDataGrid::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
 
-    paintCommonBeginning();
-    paintGridCells();
-    paintCommonEnding();
+    qreal ratio = devicePixelRatioF();
+    QSize cacheSize = size() * ratio;
+    if (gridCache.isNull() || gridCache.size() != cacheSize || cachedBytesToDraw != bytesToDraw
+            || cachedMode != gridMode || gridMode == GridMode::SIGNAL_VIEW)
+    {
+        gridCache = QPixmap(cacheSize);
+        gridCache.setDevicePixelRatio(ratio);
+        gridCache.fill(palette().color(backgroundRole()));
+        cachedBytesToDraw = bytesToDraw;
+        cachedMode = gridMode;
+        cellLooks.clear();
+
+        painter = new QPainter(&gridCache);
+        paintCommonBeginning();
+        paintGridCells();
+        paintCommonEnding();
+    }
+    else
+    {
+        painter = new QPainter(&gridCache);
+        painter->setPen(QPen(Qt::black));
+        painter->setFont(mainFont);
+        paintGridCells();
+        delete painter;
+    }
+
+    QPainter widgetPainter(this);
+    widgetPainter.drawPixmap(0, 0, gridCache);
 }
 
 /*
@@ -243,8 +285,7 @@ void CANDataGrid::paintCommonBeginning()
 {
     int x;
 
-    painter = new QPainter(this);
-    viewport = painter->viewport();
+    viewport = rect();
 
     neededXDivisions = 8;
     neededYDivisions = 8;
@@ -339,109 +380,134 @@ void CANDataGrid::paintCommonBeginning()
     painter->setFont(mainFont);
 }
 
-void CANDataGrid::paintGridCells()
+//now, color the bitfield by seeing if a given bit is freshly set/unset in the new data
+//compared to the old. Bits that are not set in either are white, bits set in both are black
+//bits that used to be set but now are unset are red, bits that used to be unset but now are set
+//are green
+GridCellLook CANDataGrid::getCellLook(int x, int y)
 {
-    int x, y, bit;
-    unsigned char prevByte, thisByte;
-    bool thisBit, prevBit;
+    GridCellLook look;
+    int byteIdx = (y * (neededXDivisions / 8) + (x / 8));
+    unsigned char thisByte = data[byteIdx];
+    unsigned char prevByte = refData[byteIdx];
+    int bitIdx = ((neededXDivisions - 1) - x) & 7;
+    int bit = (byteIdx * 8) + bitIdx;
+    bool thisBit = false;
+    bool prevBit = false;
     int usedSigNum;
-    QString prevSigName;
+    if ((thisByte & (1 << bitIdx)) == (1 << bitIdx)) thisBit = true;
+    if ((prevByte & (1 << bitIdx)) == (1 << bitIdx)) prevBit = true;
 
-    //now, color the bitfield by seeing if a given bit is freshly set/unset in the new data
-    //compared to the old. Bits that are not set in either are white, bits set in both are black
-    //bits that used to be set but now are unset are red, bits that used to be unset but now are set
-    //are green
-
-    for (y = 0; y < neededYDivisions; y++)
+    if (gridMode == GridMode::HEAT_VIEW)
     {
-        for (x = 0; x < neededXDivisions; x++)
+        look.brush = QBrush(fire[heatData[bit]]);
+    }
+    else
+    {
+        if (thisBit)
         {
-            int byteIdx = (y * (neededXDivisions / 8) + (x / 8));
-            thisByte = data[byteIdx];
-            prevByte = refData[byteIdx];
-            int bitIdx = ((neededXDivisions - 1) - x) & 7;
-            bit = (byteIdx * 8) + bitIdx;
-            thisBit = false;
-            prevBit = false;
-            if ((thisByte & (1 << bitIdx)) == (1 << bitIdx)) thisBit = true;
-            if ((prevByte & (1 << bitIdx)) == (1 << bitIdx)) prevBit = true;
-
-            if (gridMode == GridMode::HEAT_VIEW)
+            if (prevBit)
             {
-                painter->setBrush(QBrush(fire[heatData[bit]]));
+                if ((signalColors.count() > 0) && (gridMode == GridMode::SIGNAL_VIEW)) look.brush = blackHashBrush;
+                else look.brush = blackBrush;
             }
             else
             {
-                if (thisBit)
-                {
-                    if (prevBit)
-                    {
-                        if ((signalColors.count() > 0) && (gridMode == GridMode::SIGNAL_VIEW)) painter->setBrush(blackHashBrush);
-                        else painter->setBrush(blackBrush);
-                    }
-                    else
-                    {
-                        if ((signalColors.count() > 0) && (gridMode == GridMode::SIGNAL_VIEW)) painter->setBrush(greenHashBrush);
-                        else painter->setBrush(greenBrush);
-                    }
-                }
-                else
+                if ((signalColors.count() > 0) && (gridMode == GridMode::SIGNAL_VIEW)) look.brush = greenHashBrush;
+                else look.brush = greenBrush;
+            }
+        }
+        else
+        {
+            if (prevBit)
+            {
+                look.brush = redBrush;
+            }
+            else
+            {
+                usedSigNum = -1;
+                if ((usedData[byteIdx] & (1 << bitIdx)) == (1 << bitIdx))
                 {
-                    if (prevBit)
+                    if (gridMode == GridMode::SIGNAL_VIEW) usedSigNum = getUsedSignalNum(bit);
+                    if (usedSigNum == -1)
                     {
-                        painter->setBrush(redBrush);
+                        grayBrush = QBrush(QColor(0xB6, 0xB6, 0xB6), Qt::BDiagPattern);
+                        look.brush = grayBrush;
                     }
                     else
                     {
-                        usedSigNum = -1;
-                        if ((usedData[byteIdx] & (1 << bitIdx)) == (1 << bitIdx))
-                        {
-                            if (gridMode == GridMode::SIGNAL_VIEW) usedSigNum = getUsedSignalNum(bit);
-                            if (usedSigNum == -1)
-                            {
-                                grayBrush = QBrush(QColor(0xB6, 0xB6, 0xB6), Qt::BDiagPattern);
-                                painter->setBrush(grayBrush);
-                            }
-                            else
-                            {
-                                int idx = usedSigNum % signalColors.length(); //can only use as many colors as have been defined
-                                painter->setBrush(QBrush(signalColors[idx]));
-                            }
-                        }
-                        else painter->setBrush(whiteBrush);
+                        int idx = usedSigNum % signalColors.length(); //can only use as many colors as have been defined
+                        look.brush = QBrush(signalColors[idx]);
                     }
                 }
+                else look.brush = whiteBrush;
             }
+        }
+    }
 
-            painter->drawRect(nearX + (x * xSector), nearY + (y * ySector), xSector, ySector);
-            switch (textStates[byteIdx][bitIdx])
-            {
-            case GridTextState::NORMAL:
-                if (thisBit && prevBit) painter->setPen(QPen(Qt::gray));
-                else painter->setPen(QPen(Qt::black));
-                painter->setFont(mainFont);
-                break;
-            case GridTextState::BOLD_BLUE:
-                painter->setPen(QPen(Qt::blue));
-                painter->setFont(boldFont);
-                break;
-            case GridTextState::INVERT:
-                painter->setFont(mainFont);
-                QColor brushColor = painter->brush().color();
-                painter->setPen(QColor(255-brushColor.red(), 255-brushColor.green(), 255-brushColor.blue()));
-                break;
-            }
-            //change style of bit number output for current signal
-            //if (thisBit) painter->setFont(boldFont);
-           // else painter->setFont(mainFont);
-            //painter->setFont(smallFont);
-            if (gridMode != GridMode::SIGNAL_VIEW)
-                painter->drawText(QRect(nearX + (x * xSector), nearY + (y * ySector), xSector, ySector), Qt::AlignCenter, QString::number(bit)); //center center of grid
-            else
-                painter->drawText(QRect(nearX + (x * xSector), nearY + (y * ySector), xSector, ySector), Qt::AlignLeft, QString::number(bit)); //upper left of grid
+    look.bold = false;
+    switch (textStates[byteIdx][bitIdx])
+    {
+    case GridTextState::NORMAL:
+        if (thisBit && prevBit) look.textColor = Qt::gray;
+        else look.textColor = Qt::black;
+        break;
+    case GridTextState::BOLD_BLUE:
+        look.textColor = Qt::blue;
+        look.bold = true;
+        break;
+    case GridTextState::INVERT:
+        QColor brushColor = look.brush.color();
+        look.textColor = QColor(255-brushColor.red(), 255-brushColor.green(), 255-brushColor.blue());
+        break;
+    }
+    return look;
+}
+
+void CANDataGrid::paintCell(int x, int y, const GridCellLook &look)
+{
+    QRect cell(nearX + (x * xSector), nearY + (y * ySector), xSector, ySector);
+    int bit = gridToBitPosition(x, y);
+
+    //hatched brushes leave whatever was there before showing through so clear it out first
+    painter->fillRect(cell, palette().color(backgroundRole()));
+    painter->setBrush(look.brush);
+    painter->drawRect(cell);
+
+    painter->setPen(QPen(look.textColor));
+    if (look.bold) painter->setFont(boldFont);
+    //change style of bit number output for current signal
+    //if (thisBit) painter->setFont(boldFont);
+   // else painter->setFont(mainFont);
+    //painter->setFont(smallFont);
+    if (gridMode != GridMode::SIGNAL_VIEW)
+        painter->drawText(cell, Qt::AlignCenter, QString::number(bit)); //center center of grid
+    else
+        painter->drawText(cell, Qt::AlignLeft, QString::number(bit)); //upper left of grid
+
+    painter->setFont(mainFont);
+    painter->setPen(QPen(Qt::black));
+}
+
+//Draws the cells which don't look like they do in gridCache yet, all of them after a full repaint cleared cellLooks
+void CANDataGrid::paintGridCells()
+{
+    int x, y, bit;
+    int usedSigNum;
+    QString prevSigName;
+
+    bool repaintAll = cellLooks.isEmpty();
+    cellLooks.resize(neededXDivisions * neededYDivisions);
 
-            painter->setFont(mainFont);
-            painter->setPen(QPen(Qt::black));
+    for (y = 0; y < neededYDivisions; y++)
+    {
+        for (x = 0; x < neededXDivisions; x++)
+        {
+            GridCellLook look = getCellLook(x, y);
+            GridCellLook &cached = cellLooks[(y * neededXDivisions) + x];
+            if (!repaintAll && look == cached) continue;
+            cached = look;
+            paintCell(x, y, look);
         }
     }
 
@@ -543,6 +609,8 @@ void CANDataGrid::paintCommonEnding()
     //and we don't need these anymore after we're done drawing
     delete painter;
     delete smallMetric;
+    delete largeMetric;
+    largeMetric = nullptr;
 }
 
 //given a grid cell we return which bit position that is within the CAN frame.
@@ -1,6 +1,7 @@
 #ifndef CANDATAGRID_H
 #define CANDATAGRID_H
 
+#include <QPixmap>
 #include <QWidget>
 
 namespace Ui {
@@ -42,6 +43,23 @@ enum GridMode
 
 extern QVector<QColor> signalColors;
 
+//How one cell of the grid looks. The cached grid image only gets a cell drawn again when this changes
+struct GridCellLook
+{
+    QBrush brush;
+    QColor textColor;
+    bool bold;
+
+    bool operator==(const GridCellLook &other) const
+    {
+        return brush == other.brush && textColor == other.textColor && bold == other.bold;
+    }
+    bool operator!=(const GridCellLook &other) const
+    {
+        return !(*this == other);
+    }
+};
+
 class CANDataGrid : public QWidget
 {
     Q_OBJECT
@@ -67,6 +85,7 @@ public:
 
 protected:
     void mousePressEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
+    void changeEvent(QEvent *event) Q_DECL_OVERRIDE;
 
 signals:
     void gridClicked(int bitClicked);
@@ -105,8 +124,14 @@ private:
     QFontMetrics *smallMetric;
     QFontMetrics *largeMetric;
     QColor fire[256];
+    QPixmap gridCache; //the whole grid as last painted, see paintEvent
+    int cachedBytesToDraw;
+    GridMode cachedMode;
+    QVector<GridCellLook> cellLooks; //how each cell in gridCache looks, row by row
 
     void paintGridCells();
+    GridCellLook getCellLook(int x, int y);
+    void paintCell(int x, int y, const GridCellLook &look);
     void paintCommonBeginning();
     void paintCommonEnding();    
     int gridToBitPosition(int x, int y);
@@ -83,6 +83,7 @@ CANFrameModel::CANFrameModel(QObject *parent)
     timeFormat =  "MMM-dd HH:mm:ss.zzz";
     sortDirAsc = false;
     bytesPerLine = 8;
+    newFrameHolds = 0;
 }
 
 void CANFrameModel::setBytesPerLine(int bpl)
@@ -551,26 +552,41 @@ QVariant CANFrameModel::data(const QModelIndex &index, int role) const
                 {
                     tempString.append("   <" + msg->name + ">\n");
                     if (msg->comment.length() > 1) tempString.append(msg->comment + "\n");
+                    QVector<DBC_DECODED_SIGNAL> decoded;
+                    msg->sigHandler->decodeFrame(thisFrame, decoded);
+
+                    //decoded holds the top level signals in order, each multiplexor followed by what it selects
+                    QHash<const DBC_SIGNAL *, int> topLevel;
+                    QSet<const DBC_SIGNAL *> present;
+                    for (int j = 0; j < decoded.count(); j++)
+                    {
+                        if (decoded[j].signal->multiplexParent == nullptr) topLevel.insert(decoded[j].signal, j);
+                        else present.insert(decoded[j].signal);
+                        if (overwriteDups && decoded[j].signal->isMultiplexed) lastSignalValues[decoded[j].signal] = decoded[j].value;
+                    }
+
+                    //signals are listed in the order the message defines them, whether or not they're in this frame
                     for (int j = 0; j < msg->sigHandler->getCount(); j++)
-                    {                        
-                        QString sigString;
+                    {
                         DBC_SIGNAL* sig = msg->sigHandler->findSignalByIdx(j);
-
-                        if ( (sig->multiplexParent == nullptr) && sig->processAsText(thisFrame, sigString))
+                        if (sig->multiplexParent == nullptr)
                         {
-                            tempString.append(sigString);
-                            tempString.append("\n");
-                            if (sig->isMultiplexor)
+                            QHash<const DBC_SIGNAL *, int>::const_iterator top = topLevel.constFind(sig);
+                            if (top == topLevel.constEnd()) continue;
+                            int k = top.value();
+                            do
                             {
-                                qDebug() << "Multiplexor. Diving into the tree";
-                                tempString.append(sig->processSignalTree(thisFrame));
-                            }
+                                tempString.append(decoded[k].signal->makePrettyOutput(decoded[k].value));
+                                tempString.append("\n");
+                                k++;
+                            } while (k < decoded.count() && decoded[k].signal->multiplexParent != nullptr);
                         }
-                        else if (sig->isMultiplexed && overwriteDups) //wasn't in this exact frame but is in the message. Use cached value
+                        //multiplexed signals not in this exact frame show the last value this model saw for them
+                        else if (sig->isMultiplexed && overwriteDups && !present.contains(sig))
                         {
-                            bool isInteger = false;
-                            if (sig->valType == UNSIGNED_INT || sig->valType == SIGNED_INT) isInteger = true;
-                            tempString.append(sig->makePrettyOutput(sig->cachedValue.toDouble(), sig->cachedValue.toLongLong(), true, isInteger));
+                            QHash<const DBC_SIGNAL *, DBC_SIGNAL_VALUE>::const_iterator last = lastSignalValues.constFind(sig);
+                            if (last == lastSignalValues.constEnd()) continue;
+                            tempString.append(sig->makePrettyOutput(last.value()));
                             tempString.append("\n");
                         }
                     }
@@ -761,6 +777,12 @@ void CANFrameModel::addFrame(const CANFrame& frame, bool autoRefresh = false)
 
 void CANFrameModel::addFrames(const CANConnection*, const QVector<CANFrame>& pFrames)
 {
+    if (newFrameHolds > 0)
+    {
+        heldFrames += pFrames;
+        return;
+    }
+
     if(frames.length() > frames.capacity() * 0.99)
     {
         mutex.lock();
@@ -790,6 +812,26 @@ void CANFrameModel::addFrames(const CANConnection*, const QVector<CANFrame>& pFr
     }
 }
 
+/*
+ * Something is working through its own copy of the frame list. The copy is implicitly shared with the list here so the
+ * first frame appended would make the list detach, copying every frame there is right in the middle of capturing.
+ * Until every hold is released new frames are set aside instead and then added all at once.
+*/
+void CANFrameModel::holdNewFrames()
+{
+    newFrameHolds++;
+}
+
+void CANFrameModel::releaseNewFrames()
+{
+    if (newFrameHolds == 0) return;
+    if (--newFrameHolds > 0 || heldFrames.isEmpty()) return;
+
+    QVector<CANFrame> pending;
+    pending.swap(heldFrames);
+    addFrames(nullptr, pending);
+}
+
 void CANFrameModel::sendRefresh()
 {
     qDebug() << "Sending mass refresh";    
@@ -855,6 +897,8 @@ void CANFrameModel::clearFrames()
     this->beginResetModel();
     frames.clear();
     filteredFrames.clear();
+    heldFrames.clear();
+    lastSignalValues.clear();
     if(filtersPersistDuringClear == false)
     {
         filters.clear();
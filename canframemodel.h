@@ -2,10 +2,12 @@
 #define CANFRAMEMODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QList>
 #include <QVector>
 #include <QDebug>
 #include <QMutex>
+#include <QSet>
 #include "can_structs.h"
 #include "dbc/dbchandler.h"
 #include "connections/canconnection.h"
@@ -71,6 +73,8 @@ public:
 public slots:
     void addFrame(const CANFrame&, bool);
     void addFrames(const CANConnection*, const QVector<CANFrame>&);
+    void holdNewFrames();
+    void releaseNewFrames();
 
 signals:
     void updatedFiltersList();
@@ -90,6 +94,7 @@ private:
     QMutex mutex;
     bool interpretFrames; //should we use the dbcHandler?
     bool overwriteDups; //should we display all frames or only the newest for each ID?
+    mutable QHash<const DBC_SIGNAL *, DBC_SIGNAL_VALUE> lastSignalValues; //last value shown for each multiplexed signal, for overwrite mode
     bool filtersPersistDuringClear;
     QString timeFormat;
     TimeStyle timeStyle;
@@ -101,6 +106,8 @@ private:
     uint32_t preallocSize;
     bool sortDirAsc;
     int bytesPerLine;
+    int newFrameHolds; //while above 0 incoming frames wait in heldFrames instead of going into the lists
+    QVector<CANFrame> heldFrames;
 };
 
 
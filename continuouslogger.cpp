@@ -0,0 +1,345 @@
+#include "continuouslogger.h"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtEndian>
+#include "frameexporter.h"
+
+//once at least this much has been formatted the whole buffer is written out in one go
+#define LOG_WRITE_THRESHOLD     (1024 * 1024)
+//the most formatFrame can add for one frame. A 64 byte CAN-FD frame is 79 bytes in binary and 96 as CSV
+#define LOG_MAX_RECORD_SIZE     256
+
+ContinuousLogger::ContinuousLogger()
+{
+    mThread_p = new QThread();
+
+    drainScheduled = false;
+    logging = false;
+    logFormat = CLF_GVRET_CSV;
+    rotateAtBytes = 0;
+    rotateAtSeconds = 0;
+    rotationIndex = 0;
+    bytesInFile = 0;
+    outUsed = 0;
+    flushTimer = nullptr;
+}
+
+ContinuousLogger::~ContinuousLogger()
+{
+    mThread_p->quit();
+    mThread_p->wait();
+    delete mThread_p;
+}
+
+void ContinuousLogger::initialize()
+{
+    if( mThread_p && (mThread_p != QThread::currentThread()) )
+    {
+        /* move ourself to the thread */
+        moveToThread(mThread_p);
+        /* connect started() */
+        connect(mThread_p, SIGNAL(started()), this, SLOT(initialize()));
+        /* start the thread. Logging isn't time critical, the disk is the bottleneck anyway */
+        mThread_p->start(QThread::LowPriority);
+        return;
+    }
+
+    /* in multithread case, this will be called before entering thread event loop */
+    return piStart();
+}
+
+void ContinuousLogger::finalize()
+{
+    /* 1) execute in mThread_p context */
+    if( mThread_p && (mThread_p != QThread::currentThread()) )
+    {
+        /* if thread is finished, it means we call this function for the second time so we can leave */
+        if( !mThread_p->isFinished() )
+        {
+            /* we need to call piStop() */
+            QMetaObject::invokeMethod(this, "finalize",
+                                      Qt::BlockingQueuedConnection);
+            /* 3) stop thread */
+            mThread_p->quit();
+            if(!mThread_p->wait()) {
+                qDebug() << "can't stop thread";
+            }
+        }
+        return;
+    }
+
+    /* 2) call piStop in mThread context */
+    return piStop();
+}
+
+void ContinuousLogger::piStart()
+{
+    outBuffer.resize(LOG_WRITE_THRESHOLD + LOG_MAX_RECORD_SIZE);
+    outUsed = 0;
+
+    //anything sitting in the output buffer makes it to the disk within a second even when traffic is light
+    flushTimer = new QTimer();
+    flushTimer->setInterval(1000);
+    connect(flushTimer, &QTimer::timeout, this, &ContinuousLogger::flushTimerTriggered);
+    flushTimer->start();
+}
+
+void ContinuousLogger::piStop()
+{
+    closeLog();
+    if (flushTimer)
+    {
+        flushTimer->stop();
+        delete flushTimer;
+        flushTimer = nullptr;
+    }
+}
+
+void ContinuousLogger::queueFrames(const QVector<CANFrame> &frames)
+{
+    QMutexLocker locker(&pendingMutex);
+
+    if (!logging) return;
+
+    pendingFrames.append(frames);
+    if (!drainScheduled)
+    {
+        drainScheduled = true;
+        QMetaObject::invokeMethod(this, "drainPending", Qt::QueuedConnection);
+    }
+}
+
+bool ContinuousLogger::open(QString filename, int format, qint64 rotateBytes, int rotateSeconds)
+{
+    bool result = false;
+
+    /* make sure we execute in mThread context */
+    if( mThread_p && (mThread_p != QThread::currentThread()) ) {
+        QMetaObject::invokeMethod(this, "openLog",
+                                  Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(bool, result),
+                                  Q_ARG(QString, filename),
+                                  Q_ARG(int, format),
+                                  Q_ARG(qint64, rotateBytes),
+                                  Q_ARG(int, rotateSeconds));
+        return result;
+    }
+
+    return openLog(filename, format, rotateBytes, rotateSeconds);
+}
+
+void ContinuousLogger::close()
+{
+    /* make sure we execute in mThread context */
+    if( mThread_p && (mThread_p != QThread::currentThread()) ) {
+        QMetaObject::invokeMethod(this, "closeLog",
+                                  Qt::BlockingQueuedConnection);
+        return;
+    }
+
+    closeLog();
+}
+
+bool ContinuousLogger::isLogging()
+{
+    QMutexLocker locker(&pendingMutex);
+    return logging;
+}
+
+QString ContinuousLogger::currentFileName()
+{
+    QMutexLocker locker(&pendingMutex);
+    return activeFileName;
+}
+
+bool ContinuousLogger::openLog(QString filename, int format, qint64 rotateBytes, int rotateSeconds)
+{
+    closeLog();
+
+    baseFileName = filename;
+    logFormat = format;
+    rotateAtBytes = rotateBytes;
+    rotateAtSeconds = rotateSeconds;
+    rotationIndex = 0;
+
+    if (!openFile(filename)) return false;
+
+    QMutexLocker locker(&pendingMutex);
+    logging = true;
+    return true;
+}
+
+void ContinuousLogger::closeLog()
+{
+    {
+        QMutexLocker locker(&pendingMutex);
+        logging = false;
+    }
+
+    //whatever was queued before logging stopped still belongs in this log. The final write doesn't rotate, there'd be
+    //nothing left to put in the next file
+    drainPending();
+    writeOut();
+    if (logFile.isOpen()) logFile.close();
+}
+
+bool ContinuousLogger::openFile(const QString &filename)
+{
+    QIODevice::OpenMode mode = QIODevice::WriteOnly;
+    if (logFormat == CLF_GVRET_CSV) mode |= QIODevice::Text;
+
+    logFile.setFileName(filename);
+    if (!logFile.open(mode))
+    {
+        qDebug() << "Could not open continuous log " << filename;
+        emit logError(tr("Could not open %1 for logging").arg(filename));
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&pendingMutex);
+        activeFileName = filename;
+    }
+    bytesInFile = 0;
+    outUsed = 0;
+    fileAge.start();
+    writeHeader();
+    return true;
+}
+
+void ContinuousLogger::writeHeader()
+{
+    QByteArray header;
+
+    if (logFormat == CLF_GVRET_CSV)
+    {
+        header = "Time Stamp,ID,Extended,Dir,Bus,LEN,D1,D2,D3,D4,D5,D6,D7,D8\n";
+    }
+    else
+    {
+        header = SVCLOG_MAGIC;
+        header.append(static_cast<char>(SVCLOG_VERSION));
+        header.append(static_cast<char>((logFormat == CLF_COMPRESSED) ? SVCLOG_FILE_COMPRESSED : 0));
+    }
+
+    logFile.write(header);
+    bytesInFile += header.size();
+}
+
+QString ContinuousLogger::rotatedFileName(int index)
+{
+    QFileInfo info(baseFileName);
+    QString name = info.completeBaseName() + "_" + QString::number(index).rightJustified(3, '0');
+    if (!info.suffix().isEmpty()) name += "." + info.suffix();
+    return info.path() + "/" + name;
+}
+
+void ContinuousLogger::rotateIfNeeded()
+{
+    if (!logFile.isOpen()) return;
+
+    bool rotate = false;
+    if (rotateAtBytes > 0 && bytesInFile >= rotateAtBytes) rotate = true;
+    if (rotateAtSeconds > 0 && fileAge.elapsed() >= (rotateAtSeconds * 1000ll)) rotate = true;
+    if (!rotate) return;
+
+    logFile.close();
+    rotationIndex++;
+    if (!openFile(rotatedFileName(rotationIndex)))
+    {
+        QMutexLocker locker(&pendingMutex);
+        logging = false;
+    }
+}
+
+void ContinuousLogger::drainPending()
+{
+    {
+        QMutexLocker locker(&pendingMutex);
+        drainScheduled = false;
+        //the cleared vector handed back keeps its capacity so steady state logging doesn't allocate here
+        workingFrames.swap(pendingFrames);
+    }
+
+    if (logFile.isOpen())
+    {
+        for (int i = 0; i < workingFrames.count(); i++)
+        {
+            formatFrame(workingFrames.at(i));
+            if (outUsed >= LOG_WRITE_THRESHOLD)
+            {
+                //rotating right before a write means a new file never ends up with nothing but its header
+                rotateIfNeeded();
+                writeOut();
+            }
+        }
+    }
+    workingFrames.clear();
+}
+
+void ContinuousLogger::flushTimerTriggered()
+{
+    if (!logFile.isOpen()) return;
+
+    writeOut();
+    logFile.flush();
+    rotateIfNeeded(); //time based rotation has to happen even if nothing is coming in
+}
+
+void ContinuousLogger::formatFrame(const CANFrame &frame)
+{
+    char *start = outBuffer.data() + outUsed;
+    char *p = start;
+
+    if (logFormat == CLF_GVRET_CSV)
+    {
+        p = FrameExporter::formatNativeCSVLine(p, frame);
+    }
+    else
+    {
+        const QByteArray payload = frame.payload();
+        int dataLen = qMin(payload.count(), 64);
+        uint8_t flags = 0;
+        if (frame.hasExtendedFrameFormat()) flags |= SVCLOG_FLAG_EXTENDED;
+        if (frame.isReceived) flags |= SVCLOG_FLAG_RECEIVED;
+        if (frame.hasFlexibleDataRateFormat()) flags |= SVCLOG_FLAG_FD;
+        if (frame.hasBitrateSwitch()) flags |= SVCLOG_FLAG_BRS;
+        if (frame.frameType() == QCanBusFrame::RemoteRequestFrame) flags |= SVCLOG_FLAG_REMOTE;
+        if (frame.frameType() == QCanBusFrame::ErrorFrame) flags |= SVCLOG_FLAG_ERROR;
+
+        qToLittleEndian<quint64>(static_cast<quint64>(frame.timeStamp().microSeconds()), p);
+        p += 8;
+        qToLittleEndian<quint32>(frame.frameId(), p);
+        p += 4;
+        *p++ = static_cast<char>(frame.bus);
+        *p++ = static_cast<char>(flags);
+        *p++ = static_cast<char>(dataLen);
+        memcpy(p, payload.constData(), dataLen);
+        p += dataLen;
+    }
+
+    outUsed += static_cast<int>(p - start);
+}
+
+void ContinuousLogger::writeOut()
+{
+    if (!outUsed || !logFile.isOpen()) return;
+
+    if (logFormat == CLF_COMPRESSED)
+    {
+        QByteArray block = qCompress(reinterpret_cast<const uchar *>(outBuffer.constData()), outUsed);
+        char blockLen[4];
+        qToLittleEndian<quint32>(static_cast<quint32>(block.size()), blockLen);
+        logFile.write(blockLen, 4);
+        logFile.write(block);
+        bytesInFile += 4 + block.size();
+    }
+    else
+    {
+        logFile.write(outBuffer.constData(), outUsed);
+        bytesInFile += outUsed;
+    }
+    outUsed = 0;
+}
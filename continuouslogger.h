@@ -0,0 +1,145 @@
+#ifndef CONTINUOUSLOGGER_H
+#define CONTINUOUSLOGGER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include "can_structs.h"
+
+enum ContinuousLogFormat
+{
+    CLF_GVRET_CSV = 0,   //same format saveNativeCSVFile writes so the logs load just like any other GVRET log
+    CLF_BINARY = 1,      //SavvyCAN binary log, see below
+    CLF_COMPRESSED = 2   //SavvyCAN binary log with the records zlib compressed in blocks
+};
+
+/*
+ * SavvyCAN binary log layout. All multi byte values are little endian.
+ * File header (8 bytes): "SVCLOG", version (1), flags (bit 0 set = compressed)
+ * Uncompressed files are then just a run of records until the end of the file.
+ * Compressed files are a run of blocks. Each block is a 32 bit length followed by that many bytes of qCompress output
+ * which, once uncompressed, is a run of whole records.
+ * Record: 64 bit timestamp in microseconds, 32 bit ID, 8 bit bus, 8 bit flags (SVCLOG_FLAG_*), 8 bit payload length, payload
+*/
+#define SVCLOG_MAGIC            "SVCLOG"
+#define SVCLOG_VERSION          1
+#define SVCLOG_HEADER_SIZE      8
+#define SVCLOG_RECORD_HDR_SIZE  15
+#define SVCLOG_FILE_COMPRESSED  1
+
+#define SVCLOG_FLAG_EXTENDED    0x01
+#define SVCLOG_FLAG_RECEIVED    0x02
+#define SVCLOG_FLAG_FD          0x04
+#define SVCLOG_FLAG_BRS         0x08
+#define SVCLOG_FLAG_REMOTE      0x10
+#define SVCLOG_FLAG_ERROR       0x20
+
+/*
+ * Continuous logging used to format and write every frame from MainWindow as it came in, which put a QString allocation for
+ * every field of every frame and a pile of tiny QFile writes onto the GUI thread. This object lives in its own thread just like
+ * FramePlaybackObject. The receiving side only appends the new frames to a pending buffer. The worker swaps that buffer out
+ * for an empty one (double buffering so the receiving side never waits on the disk), formats the frames into one large
+ * output buffer and writes it in big chunks. Optionally the log is rotated to a new file once it reaches a given size or age.
+*/
+class ContinuousLogger : public QObject
+{
+    Q_OBJECT
+
+public:
+    ContinuousLogger();
+    ~ContinuousLogger();
+
+    /**
+     * @brief queue frames for logging. Safe to call from any thread and never touches the disk
+     * @param frames - the frames to append to the log. They're copied so the caller can do as it wishes afterward.
+     */
+    void queueFrames(const QVector<CANFrame> &frames);
+
+    /**
+     * @brief open a new log, closing any log which is currently open
+     * @param filename - the file to write. Rotated files get _001, _002, etc added to the base name.
+     * @param format - one of ContinuousLogFormat
+     * @param rotateBytes - start a new file once this many bytes have been written to the current one. 0 to disable.
+     * @param rotateSeconds - start a new file once the current one has been open this long. 0 to disable.
+     * @return true if the file could be opened
+     * @note blocks until the worker thread has opened the file
+     */
+    bool open(QString filename, int format, qint64 rotateBytes, int rotateSeconds);
+
+    /**
+     * @brief write out everything still pending and close the log
+     * @note blocks until the worker thread has closed the file
+     */
+    void close();
+
+    bool isLogging();
+    QString currentFileName();
+
+public slots:
+    /**
+     * @brief starts the worker thread (piStart is called in the working thread context)
+     */
+    void initialize();
+
+    /**
+     * @brief closes any open log and stops the worker thread
+     */
+    void finalize();
+
+signals:
+    void logError(QString message);
+
+private slots:
+    bool openLog(QString filename, int format, qint64 rotateBytes, int rotateSeconds);
+    void closeLog();
+    void drainPending();
+    void flushTimerTriggered();
+
+private:
+    //frames are appended to pendingFrames by the receiving thread and swapped into workingFrames by the worker
+    QMutex pendingMutex;
+    QVector<CANFrame> pendingFrames;
+    QVector<CANFrame> workingFrames;
+    bool drainScheduled;
+    bool logging;
+
+    QFile logFile;
+    QString baseFileName;
+    QString activeFileName;
+    int logFormat;
+    qint64 rotateAtBytes;
+    int rotateAtSeconds;
+    int rotationIndex;
+    qint64 bytesInFile;
+    QElapsedTimer fileAge;
+
+    QByteArray outBuffer;
+    int outUsed;
+
+    QTimer *flushTimer;
+    QThread *mThread_p;
+
+    bool openFile(const QString &filename);
+    void writeHeader();
+    void formatFrame(const CANFrame &frame);
+    void writeOut();
+    void rotateIfNeeded();
+    QString rotatedFileName(int index);
+
+    /**
+     * @brief starts the device
+     */
+    void piStart();
+
+    /**
+     * @brief stops the device
+     */
+    void piStop();
+};
+
+#endif // CONTINUOUSLOGGER_H
@@ -2,6 +2,9 @@
 #include "dbchandler.h"
 #include "utility.h"
 #include <QtMath>
+#include <QMap>
+#include <QSet>
+#include <algorithm>
 
 DBC_MESSAGE::DBC_MESSAGE()
 {
@@ -31,62 +34,22 @@ DBC_SIGNAL::DBC_SIGNAL()
     valType = DBC_SIG_VAL_TYPE::UNSIGNED_INT;
 }
 
-bool DBC_SIGNAL::isSignalInMessage(const CANFrame &frame)
+//Walks up the chain of multiplexors checking that each one selects the level below it. Each multiplexor is decoded once.
+//To find everything a frame carries use DBCSignalHandler::decodeFrame instead of calling this for every signal.
+bool DBC_SIGNAL::isSignalInMessage(const CANFrame &frame) const
 {
-    if (isMultiplexor && !isMultiplexed) return true; //the root multiplexor is always in the message.
-    if (isMultiplexed)
+    const DBC_SIGNAL *child = this;
+    int depth = 0;
+    while (child->isMultiplexed)
     {
-        if (parentMessage->multiplexorSignal != nullptr)
-        {
-            if (multiplexParent->isSignalInMessage(frame)) //parent is in message so check if value is correct
-            {
-                int val;
-                if (!multiplexParent->processAsInt(frame, val)) return false;
-                if ((val >= multiplexLowValue) && (val <= multiplexHighValue))
-                {
-                    return true;
-                }
-                else return false;
-            }
-            else return false;
-        }
-        else return false;
-    }
-    else return true; //if signal isn't multiplexed then it's definitely in the message
-}
-
-//Take all the children of this signal and see if they exist in the message. Can be called recursively to descend the dependency tree
-QString DBC_SIGNAL::processSignalTree(const CANFrame &frame)
-{
-    QString build;
-    int val;
-    if (!this->processAsInt(frame, val))
-    {
-        qDebug() << "Could not process multiplexor as an integer.";
-        return build;
-    }
-    qDebug() << val;
-
-    foreach (DBC_SIGNAL *sig, multiplexedChildren)
-    {
-        if ( (val >= sig->multiplexLowValue) && (val <= sig->multiplexHighValue) )
-        {
-            qDebug() << "Found match for multiplex value range - " << sig->name;
-            QString sigString;
-            if (sig->processAsText(frame, sigString))
-            {
-                qDebug() << "Returned value: " << sigString;
-                build.append(sigString);
-                build.append("\n");
-                if (sig->isMultiplexor)
-                {
-                    qDebug() << "Spelunkin!";
-                    build.append(sig->processSignalTree(frame));
-                }
-            }
-        }
+        //a multiplexed signal needs a multiplexor. More levels than there can be signals in a frame means a loop
+        if (!child->multiplexParent || !parentMessage || !parentMessage->multiplexorSignal || ++depth > 64) return false;
+        int val;
+        if (!child->multiplexParent->processAsInt(frame, val)) return false;
+        if ((val < child->multiplexLowValue) || (val > child->multiplexHighValue)) return false;
+        child = child->multiplexParent;
     }
-    return build;
+    return true; //reached a signal which isn't multiplexed (the root multiplexor or a plain signal) so it's in the message
 }
 
 /*
@@ -117,81 +80,109 @@ s 5   47 46 45 44 43 42 41 40
   going backward as before. Using the same example as for intel, start bit of 12 and a signal length of 8.
   So, the bits are 12, 11, 10, 9, 8, 23, 22, 21. Yes, that's confusing. They now go in reverse value order too.
   Bit 12 is worth 128, 11 is worth 64, etc until bit 21 is worth 1.
+
+  decode() is the one place the value of a signal gets worked out. It doesn't change the signal in any way so any
+  number of threads can decode the same signal at once as long as nobody is editing it at the same time.
+  The processAs* functions below are thin wrappers which hand back the part of the result their callers want.
 */
-bool DBC_SIGNAL::processAsText(const CANFrame &frame, QString &outString, bool outputName, bool outputUnit)
+DBC_SIGNAL_VALUE DBC_SIGNAL::decode(const CANFrame &frame) const
 {
-    int64_t result = 0;
-    bool isSigned = false;
-    bool isInteger = false;
-    double endResult;
-
-    //if (!isSignalInMessage(frame)) return false;
+    DBC_SIGNAL_VALUE value;
+    const QByteArray payload = frame.payload();
 
     if (valType == STRING)
     {
-        QString buildString;
         int startByte = startBit / 8;
-        int bytes = signalSize / 8;
-        for (int x = 0; x < bytes; x++) buildString.append(frame.payload().data()[startByte + x]);
-        outString = buildString;
-        cachedValue = outString;
-        return true;
+        int bytes = qMin(signalSize / 8, payload.length() - startByte);
+        for (int x = 0; x < bytes; x++) value.stringValue.append(payload.at(startByte + x));
+        value.valid = true;
+        return value;
     }
 
-    if (valType == SIGNED_INT) isSigned = true;
     if (valType == SIGNED_INT || valType == UNSIGNED_INT)
     {
-        result = Utility::processIntegerSignal(frame.payload(), startBit, signalSize, intelByteOrder, isSigned);
-        endResult = ((double)result * factor) + bias;
-        result = (int64_t)endResult;
+        const BitExtractor bits = layoutExtractor();
+        if (!bits.fits(payload.length())) return value;
+        value.doubleValue = ((double)bits.extract(payload) * factor) + bias;
+        value.intValue = (int64_t)value.doubleValue;
         // if factor is an integer, we don't need the possibly human-unreadable float representation
-        isInteger = (factor == qFloor(factor));
+        value.isInteger = (factor == qFloor(factor));
     }
     else if (valType == SP_FLOAT)
     {
         //The theory here is that we force the integer signal code to treat this as
-        //a 32 bit unsigned integer. This integer is then cast into a float in such a way
-        //that the bytes that make up the integer are instead treated as having made up
-        //a 32 bit single precision float. That's evil incarnate but it is very fast and small
-        //in terms of new code.
-        result = Utility::processIntegerSignal(frame.payload(), startBit, 32, intelByteOrder, false);
-        endResult = (*((float *)(&result)) * factor) + bias; //look away! This is awful. I don't even know for sure if it works. Should test that.
+        //a 32 bit unsigned integer. The bits of that integer are then reinterpreted as
+        //a 32 bit single precision float.
+        const BitExtractor bits(startBit, 32, intelByteOrder, false);
+        if (!bits.fits(payload.length())) return value;
+        uint32_t rawBits = static_cast<uint32_t>(bits.extract(payload));
+        float asFloat;
+        memcpy(&asFloat, &rawBits, 4);
+        value.intValue = rawBits; //value lists are matched against the raw bits
+        value.doubleValue = (asFloat * factor) + bias;
     }
     else //double precision float
     {
-        if ( frame.payload().length() < 8 )
-        {
-            result = 0;
-            return false;
-        }
-        //like the above, this is rotten and evil and wrong in so many ways. Force
-        //calculation of a 64 bit integer and then cast it into a double.
-        result = Utility::processIntegerSignal(frame.payload(), startBit, 64, intelByteOrder, false);
-        endResult = (*((double *)(&result)) * factor) + bias;
+        if ( payload.length() < 8 ) return value;
+        //like the above, force calculation of a 64 bit integer and then reinterpret it as a double.
+        int64_t rawBits = Utility::processIntegerSignal(payload, startBit, 64, intelByteOrder, false);
+        double asDouble;
+        memcpy(&asDouble, &rawBits, 8);
+        value.intValue = rawBits;
+        value.doubleValue = (asDouble * factor) + bias;
     }
 
-    outString = makePrettyOutput(endResult, result, outputName, isInteger, outputUnit);
-    cachedValue = endResult;
+    value.valid = true;
+    return value;
+}
+
+bool DBC_SIGNAL::processAsText(const CANFrame &frame, QString &outString, bool outputName, bool outputUnit) const
+{
+    DBC_SIGNAL_VALUE value = decode(frame);
+    if (!value.valid) return false;
+
+    if (valType == STRING) outString = value.stringValue;
+    else outString = makePrettyOutput(value, outputName, outputUnit);
     return true;
 }
 
-bool DBC_SIGNAL::getValueString(int64_t intVal, QString &outString)
+bool DBC_SIGNAL::getValueString(int64_t intVal, QString &outString) const
 {
-    if (valList.count() > 0) //if this is a value list type then look it up and display the proper string
+    const QString *found = findValueString(intVal);
+    if (!found) return false;
+    outString = *found;
+    return true;
+}
+
+//The description for a value out of the value table or nullptr if there isn't one. Uses the compiled value table
+//if it's up to date and searches valList directly otherwise. Never rebuilds anything so it's safe from any thread.
+const QString *DBC_SIGNAL::findValueString(int64_t intVal) const
+{
+    if (valList.count() == 0) return nullptr;
+    if (valueTable.isBuiltFrom(valList)) return valueTable.find(intVal);
+
+    for (int x = 0; x < valList.count(); x++)
     {
-        for (int x = 0; x < valList.count(); x++)
-        {
-            if (valList.at(x).value == intVal)
-            {
-                outString = valList.at(x).descript;
-                return true;
-            }
-        }
+        if (valList.at(x).value == intVal) return &valList.at(x).descript;
     }
-    return false;
+    return nullptr;
+}
+
+//Rebuild the compiled value table if this signal's value list was edited since it was built. Call from the thread
+//which owns the DBC data
+void DBC_SIGNAL::updateValueTable()
+{
+    if (!valueTable.isBuiltFrom(valList)) valueTable.build(valList);
+}
+
+//For signals which will never be edited again (see DBCSnapshot). The table is built now so lookups from other
+//threads never have to fall back to searching valList
+void DBC_SIGNAL::freezeValueTable()
+{
+    updateValueTable();
 }
 
-QString DBC_SIGNAL::makePrettyOutput(double floatVal, int64_t intVal, bool outputName, bool isInteger, bool outputUnit)
+QString DBC_SIGNAL::makePrettyOutput(double floatVal, int64_t intVal, bool outputName, bool isInteger, bool outputUnit) const
 {
     QString outputString;
 
@@ -199,17 +190,9 @@ QString DBC_SIGNAL::makePrettyOutput(double floatVal, int64_t intVal, bool outpu
 
     if (valList.count() > 0) //if this is a value list type then look it up and display the proper string
     {
-        bool foundVal = false;
-        for (int x = 0; x < valList.count(); x++)
-        {
-            if (valList.at(x).value == intVal)
-            {
-                outputString += valList.at(x).descript;
-                foundVal = true;
-                break;
-            }
-        }
-        if (!foundVal) outputString += QString::number(intVal);
+        const QString *found = findValueString(intVal);
+        if (found) outputString += *found;
+        else outputString += QString::number(intVal);
         if (outputUnit) outputString += unitName;
     }
     else //otherwise display the actual number and unit (if it exists)
@@ -220,37 +203,28 @@ QString DBC_SIGNAL::makePrettyOutput(double floatVal, int64_t intVal, bool outpu
     return outputString;
 }
 
+QString DBC_SIGNAL::makePrettyOutput(const DBC_SIGNAL_VALUE &value, bool outputName, bool outputUnit) const
+{
+    if (valType == STRING) return outputName ? (name + ": " + value.stringValue) : value.stringValue;
+    return makePrettyOutput(value.doubleValue, value.intValue, outputName, value.isInteger, outputUnit);
+}
+
 //Works quite a bit like the above version but this one is cut down and only will return int32_t which is perfect for
 //uses like calculating a multiplexor value or if you know you are going to get an integer returned
 //from a signal and you want to use it as-is and not have to convert back from a string. Use with caution though
 //as this basically assumes the signal is an integer.
 //The call syntax is different from the more generic processSignal. Instead of returning the value we return
 //true or false to show whether the function succeeded. The variable to fill out is passed by reference.
-bool DBC_SIGNAL::processAsInt(const CANFrame &frame, int32_t &outValue)
+bool DBC_SIGNAL::processAsInt(const CANFrame &frame, int32_t &outValue) const
 {
-    int32_t result = 0;
-    bool isSigned = false;
-
     if (valType == STRING || valType == SP_FLOAT  || valType == DP_FLOAT)
     {
         return false;
     }
 
-    //if (!isSignalInMessage(frame)) return false;
-
-    if (valType == SIGNED_INT) isSigned = true;
-    /*if ( static_cast<int>(frame.payload().length() * 8) <= (startBit + signalSize) )
-    {
-        result = 0;
-        return false;
-    }*/
-
-    result = static_cast<int32_t>(Utility::processIntegerSignal(frame.payload(), startBit, signalSize, intelByteOrder, isSigned));
-
-    double endResult = (result * factor) + bias;
-    result = static_cast<int32_t>(endResult);
-    cachedValue = result;
-    outValue = result;
+    DBC_SIGNAL_VALUE value = decode(frame);
+    if (!value.valid) return false;
+    outValue = static_cast<int32_t>(value.intValue);
     return true;
 }
 
@@ -258,62 +232,138 @@ bool DBC_SIGNAL::processAsInt(const CANFrame &frame, int32_t &outValue)
 //except STRING. Useful for when you know you'll need floating point data and don't want to incur a conversion
 //back and forth to double or float. Such a use is the graphing window.
 //Similar syntax to processSignalInt but with double instead.
-bool DBC_SIGNAL::processAsDouble(const CANFrame &frame, double &outValue)
+bool DBC_SIGNAL::processAsDouble(const CANFrame &frame, double &outValue) const
 {
-    int64_t result = 0;
-    bool isSigned = false;
-    double endResult;
-
     if (valType == STRING)
     {
         return false;
     }
 
-    //if (!isSignalInMessage(frame)) return false;
+    DBC_SIGNAL_VALUE value = decode(frame);
+    if (!value.valid) return false;
+    outValue = value.doubleValue;
+    return true;
+}
 
-    if (valType == SIGNED_INT) isSigned = true;
-    if (valType == SIGNED_INT || valType == UNSIGNED_INT)
+//Batch version of the above for decoding one signal out of a long run of frames, for instance all the frames with a
+//given ID in a log. outValid, if given, receives what the single frame version would have returned for each frame.
+//Values for frames which couldn't be decoded are meaningless. Returns how many frames could be decoded.
+int DBC_SIGNAL::processAsDouble(const CANFrame *frames, int count, double *outValues, bool *outValid) const
+{
+    int good = 0;
+    if (count <= 0) return 0;
+
+    if (valType != SIGNED_INT && valType != UNSIGNED_INT)
     {
-        if ( frame.payload().length() * 8 < (startBit+signalSize) )
+        for (int i = 0; i < count; i++)
         {
-            result = 0;
-            return false;
+            bool ok = processAsDouble(frames[i], outValues[i]);
+            if (outValid) outValid[i] = ok;
+            if (ok) good++;
         }
-        result = Utility::processIntegerSignal(frame.payload(), startBit, signalSize, intelByteOrder, isSigned);
-        endResult = ((double)result * factor) + bias;
-        result = (int64_t)endResult;
+        return good;
     }
-    /*TODO: It should be noted that the below floating point has not even been tested. For shame! Test it!*/
-    else if (valType == SP_FLOAT)
+
+    const BitExtractor bits = layoutExtractor();
+    QVector<int64_t> raw(count);
+
+    for (int i = 0; i < count; i++)
     {
-        if ( frame.payload().length() * 8 < (startBit + 32) )
-        {
-            result = 0;
-            return false;
-        }
-        //The theory here is that we force the integer signal code to treat this as
-        //a 32 bit unsigned integer. This integer is then cast into a float in such a way
-        //that the bytes that make up the integer are instead treated as having made up
-        //a 32 bit single precision float. That's evil incarnate but it is very fast and small
-        //in terms of new code.
-        result = Utility::processIntegerSignal(frame.payload(), startBit, 32, false, false);
-        endResult = (*((float *)(&result)) * factor) + bias;
+        const QByteArray payload = frames[i].payload();
+        bool ok = bits.fits(payload.length());
+        raw[i] = ok ? bits.extract(payload) : 0;
+        if (outValid) outValid[i] = ok;
+        if (ok) good++;
     }
-    else //double precision float
+    BitExtractor::scale(raw.constData(), count, factor, bias, outValues);
+    return good;
+}
+
+//The cached extraction plan if it still fits the signal, otherwise a fresh one. Never changes the cached plan
+//so it is safe to call from several threads at once. Call getExtractor() from the owning thread to refresh the cache.
+BitExtractor DBC_SIGNAL::layoutExtractor() const
+{
+    bool isSigned = (valType == SIGNED_INT);
+    if (extractor.matches(startBit, signalSize, intelByteOrder, isSigned)) return extractor;
+    return BitExtractor(startBit, signalSize, intelByteOrder, isSigned);
+}
+
+const BitExtractor &DBC_SIGNAL::getExtractor()
+{
+    bool isSigned = (valType == SIGNED_INT);
+    if (!extractor.matches(startBit, signalSize, intelByteOrder, isSigned))
     {
-        if ( frame.payload().length() < 8 )
+        extractor = BitExtractor(startBit, signalSize, intelByteOrder, isSigned);
+    }
+    return extractor;
+}
+
+//Value tables covering a range of values no bigger than this (and not too sparse) are stored as a flat array
+#define VALUE_TABLE_MAX_DENSE   4096
+
+//every description any value table has used. Only touched while building value tables
+static QSet<QString> internedDescriptions;
+
+void DBC_VALUE_TABLE::build(const QList<DBC_VAL_ENUM_ENTRY> &valList)
+{
+    source = valList;
+    denseBase = 0;
+    dense.clear();
+    sortedValues.clear();
+    sortedDescriptions.clear();
+    descriptions.clear();
+    if (valList.isEmpty()) return;
+
+    //the first entry for a value wins, same as searching the list from the front would
+    QMap<int64_t, int> byValue;
+    for (int i = 0; i < valList.count(); i++)
+    {
+        if (byValue.contains(valList[i].value)) continue;
+        byValue.insert(valList[i].value, descriptions.count());
+        descriptions.append(*internedDescriptions.insert(valList[i].descript));
+    }
+
+    int64_t lowest = byValue.firstKey();
+    int64_t span = byValue.lastKey() - lowest + 1;
+    if (span <= VALUE_TABLE_MAX_DENSE && span <= (byValue.count() * 4) + 16)
+    {
+        denseBase = lowest;
+        dense.fill(-1, static_cast<int>(span));
+        for (QMap<int64_t, int>::const_iterator it = byValue.constBegin(); it != byValue.constEnd(); ++it)
+            dense[static_cast<int>(it.key() - lowest)] = it.value();
+    }
+    else
+    {
+        sortedValues.reserve(byValue.count());
+        sortedDescriptions.reserve(byValue.count());
+        for (QMap<int64_t, int>::const_iterator it = byValue.constBegin(); it != byValue.constEnd(); ++it)
         {
-            result = 0;
-            return false;
+            sortedValues.append(it.key());
+            sortedDescriptions.append(it.value());
         }
-        //like the above, this is rotten and evil and wrong in so many ways. Force
-        //calculation of a 64 bit integer and then cast it into a double.
-        result = Utility::processIntegerSignal(frame.payload(), startBit, 64, false, false);
-        endResult = (*((double *)(&result)) * factor) + bias;
     }
-    cachedValue = endResult;
-    outValue = endResult;
-    return true;
+}
+
+//Only reads the list so it doesn't detach anything. An empty table and an empty list share the same null data
+//which is fine, there's nothing to look up either way
+bool DBC_VALUE_TABLE::isBuiltFrom(const QList<DBC_VAL_ENUM_ENTRY> &valList) const
+{
+    return source.isSharedWith(valList);
+}
+
+const QString *DBC_VALUE_TABLE::find(int64_t value) const
+{
+    if (!dense.isEmpty())
+    {
+        int64_t offset = value - denseBase;
+        if (offset < 0 || offset >= dense.count()) return nullptr;
+        int idx = dense.at(static_cast<int>(offset));
+        return (idx < 0) ? nullptr : &descriptions.at(idx);
+    }
+
+    QVector<int64_t>::const_iterator it = std::lower_bound(sortedValues.constBegin(), sortedValues.constEnd(), value);
+    if (it == sortedValues.constEnd() || *it != value) return nullptr;
+    return &descriptions.at(sortedDescriptions.at(static_cast<int>(it - sortedValues.constBegin())));
 }
 
 DBC_ATTRIBUTE_VALUE *DBC_SIGNAL::findAttrValByName(QString name)
@@ -5,7 +5,9 @@
 #include <QString>
 #include <QStringList>
 #include <QVariant>
+#include <QVector>
 #include "can_structs.h"
+#include "utils/bitextractor.h"
 
 /*classes to encapsulate data from a DBC file. Really, the stuff of interest
   are the nodes, messages, signals, attributes, and comments.
@@ -66,6 +68,32 @@ public:
     QString descript;
 };
 
+/*
+ * Lookup form of the value table of a signal. A value table which covers a small enough range of values goes into a
+ * flat array indexed by (value - lowest value). Anything else goes into an array sorted by value which gets binary searched.
+ * The descriptions are interned so every lookup of the same description, in any signal, hands out the same shared string.
+ * Built from valList by DBC_SIGNAL::updateValueTable(). The table keeps a copy of the list it was built from. Being
+ * implicitly shared that costs nothing, and any edit of the signal's list detaches it from the copy, so the table can
+ * tell whether it's still good for its own signal no matter what else in the DBC data was edited.
+*/
+class DBC_VALUE_TABLE
+{
+public:
+    DBC_VALUE_TABLE() : denseBase(0) {}
+
+    void build(const QList<DBC_VAL_ENUM_ENTRY> &valList);
+    bool isBuiltFrom(const QList<DBC_VAL_ENUM_ENTRY> &valList) const;
+    const QString *find(int64_t value) const;
+
+private:
+    QList<DBC_VAL_ENUM_ENTRY> source;       //shares its data with the list the table was built from until that is edited
+    int64_t denseBase;
+    QVector<int> dense;                     //index into descriptions for value (denseBase + i), -1 if there's no entry
+    QVector<int64_t> sortedValues;          //used instead of dense when the values are too spread out
+    QVector<int> sortedDescriptions;
+    QVector<QString> descriptions;
+};
+
 class DBC_NODE
 {
 public:
@@ -86,6 +114,19 @@ public:
 class DBC_MESSAGE; //forward reference so that DBC_SIGNAL can compile before we get to real definition of DBC_MESSAGE
 class DBC_SIGNAL;
 
+//The result of decoding one signal out of one frame. Plain data so it can be copied around and stored by whoever wants to remember it
+class DBC_SIGNAL_VALUE
+{
+public:
+    DBC_SIGNAL_VALUE() : valid(false), isInteger(false), intValue(0), doubleValue(0.0) {}
+
+    bool valid;             //false if the frame couldn't hold the signal
+    bool isInteger;         //the scaled value is a whole number so intValue is the one to display
+    int64_t intValue;       //scaled value truncated to an integer. For float signals the raw bits, that's what value lists match
+    double doubleValue;     //scaled value
+    QString stringValue;    //only filled in for STRING signals
+};
+
 class DBC_SIGNAL
 {
 public: //TODO: this is sloppy. It shouldn't all be public!
@@ -106,23 +147,31 @@ public: //TODO: this is sloppy. It shouldn't all be public!
     DBC_MESSAGE *parentMessage;
     QString unitName;
     QString comment;
-    QVariant cachedValue;
     QList<DBC_ATTRIBUTE_VALUE> attributes;
     QList<DBC_VAL_ENUM_ENTRY> valList;
     QList<DBC_SIGNAL *> multiplexedChildren;
     DBC_SIGNAL *multiplexParent;
     DBC_SIGNAL *self;
+    BitExtractor extractor; //don't use directly, layoutExtractor()/getExtractor() notice if the layout of the signal was edited
+    DBC_VALUE_TABLE valueTable; //don't use directly either, out of date value tables are ignored until updateValueTable() is called
 
     DBC_SIGNAL();
-    bool processAsText(const CANFrame &frame, QString &outString, bool outputName = true, bool outputUnit = true);
-    bool processAsInt(const CANFrame &frame, int32_t &outValue);
-    bool processAsDouble(const CANFrame &frame, double &outValue);
-    bool getValueString(int64_t intVal, QString &outString);
-    QString makePrettyOutput(double floatVal, int64_t intVal, bool outputName = true, bool isInteger = false, bool outputUnit = true);
-    QString processSignalTree(const CANFrame &frame);
+    DBC_SIGNAL_VALUE decode(const CANFrame &frame) const;
+    bool processAsText(const CANFrame &frame, QString &outString, bool outputName = true, bool outputUnit = true) const;
+    bool processAsInt(const CANFrame &frame, int32_t &outValue) const;
+    bool processAsDouble(const CANFrame &frame, double &outValue) const;
+    int processAsDouble(const CANFrame *frames, int count, double *outValues, bool *outValid = nullptr) const;
+    BitExtractor layoutExtractor() const;
+    const BitExtractor &getExtractor();
+    bool getValueString(int64_t intVal, QString &outString) const;
+    const QString *findValueString(int64_t intVal) const;
+    void updateValueTable();
+    void freezeValueTable();
+    QString makePrettyOutput(double floatVal, int64_t intVal, bool outputName = true, bool isInteger = false, bool outputUnit = true) const;
+    QString makePrettyOutput(const DBC_SIGNAL_VALUE &value, bool outputName = true, bool outputUnit = true) const;
     DBC_ATTRIBUTE_VALUE *findAttrValByName(QString name);
     DBC_ATTRIBUTE_VALUE *findAttrValByIdx(int idx);
-    bool isSignalInMessage(const CANFrame &frame);
+    bool isSignalInMessage(const CANFrame &frame) const;
 
     friend bool operator<(const DBC_SIGNAL& l, const DBC_SIGNAL& r)
     {
@@ -130,6 +179,14 @@ public: //TODO: this is sloppy. It shouldn't all be public!
     }
 };
 
+//One signal found in a frame and its value, as handed back by DBCSignalHandler::decodeFrame
+class DBC_DECODED_SIGNAL
+{
+public:
+    DBC_SIGNAL *signal;
+    DBC_SIGNAL_VALUE value;
+};
+
 class DBCSignalHandler; //forward declaration to keep from having to include dbchandler.h in this file and thus create a loop
 
 class DBC_MESSAGE
@@ -11,11 +11,188 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <string.h>
 #include "utility.h"
 #include "connections/canconmanager.h"
+#include "dbcsnapshot.h"
 
 DBCHandler* DBCHandler::instance = nullptr;
 
+//bumped whenever anything happens which could change the result of a message lookup
+static int lookupGeneration = 0;
+
+//bumped whenever a signal definition could have changed. Signal handlers compare it against the generation their mux table was built for
+static int signalEditGeneration = 1;
+
+//Upper bound on the number of (bus, id) pairs remembered by DBCHandler::findMessage before it starts over
+#define FRAME_LOOKUP_MAX    65536
+
+/*
+ * Cursor over one line of a DBC file which has already been through simplified(). Used by the parsers for the lines
+ * which make up the bulk of a large file (messages, signals and value tables) instead of regular expressions.
+ * All the accept/read functions skip any spaces in front of what they look for.
+*/
+class DBCLineTokenizer
+{
+public:
+    explicit DBCLineTokenizer(const QString &line) : str(line), pos(0) {}
+
+    bool atEnd() const
+    {
+        return pos >= str.length();
+    }
+
+    void skipSpaces()
+    {
+        while (pos < str.length() && str.at(pos) == QLatin1Char(' ')) pos++;
+    }
+
+    //consume c if it is next, otherwise leave everything alone and return false
+    bool accept(char c)
+    {
+        skipSpaces();
+        if (pos < str.length() && str.at(pos) == QLatin1Char(c))
+        {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool accept(const char *literal)
+    {
+        skipSpaces();
+        int len = static_cast<int>(strlen(literal));
+        if (pos + len > str.length()) return false;
+        for (int i = 0; i < len; i++)
+        {
+            if (str.at(pos + i) != QLatin1Char(literal[i])) return false;
+        }
+        pos += len;
+        return true;
+    }
+
+    QChar take()
+    {
+        if (pos >= str.length()) return QChar();
+        return str.at(pos++);
+    }
+
+    //names and IDs, the [-\w]+ of the old regular expressions
+    QString word()
+    {
+        skipSpaces();
+        int start = pos;
+        while (pos < str.length())
+        {
+            QChar c = str.at(pos);
+            if (!c.isLetterOrNumber() && c != QLatin1Char('_') && c != QLatin1Char('-')) break;
+            pos++;
+        }
+        return str.mid(start, pos - start);
+    }
+
+    QString digits()
+    {
+        skipSpaces();
+        int start = pos;
+        while (pos < str.length() && str.at(pos).isDigit()) pos++;
+        return str.mid(start, pos - start);
+    }
+
+    //anything that could be part of a floating point number
+    QString number()
+    {
+        skipSpaces();
+        int start = pos;
+        while (pos < str.length())
+        {
+            QChar c = str.at(pos);
+            if (!c.isDigit() && c != QLatin1Char('.') && c != QLatin1Char('+') && c != QLatin1Char('-')
+                && c != QLatin1Char('e') && c != QLatin1Char('E')) break;
+            pos++;
+        }
+        return str.mid(start, pos - start);
+    }
+
+    //text between double quotes. With toLastQuote the text runs to the last quote on the line rather than the next one
+    bool quoted(QString &out, bool toLastQuote = false)
+    {
+        if (!accept('"')) return false;
+        int end = toLastQuote ? str.lastIndexOf(QLatin1Char('"')) : str.indexOf(QLatin1Char('"'), pos);
+        if (end < pos) return false;
+        out = str.mid(pos, end - pos);
+        pos = end + 1;
+        return true;
+    }
+
+    QString rest()
+    {
+        skipSpaces();
+        QString out = str.mid(pos);
+        pos = str.length();
+        return out;
+    }
+
+private:
+    const QString &str;
+    int pos;
+};
+
+DBCSignalHandler::DBCSignalHandler()
+{
+    muxTableGeneration = 0;
+    frozen = false;
+}
+
+//Output is handed to the file in blocks of this size
+#define DBC_WRITE_BLOCK     65536
+
+/*
+ * Buffered output for DBCFile::saveFile. Text piles up in one preallocated block which is written to the file
+ * whenever it fills so a save never holds more than a block of pending output. flush() says whether every write worked.
+*/
+class DBCFileWriter
+{
+public:
+    explicit DBCFileWriter(QFile *file) : file(file), ok(true)
+    {
+        buffer.reserve(DBC_WRITE_BLOCK);
+    }
+
+    void write(const char *text)
+    {
+        buffer.append(text);
+        if (buffer.size() >= DBC_WRITE_BLOCK) flush();
+    }
+
+    void write(const QByteArray &text)
+    {
+        buffer.append(text);
+        if (buffer.size() >= DBC_WRITE_BLOCK) flush();
+    }
+
+    void write(const QString &text)
+    {
+        write(text.toUtf8());
+    }
+
+    bool flush()
+    {
+        if (!buffer.isEmpty())
+        {
+            if (file->write(buffer) != buffer.size()) ok = false;
+            buffer.resize(0); //keeps the reserved space
+        }
+        return ok;
+    }
+
+private:
+    QFile *file;
+    QByteArray buffer;
+    bool ok;
+};
+
 DBC_SIGNAL* DBCSignalHandler::findSignalByIdx(int idx)
 {
     if (sigs.count() == 0) return nullptr;
@@ -41,6 +218,8 @@ DBC_SIGNAL* DBCSignalHandler::findSignalByName(QString name)
 bool DBCSignalHandler::addSignal(DBC_SIGNAL &sig)
 {
     sigs.append(sig);
+    sigs.last().getExtractor(); //build the extraction plan now so decoding threads find it ready
+    invalidateTables();
     return true;
 }
 
@@ -52,6 +231,7 @@ bool DBCSignalHandler::removeSignal(DBC_SIGNAL *sig)
         if (sigs[i].name == sig->name)
         {
             sigs.removeAt(i);
+            invalidateTables();
             qDebug() << "Removed signal at idx " << i;
         }
     }
@@ -64,6 +244,7 @@ bool DBCSignalHandler::removeSignal(int idx)
     if (idx < 0) return false;
     if (idx >= sigs.count()) return false;
     sigs.removeAt(idx);
+    invalidateTables();
     return true;
 }
 
@@ -76,6 +257,7 @@ bool DBCSignalHandler::removeSignal(QString name)
         if (sigs[i].name.compare(name, Qt::CaseInsensitive) == 0)
         {
             sigs.removeAt(i);
+            invalidateTables();
             foundSome = true;
         }
     }
@@ -85,6 +267,7 @@ bool DBCSignalHandler::removeSignal(QString name)
 void DBCSignalHandler::removeAllSignals()
 {
     sigs.clear();
+    invalidateTables();
 }
 
 int DBCSignalHandler::getCount()
@@ -95,51 +278,165 @@ int DBCSignalHandler::getCount()
 void DBCSignalHandler::sort()
 {
     std::sort(sigs.begin(), sigs.end());
+    invalidateTables();
+}
+
+void DBCSignalHandler::invalidateTables()
+{
+    signalEditGeneration++;
 }
 
+int DBCSignalHandler::editGeneration()
+{
+    return signalEditGeneration;
+}
+
+void DBCSignalHandler::decodeFrame(const CANFrame &frame, QVector<DBC_DECODED_SIGNAL> &outSignals)
+{
+    outSignals.clear();
+    if (!frozen && muxTableGeneration != signalEditGeneration) buildMuxTable();
+    for (int i = 0; i < muxRoots.count(); i++) decodeMuxEntry(muxRoots.at(i), frame, outSignals);
+}
+
+//Promise that the signals in here will never change again. Everything decodeFrame and the value lookups need is built
+//now and never rebuilt so from here on decoding only reads and can happen on any number of threads at once.
+void DBCSignalHandler::freeze()
+{
+    buildMuxTable();
+    for (int i = 0; i < sigs.count(); i++) sigs[i].freezeValueTable();
+    frozen = true;
+}
+
+void DBCSignalHandler::buildMuxTable()
+{
+    QSet<DBC_SIGNAL *> visited;
+    muxEntries.clear();
+    muxRoots.clear();
+    for (int i = 0; i < sigs.count(); i++)
+    {
+        sigs[i].updateValueTable(); //only does anything for signals whose value list was edited
+        if (sigs[i].multiplexParent == nullptr) muxRoots.append(addMuxEntry(&sigs[i], visited));
+    }
+    muxTableGeneration = signalEditGeneration;
+}
+
+//Adds an entry for sig and, depth first, for everything it selects. Entries for the children of a multiplexor
+//are created in the order the children are listed so sorting entry numbers keeps that order.
+int DBCSignalHandler::addMuxEntry(DBC_SIGNAL *sig, QSet<DBC_SIGNAL *> &visited)
+{
+    int idx = muxEntries.count();
+    MuxTableEntry entry;
+    entry.signal = sig;
+    muxEntries.append(entry);
+    visited.insert(sig);
+
+    if (!sig->isMultiplexor) return idx;
+    for (int c = 0; c < sig->multiplexedChildren.count(); c++)
+    {
+        DBC_SIGNAL *child = sig->multiplexedChildren[c];
+        if (!child || visited.contains(child)) continue; //a signal only gets one entry, anything else is a loop
+        int childIdx = addMuxEntry(child, visited);
+        if (child->multiplexLowValue == child->multiplexHighValue)
+            muxEntries[idx].exactChildren[child->multiplexLowValue].append(childIdx);
+        else muxEntries[idx].rangedChildren.append(childIdx);
+    }
+    return idx;
+}
+
+void DBCSignalHandler::decodeMuxEntry(int idx, const CANFrame &frame, QVector<DBC_DECODED_SIGNAL> &outSignals)
+{
+    const MuxTableEntry &entry = muxEntries.at(idx);
+    DBC_DECODED_SIGNAL decoded;
+    decoded.signal = entry.signal;
+    decoded.value = entry.signal->decode(frame);
+    if (!decoded.value.valid) return;
+    outSignals.append(decoded);
+
+    if (!entry.signal->isMultiplexor) return;
+    if (entry.signal->valType != SIGNED_INT && entry.signal->valType != UNSIGNED_INT) return; //can't select anything
+    int32_t muxVal = static_cast<int32_t>(decoded.value.intValue); //same value processAsInt would give
+
+    QVector<int> selected = entry.exactChildren.value(muxVal);
+    for (int r = 0; r < entry.rangedChildren.count(); r++)
+    {
+        const DBC_SIGNAL *child = muxEntries.at(entry.rangedChildren[r]).signal;
+        if ((muxVal >= child->multiplexLowValue) && (muxVal <= child->multiplexHighValue)) selected.append(entry.rangedChildren[r]);
+    }
+    if (selected.count() > 1 && !entry.rangedChildren.isEmpty()) std::sort(selected.begin(), selected.end());
+
+    for (int c = 0; c < selected.count(); c++) decodeMuxEntry(selected.at(c), frame, outSignals);
+}
+
+DBCMessageHandler::DBCMessageHandler()
+{
+    matchingCriteria = EXACT;
+    filterLabelingEnabled = false;
+    indexValid = false;
+}
+
+/*
+ * Exact ID matches always win. Otherwise, in J1939 or GMLAN mode, the masked ID is looked up and the last message
+ * in the list which matches it is returned.
+*/
 DBC_MESSAGE* DBCMessageHandler::findMsgByID(uint32_t id)
 {
     if (messages.count() == 0) return nullptr;
-    DBC_MESSAGE *bestMatch = nullptr;
+    if (!indexValid) buildIndex();
 
-    for (int i = 0; i < messages.count(); i++)
-    {
-        if ( messages[i].ID == id )
-        {
-            return &messages[i];
-        }
+    int idx = exactIndex.value(id, -1);
+    if (idx > -1) return &messages[idx];
 
-        if (matchingCriteria == J1939)
-        {
-            // include data page and extended data page in the pgn
-            uint32_t pgn = (id & 0x3FFFF00) >> 8;
-            if ( (pgn & 0xFF00) <= 0xEF00 )
-            {
-                // PDU1 format
-                pgn &= 0x3FF00;
-                if ((messages[i].ID & 0x3FF0000) == (pgn << 8))
-                {
-                    bestMatch = &messages[i];
-                }
-            }
-            else
-            {
-                // PDU2 format
-                if ((messages[i].ID & 0x3FFFF00) == (pgn << 8))
-                {
-                    bestMatch = &messages[i];
-                }
-            }
-        }
-        else if (matchingCriteria == GMLAN)
-        {
-            // Match the bits 14-26 (Arbitration Id) of GMLAN 29bit header
-            uint32_t arbId = id &0x3FFE000;
-            if ( (arbId != 0) && (messages[i].ID & 0x3FFE000) == arbId )
-                bestMatch = &messages[i];
-        }
+    if (matchingCriteria == J1939)
+    {
+        // include data page and extended data page in the pgn
+        if (((id >> 16) & 0xFF) <= 0xEF) idx = pdu1Index.value(id & 0x3FF0000, -1); //PDU1 format, PS is a destination address
+        else idx = pdu2Index.value(id & 0x3FFFF00, -1); //PDU2 format
+    }
+    else if (matchingCriteria == GMLAN)
+    {
+        // Match the bits 14-26 (Arbitration Id) of GMLAN 29bit header
+        uint32_t arbId = id & 0x3FFE000;
+        if (arbId != 0) idx = gmlanIndex.value(arbId, -1);
     }
-    return bestMatch;
+
+    if (idx > -1) return &messages[idx];
+    return nullptr;
+}
+
+void DBCMessageHandler::indexMessage(int idx)
+{
+    uint32_t id = messages.at(idx).ID;
+
+    //the first message with a given ID is the exact match but the last one sharing a masked ID is the best match
+    if (!exactIndex.contains(id)) exactIndex.insert(id, idx);
+    pdu1Index.insert(id & 0x3FF0000, idx);
+    pdu2Index.insert(id & 0x3FFFF00, idx);
+    gmlanIndex.insert(id & 0x3FFE000, idx);
+}
+
+void DBCMessageHandler::buildIndex()
+{
+    exactIndex.clear();
+    pdu1Index.clear();
+    pdu2Index.clear();
+    gmlanIndex.clear();
+    exactIndex.reserve(messages.count());
+    pdu2Index.reserve(messages.count());
+
+    for (int i = 0; i < messages.count(); i++) indexMessage(i);
+    indexValid = true;
+}
+
+//Build the lookup tables now for a handler whose messages will never change again so findMsgByID only reads from here on
+void DBCMessageHandler::freeze()
+{
+    if (!indexValid) buildIndex();
+}
+
+void DBCMessageHandler::invalidateIndex()
+{
+    indexValid = false;
+    DBCHandler::invalidateLookup();
 }
 
 DBC_MESSAGE* DBCMessageHandler::findMsgByIdx(int idx)
@@ -198,6 +495,9 @@ QList<DBC_MESSAGE*> DBCMessageHandler::findMsgsByNode(DBC_NODE* node)
 bool DBCMessageHandler::addMessage(DBC_MESSAGE &msg)
 {
     messages.append(msg);
+    //appending doesn't move anything so the tables can simply be extended instead of rebuilt
+    if (indexValid) indexMessage(messages.count() - 1);
+    DBCHandler::invalidateLookup();
     return true;
 }
 
@@ -210,6 +510,7 @@ bool DBCMessageHandler::removeMessage(DBC_MESSAGE *msg)
         {
             messages.removeAt(i);
             qDebug() << "Removed message at idx " << i;
+            invalidateIndex();
             break;
         }
     }
@@ -222,6 +523,7 @@ bool DBCMessageHandler::removeMessageByIndex(int idx)
     if (idx < 0) return false;
     if (idx >= messages.count()) return false;
     messages.removeAt(idx);
+    invalidateIndex();
     return true;
 }
 
@@ -237,6 +539,7 @@ bool DBCMessageHandler::removeMessage(uint32_t ID)
             foundSome = true;
         }
     }
+    if (foundSome) invalidateIndex();
     return foundSome;
 }
 
@@ -252,12 +555,14 @@ bool DBCMessageHandler::removeMessage(QString name)
             foundSome = true;
         }
     }
+    if (foundSome) invalidateIndex();
     return foundSome;
 }
 
 void DBCMessageHandler::removeAllMessages()
 {
     messages.clear();
+    invalidateIndex();
 }
 
 int DBCMessageHandler::getCount()
@@ -272,6 +577,7 @@ void DBCMessageHandler::sort()
     {
         messages[i].sigHandler->sort();
     }
+    invalidateIndex();
 }
 
 bool DBCMessageHandler::filterLabeling()
@@ -291,6 +597,8 @@ MatchingCriteria_t DBCMessageHandler::getMatchingCriteria()
 
 void DBCMessageHandler::setMatchingCriteria(MatchingCriteria_t _matchingCriteria)
 {
+    //the tables hold every masked form already so only the cached frame lookups go stale
+    if (matchingCriteria != _matchingCriteria) DBCHandler::invalidateLookup();
     matchingCriteria = _matchingCriteria;
 }
 
@@ -300,6 +608,7 @@ DBCFile::DBCFile()
     messageHandler->setMatchingCriteria(EXACT);
     messageHandler->setFilterLabeling(false);
     isDirty = false;
+    loadNodesIndexed = 0;
     fileName = "<Unsaved File>";
 }
 
@@ -319,6 +628,7 @@ DBCFile::DBCFile(const DBCFile& cpy) : QObject()
     dbc_attributes.clear();
     dbc_attributes.append(cpy.dbc_attributes);
     isDirty = cpy.isDirty;
+    loadNodesIndexed = 0;
 }
 
 DBCFile& DBCFile::operator=(const DBCFile& cpy)
@@ -333,6 +643,7 @@ DBCFile& DBCFile::operator=(const DBCFile& cpy)
         dbc_nodes.append(cpy.dbc_nodes);
         dbc_attributes.clear();
         dbc_attributes.append(cpy.dbc_attributes);
+        savedMessages.clear();
     }
     return *this;
 }
@@ -341,6 +652,7 @@ void DBCFile::sort()
 {
     std::sort(dbc_nodes.begin(), dbc_nodes.end()); //sort node names
     messageHandler->sort(); //sort messages, each of which sorts its signals too
+    savedMessages.clear(); //messages moved around in memory
 }
 
 DBC_NODE* DBCFile::findNodeByIdx(int idx)
@@ -414,6 +726,7 @@ void DBCFile::setAssocBus(int bus)
     //int numBuses = CANConManager::getInstance()->getNumBuses();
     //if (bus >= numBuses) return;
     assocBuses = bus;
+    DBCHandler::invalidateLookup();
 }
 
 DBC_ATTRIBUTE *DBCFile::findAttributeByName(QString name, DBC_ATTRIBUTE_TYPE type)
@@ -449,6 +762,17 @@ void DBCFile::findAttributesByType(DBC_ATTRIBUTE_TYPE typ, QList<DBC_ATTRIBUTE>
 void DBCFile::setDirtyFlag()
 {
     isDirty = true;
+    savedMessages.clear(); //no telling what changed so the next save has to build everything again
+    DBCSignalHandler::invalidateTables(); //whatever was edited might have been a signal
+}
+
+//Use this one when the only thing changed was msg or its signals so the next save can reuse what it wrote for everything else
+void DBCFile::setDirtyFlag(const DBC_MESSAGE *msg)
+{
+    isDirty = true;
+    if (msg) savedMessages.remove(msg);
+    else savedMessages.clear();
+    DBCSignalHandler::invalidateTables();
 }
 
 //BE CAREFUL HERE. Do not clear the dirty flag unless you're absolutely sure nothing has changed.
@@ -466,184 +790,171 @@ bool DBCFile::getDirtyFlag()
     return isDirty;
 }
 
-DBC_MESSAGE* DBCFile::parseMessageLine(QString line)
+//Same as findNodeByName but constant time. Only valid while a file is being loaded
+DBC_NODE* DBCFile::findNodeForLoad(const QString &name)
 {
-    QRegularExpression regex;
-    QRegularExpressionMatch match;
-
-    DBC_MESSAGE *msgPtr;
-
-    qDebug() << "Found a BO line";
-    regex.setPattern("^BO\\_ (\\w+) ([-\\w]+) *: (\\w+) ([-\\w]+)");
-    match = regex.match(line);
-    //captured 1 = the ID in decimal
-    //captured 2 = The message name
-    //captured 3 = the message length
-    //captured 4 = the NODE responsible for this message
-    if (match.hasMatch())
+    //nodes are only ever appended while loading so just index whatever has been added since the last call
+    while (loadNodesIndexed < dbc_nodes.count())
     {
-        DBC_MESSAGE msg;
-        uint32_t ID = match.captured(1).toULong(); //the ID is always stored in decimal format
-        msg.ID = ID & 0x1FFFFFFFul;
-        msg.extendedID = (ID & 0x80000000ul) ? true : false;
-        msg.name = match.captured(2);
-        msg.len = match.captured(3).toUInt();
-        msg.sender = findNodeByName(match.captured(4));
-        if (!msg.sender) msg.sender = findNodeByIdx(0);
-        messageHandler->addMessage(msg);
-        msgPtr = messageHandler->findMsgByID(msg.ID);
+        QString key = dbc_nodes[loadNodesIndexed].name.toLower();
+        if (!loadNodeIndex.contains(key)) loadNodeIndex.insert(key, loadNodesIndexed);
+        loadNodesIndexed++;
     }
-    else msgPtr = nullptr;
-    return msgPtr;
+    int idx = loadNodeIndex.value(name.toLower(), -1);
+    if (idx < 0) return nullptr;
+    return &dbc_nodes[idx];
 }
 
-DBC_SIGNAL* DBCFile::parseSignalLine(QString line, DBC_MESSAGE *msg)
+//Same as msg->sigHandler->findSignalByName but constant time. Only valid while a file is being loaded
+DBC_SIGNAL* DBCFile::findSignalForLoad(DBC_MESSAGE *msg, const QString &name)
 {
-    QRegularExpression regex;
-    QRegularExpressionMatch match;
+    return loadSignalIndex.value(QPair<DBC_MESSAGE *, QString>(msg, name.toLower()), nullptr);
+}
 
-    int offset = 0;
+DBC_MESSAGE* DBCFile::parseMessageLine(QString line)
+{
+    DBCLineTokenizer tok(line);
+
+    //BO_ ID name: length sender
+    //the ID is always stored in decimal format
+    if (!tok.accept("BO_")) return nullptr;
+    QString idString = tok.word();
+    QString name = tok.word();
+    if (idString.isEmpty() || name.isEmpty() || !tok.accept(':')) return nullptr;
+    QString length = tok.word();
+    if (length.isEmpty()) return nullptr;
+
+    DBC_MESSAGE msg;
+    uint32_t ID = idString.toULong();
+    msg.ID = ID & 0x1FFFFFFFul;
+    msg.extendedID = (ID & 0x80000000ul) ? true : false;
+    msg.name = name;
+    msg.len = length.toUInt();
+    msg.sender = findNodeForLoad(tok.word());
+    if (!msg.sender) msg.sender = findNodeByIdx(0);
+    messageHandler->addMessage(msg);
+    return messageHandler->findMsgByID(msg.ID);
+}
+
+DBC_SIGNAL* DBCFile::parseSignalLine(QString line, DBC_MESSAGE *msg)
+{
+    DBCLineTokenizer tok(line);
     bool isMessageMultiplexor = false;
-    //bool isMultiplexed = false;
     DBC_SIGNAL sig;
+    bool ok1, ok2, ok3;
 
     sig.multiplexLowValue = 0;
     sig.multiplexHighValue = 0;
     sig.isMultiplexed = false;
     sig.isMultiplexor = false;
 
-    qDebug() << "Found a SG line";
-    regex.setPattern("^SG\\_ *([-\\w]+) +M *: *(\\d+)\\|(\\d+)@(\\d+)([\\+|\\-]) \\(([0-9.+\\-eE]+),([0-9.+\\-eE]+)\\) \\[([0-9.+\\-eE]+)\\|([0-9.+\\-eE]+)\\] \\\"(.*)\\\" (.*)");
+    //SG_ name [M|mX|mXM] : startBit|length@order(+/-) (factor,offset) [min|max] "unit" receivers
+    if (!tok.accept("SG_")) return nullptr;
+    sig.name = tok.word();
+    if (sig.name.isEmpty()) return nullptr;
 
-    match = regex.match(line);
-    if (match.hasMatch())
+    if (tok.accept('M'))
     {
-        qDebug() << "Multiplexor signal";
         isMessageMultiplexor = true;
         sig.isMultiplexor = true;
     }
-    else
+    else if (tok.accept('m'))
     {
-        regex.setPattern("^SG\\_ *([-\\w]+) +m(\\d+) *: *(\\d+)\\|(\\d+)@(\\d+)([\\+|\\-]) \\(([0-9.+\\-eE]+),([0-9.+\\-eE]+)\\) \\[([0-9.+\\-eE]+)\\|([0-9.+\\-eE]+)\\] \\\"(.*)\\\" (.*)");
-        match = regex.match(line);
-        if (match.hasMatch())
-        {
-            qDebug() << "Multiplexed signal";
-            //isMultiplexed = true;
-            sig.isMultiplexed = true;
-            sig.multiplexLowValue = match.captured(2).toInt();
-            sig.multiplexHighValue = sig.multiplexLowValue;
-            offset = 1;
-        }
-        else
-        {
-            regex.setPattern("^SG\\_ *([-\\w]+) +m(\\d+)M *: *(\\d+)\\|(\\d+)@(\\d+)([\\+|\\-]) \\(([0-9.+\\-eE]+),([0-9.+\\-eE]+)\\) \\[([0-9.+\\-eE]+)\\|([0-9.+\\-eE]+)\\] \\\"(.*)\\\" (.*)");
-            match = regex.match(line);
-            if (match.hasMatch())
-            {
-                qDebug() << "Extended Multiplexor Signal";
-                sig.isMultiplexor = true; //we don't set the local isMessageMultiplexor variable because this isn't the top level multiplexor
-                sig.isMultiplexed = true; //but, it is both a multiplexor and multiplexed
-                sig.multiplexLowValue = match.captured(2).toInt();
-                sig.multiplexHighValue = sig.multiplexLowValue;
-                offset = 1;
-            }
-            else
-            {
-                qDebug() << "standard signal";
-                regex.setPattern("^SG\\_ *([-\\w]+) *: *(\\d+)\\|(\\d+)@(\\d+)([\\+|\\-]) \\(([0-9.+\\-eE]+),([0-9.+\\-eE]+)\\) \\[([0-9.+\\-eE]+)\\|([0-9.+\\-eE]+)\\] \\\"(.*)\\\" (.*)");
-                match = regex.match(line);
-                sig.isMultiplexed = false;
-                sig.isMultiplexor = false;
-            }
-        }
+        sig.isMultiplexed = true;
+        sig.multiplexLowValue = tok.digits().toInt(&ok1);
+        sig.multiplexHighValue = sig.multiplexLowValue;
+        if (!ok1) return nullptr;
+        //extended multiplexing. Both a multiplexor and multiplexed but not the top level multiplexor of the message
+        if (tok.accept('M')) sig.isMultiplexor = true;
     }
+    if (!tok.accept(':')) return nullptr;
 
-    //captured 1 is the signal name
-    //captured 2 would be multiplex value if this is a multiplex signal. Then offset the rest of these by 1
-    //captured 2 is the starting bit
-    //captured 3 is the length in bits
-    //captured 4 is the byte order / value type
-    //captured 5 specifies signed/unsigned for ints
-    //captured 6 is the scaling factor
-    //captured 7 is the offset
-    //captured 8 is the minimum value
-    //captured 9 is the maximum value
-    //captured 10 is the unit
-    //captured 11 is the receiving node
+    sig.startBit = tok.digits().toInt(&ok1);
+    if (!tok.accept('|')) return nullptr;
+    sig.signalSize = tok.digits().toInt(&ok2);
+    if (!tok.accept('@')) return nullptr;
+    int val = tok.digits().toInt(&ok3);
+    if (!ok1 || !ok2 || !ok3 || tok.atEnd()) return nullptr;
+    bool isUnsigned = (tok.take() == QLatin1Char('+'));
 
-    if (match.hasMatch())
+    if (val < 2)
     {
-        sig.name = match.captured(1);
-        sig.startBit = match.captured(2 + offset).toInt();
-        sig.signalSize = match.captured(3 + offset).toInt();
-        int val = match.captured(4 + offset).toInt();
-        if (val < 2)
-        {
-            if (match.captured(5 + offset) == "+") sig.valType = UNSIGNED_INT;
-            else sig.valType = SIGNED_INT;
-        }
-        switch (val)
-        {
-        case 0: //big endian mode
-            sig.intelByteOrder = false;
-            break;
-        case 1: //little endian mode
-            sig.intelByteOrder = true;
-            break;
-        case 2:
-            sig.valType = SP_FLOAT;
-            break;
-        case 3:
-            sig.valType = DP_FLOAT;
-            break;
-        case 4:
-            sig.valType = STRING;
-            break;
-        case 5: //single point float in little endian
-            sig.valType = SP_FLOAT;
-            sig.intelByteOrder = true;
-            break;
-        case 6: //double point float in little endian
-            sig.valType = DP_FLOAT;
-            sig.intelByteOrder = true;
-            break;
-        }
-        sig.factor = match.captured(6 + offset).toDouble();
-        sig.bias = match.captured(7 + offset).toDouble();
-        sig.min = match.captured(8 + offset).toDouble();
-        sig.max = match.captured(9 + offset).toDouble();
-        sig.unitName = match.captured(10 + offset);
-        if (match.captured(11 + offset).contains(','))
-        {
-            QString tmp = match.captured(11 + offset).split(',')[0];
-            sig.receiver = findNodeByName(tmp);            
-        }
-        else sig.receiver = findNodeByName(match.captured(11 + offset));
-
-        if (!sig.receiver) sig.receiver = findNodeByIdx(0); //apply default if there was no match
+        if (isUnsigned) sig.valType = UNSIGNED_INT;
+        else sig.valType = SIGNED_INT;
+    }
+    switch (val)
+    {
+    case 0: //big endian mode
+        sig.intelByteOrder = false;
+        break;
+    case 1: //little endian mode
+        sig.intelByteOrder = true;
+        break;
+    case 2:
+        sig.valType = SP_FLOAT;
+        break;
+    case 3:
+        sig.valType = DP_FLOAT;
+        break;
+    case 4:
+        sig.valType = STRING;
+        break;
+    case 5: //single point float in little endian
+        sig.valType = SP_FLOAT;
+        sig.intelByteOrder = true;
+        break;
+    case 6: //double point float in little endian
+        sig.valType = DP_FLOAT;
+        sig.intelByteOrder = true;
+        break;
+    }
 
-        sig.parentMessage = msg;
-        if (msg)
-        {
-            msg->sigHandler->addSignal(sig);
-            if (isMessageMultiplexor) msg->multiplexorSignal = msg->sigHandler->findSignalByName(sig.name);
-            return msg->sigHandler->findSignalByName(sig.name);
-        }
-        else return nullptr;
+    if (!tok.accept('(')) return nullptr;
+    QString factor = tok.number();
+    if (!tok.accept(',')) return nullptr;
+    QString bias = tok.number();
+    if (!tok.accept(')') || !tok.accept('[')) return nullptr;
+    QString min = tok.number();
+    if (!tok.accept('|')) return nullptr;
+    QString max = tok.number();
+    if (!tok.accept(']')) return nullptr;
+    if (factor.isEmpty() || bias.isEmpty() || min.isEmpty() || max.isEmpty()) return nullptr;
+    if (!tok.quoted(sig.unitName, true)) return nullptr;
+
+    sig.factor = factor.toDouble();
+    sig.bias = bias.toDouble();
+    sig.min = min.toDouble();
+    sig.max = max.toDouble();
+
+    QString receivers = tok.rest();
+    if (receivers.contains(','))
+    {
+        QString tmp = receivers.split(',')[0];
+        sig.receiver = findNodeForLoad(tmp);
     }
+    else sig.receiver = findNodeForLoad(receivers);
+
+    if (!sig.receiver) sig.receiver = findNodeByIdx(0); //apply default if there was no match
 
+    sig.parentMessage = msg;
+    if (msg)
+    {
+        msg->sigHandler->addSignal(sig);
+        QPair<DBC_MESSAGE *, QString> key(msg, sig.name.toLower());
+        if (!loadSignalIndex.contains(key)) loadSignalIndex.insert(key, msg->sigHandler->findSignalByIdx(msg->sigHandler->getCount() - 1));
+        DBC_SIGNAL *found = loadSignalIndex.value(key);
+        if (isMessageMultiplexor) msg->multiplexorSignal = found;
+        return found;
+    }
     return nullptr;
 }
 
 //SG_MUL_VAL_ 2024 S1_PID_0D_VehicleSpeed S1 13-13;
 bool DBCFile::parseSignalMultiplexValueLine(QString line)
 {
-    QRegularExpression regex;
+    static const QRegularExpression regex("^SG\\_MUL\\_VAL\\_ (\\d+) ([-\\w]+) ([-\\w]+) (\\d+)\\-(\\d+);");
     QRegularExpressionMatch match;
 
-    qDebug() << "Found a multiplex definition line";
-    regex.setPattern("^SG\\_MUL\\_VAL\\_ (\\d+) ([-\\w]+) ([-\\w]+) (\\d+)\\-(\\d+);");
     match = regex.match(line);
     //captured 1 is message ID
     //Captured 2 is signal name
@@ -655,10 +966,10 @@ bool DBCFile::parseSignalMultiplexValueLine(QString line)
         DBC_MESSAGE *msg = messageHandler->findMsgByID(match.captured(1).toULong() & 0x1FFFFFFFUL);
         if (msg != nullptr)
         {
-            DBC_SIGNAL *thisSignal = msg->sigHandler->findSignalByName(match.captured(2));
+            DBC_SIGNAL *thisSignal = findSignalForLoad(msg, match.captured(2));
             if (thisSignal != nullptr)
             {
-                DBC_SIGNAL *parentSignal = msg->sigHandler->findSignalByName(match.captured(3));
+                DBC_SIGNAL *parentSignal = findSignalForLoad(msg, match.captured(3));
                 if (parentSignal != nullptr)
                 {
                     //now need to add "thisSignal" to the children multiplexed signals of "parentSignal"
@@ -674,59 +985,41 @@ bool DBCFile::parseSignalMultiplexValueLine(QString line)
     return false;
 }
 
+//VAL_ ID signal value "description" value "description" ... ;
 bool DBCFile::parseValueLine(QString line)
 {
-    QRegularExpression regex;
-    QRegularExpressionMatch match;
+    DBCLineTokenizer tok(line);
 
-    qDebug() << "Found a value definition line";
-    regex.setPattern("^VAL\\_ (\\w+) ([-\\w]+) (.*);");
-    match = regex.match(line);
-    //captured 1 is the ID to match against
-    //captured 2 is the signal name to match against
-    //captured 3 is a series of values in the form (number "text") that is, all sep'd by spaces
-    if (match.hasMatch())
+    if (!tok.accept("VAL_")) return false;
+    QString idString = tok.word();
+    QString sigName = tok.word();
+    if (idString.isEmpty() || sigName.isEmpty()) return false;
+
+    DBC_MESSAGE *msg = messageHandler->findMsgByID(idString.toULong() & 0x1FFFFFFFul);
+    if (msg == nullptr) return false;
+    DBC_SIGNAL *sig = findSignalForLoad(msg, sigName);
+    if (sig == nullptr) return false;
+
+    DBC_VAL_ENUM_ENTRY val;
+    while (!tok.accept(';'))
     {
-        //qDebug() << "Data was: " << match.captured(3);
-        DBC_MESSAGE *msg = messageHandler->findMsgByID(match.captured(1).toULong() & 0x1FFFFFFFul);
-        if (msg != nullptr)
-        {
-            DBC_SIGNAL *sig = msg->sigHandler->findSignalByName(match.captured(2));
-            if (sig != nullptr)
-            {
-                QString tokenString = match.captured(3);
-                DBC_VAL_ENUM_ENTRY val;
-                while (tokenString.length() > 2)
-                {
-                    regex.setPattern("(\\d+) \\\"(.*?)\\\"(.*)");
-                    match = regex.match(tokenString);
-                    if (match.hasMatch())
-                    {
-                        val.value = match.captured(1).toULong() & 0x1FFFFFFFul;
-                        val.descript = match.captured(2);
-                        //qDebug() << "sig val " << val.value << " desc " <<val.descript;
-                        sig->valList.append(val);
-                        int rightSize = tokenString.length() - match.captured(1).length() - match.captured(2).length() - 4;
-                        if (rightSize > 0) tokenString = tokenString.right(rightSize);
-                        else tokenString = "";
-                        //qDebug() << "New token string: " << tokenString;
-                    }
-                    else tokenString = "";
-                }
-                return true;
-            }
-        }
+        QString number = tok.number();
+        if (number.isEmpty() || !tok.quoted(val.descript)) break;
+        qint64 value = number.toLongLong();
+        val.value = (value < 0) ? static_cast<int>(value) : static_cast<int>(value & 0x1FFFFFFFul);
+        sig->valList.append(val);
     }
-    return false;
+    return true;
 }
 
 bool DBCFile::parseAttributeLine(QString line)
 {
-    QRegularExpression regex;
+    static const QRegularExpression msgRegex("^BA\\_ \\\"*([-\\w]+)\\\"* BO\\_ (\\d+) \\\"*([#\\w]+)\\\"*");
+    static const QRegularExpression sigRegex("^BA\\_ \\\"*([-\\w]+)\\\"* SG\\_ (\\d+) \\\"*([-\\w]+)\\\"* \\\"*([#\\w]+)\\\"*");
+    static const QRegularExpression nodeRegex("^BA\\_ \\\"*([-\\w]+)\\\"* BU\\_ \\\"*([-\\w]+)\\\"* \\\"*([#\\w]+)\\\"*");
     QRegularExpressionMatch match;
 
-    regex.setPattern("^BA\\_ \\\"*([-\\w]+)\\\"* BO\\_ (\\d+) \\\"*([#\\w]+)\\\"*");
-    match = regex.match(line);
+    match = msgRegex.match(line);
     //captured 1 is the attribute name
     //captured 2 is the message ID number (frame ID)
     //captured 3 is the attribute value
@@ -756,8 +1049,7 @@ bool DBCFile::parseAttributeLine(QString line)
         }
     }
 
-    regex.setPattern("^BA\\_ \\\"*([-\\w]+)\\\"* SG\\_ (\\d+) \\\"*([-\\w]+)\\\"* \\\"*([#\\w]+)\\\"*");
-    match = regex.match(line);
+    match = sigRegex.match(line);
     //captured 1 is the attribute name
     //captured 2 is the message ID number (frame ID)
     //captured 3 is the signal name to bind to
@@ -773,7 +1065,7 @@ bool DBCFile::parseAttributeLine(QString line)
             if (foundMsg)
             {
                 qDebug() << "It references a valid, registered message";
-                DBC_SIGNAL *foundSig = foundMsg->sigHandler->findSignalByName(match.captured(3));
+                DBC_SIGNAL *foundSig = findSignalForLoad(foundMsg, match.captured(3));
                 if (foundSig)
                 {
                     DBC_ATTRIBUTE_VALUE *foundAttrVal = foundSig->findAttrValByName(match.captured(1));
@@ -790,8 +1082,7 @@ bool DBCFile::parseAttributeLine(QString line)
         }
     }
 
-    regex.setPattern("^BA\\_ \\\"*([-\\w]+)\\\"* BU\\_ \\\"*([-\\w]+)\\\"* \\\"*([#\\w]+)\\\"*");
-    match = regex.match(line);
+    match = nodeRegex.match(line);
     //captured 1 is the attribute name
     //captured 2 is the name of the node
     //captured 3 is the attribute value
@@ -802,7 +1093,7 @@ bool DBCFile::parseAttributeLine(QString line)
         if (foundAttr)
         {
             qDebug() << "That node attribute does exist";
-            DBC_NODE *foundNode = findNodeByName(match.captured(2));
+            DBC_NODE *foundNode = findNodeForLoad(match.captured(2));
             if (foundNode)
             {
                 qDebug() << "References a valid node name";
@@ -825,10 +1116,9 @@ bool DBCFile::parseAttributeLine(QString line)
 
 bool DBCFile::parseDefaultAttrLine(QString line)
 {
-    QRegularExpression regex;
+    static const QRegularExpression regex("^BA\\_DEF\\_DEF\\_ \\\"*([-\\w]+)\\\"* \\\"*([#\\w]*)\\\"*");
     QRegularExpressionMatch match;
 
-    regex.setPattern("^BA\\_DEF\\_DEF\\_ \\\"*([-\\w]+)\\\"* \\\"*([#\\w]*)\\\"*");
     match = regex.match(line);
     //captured 1 is the name of the attribute
     //captured 2 is the default value for that attribute
@@ -870,9 +1160,14 @@ bool DBCFile::parseDefaultAttrLine(QString line)
 
 bool DBCFile::loadFile(QString fileName)
 {
+    static const QRegularExpression nodeListRegex("^BU\\_\\:(.*)");
+    static const QRegularExpression sigCommentRegex("^CM\\_ SG\\_ *(\\w+) *([-\\w]+) *\\\"(.*)\\\";");
+    static const QRegularExpression msgCommentRegex("^CM\\_ BO\\_ *(\\w+) *\\\"(.*)\\\";");
+    static const QRegularExpression nodeCommentRegex("^CM\\_ BU\\_ *([-\\w]+) *\\\"(.*)\\\";");
+
     QFile *inFile = new QFile(fileName);
+    QByteArray fileData;
     QString line, rawLine;
-    QRegularExpression regex;
     QRegularExpressionMatch match;
     DBC_MESSAGE *currentMessage = nullptr;
     DBC_ATTRIBUTE attr;
@@ -892,7 +1187,11 @@ bool DBCFile::loadFile(QString fileName)
     }
 
     qDebug() << "Starting DBC load";
+    fileData = inFile->readAll();
     dbc_nodes.clear();
+    loadNodeIndex.clear();
+    loadNodesIndexed = 0;
+    loadSignalIndex.clear();
     messageHandler->removeAllMessages();
     messageHandler->setMatchingCriteria(EXACT);
     messageHandler->setFilterLabeling(false);
@@ -902,14 +1201,19 @@ bool DBCFile::loadFile(QString fileName)
     falseNode.comment = "Default node if none specified";
     dbc_nodes.append(falseNode);
 
-    while (!inFile->atEnd()) {
-        rawLine = QString(inFile->readLine());
+    int lineStart = 0;
+    while (lineStart < fileData.size()) {
+        int lineEnd = fileData.indexOf('\n', lineStart);
+        if (lineEnd < 0) lineEnd = fileData.size();
+        rawLine = QString::fromUtf8(fileData.constData() + lineStart, lineEnd - lineStart);
         line = rawLine.simplified();
+        lineStart = lineEnd + 1;
 
         linesSinceYield++;
         if (linesSinceYield > 100)
         {
             qApp->processEvents();
+            linesSinceYield = 0;
         }
 
         if (inMultilineBU)
@@ -944,8 +1248,7 @@ bool DBCFile::loadFile(QString fileName)
             if (line.startsWith("BU_:")) //line specifies the nodes on this canbus
             {
                 qDebug() << "Found a BU line";
-                regex.setPattern("^BU\\_\\:(.*)");
-                match = regex.match(line);
+                match = nodeListRegex.match(line);
                 //captured 1 = a list of node names separated by spaces. No idea how many yet
                 if (match.hasMatch())
                 {
@@ -968,8 +1271,7 @@ bool DBCFile::loadFile(QString fileName)
             if (line.startsWith("CM_ SG_ "))
             {
                 qDebug() << "Found an SG comment line";
-                regex.setPattern("^CM\\_ SG\\_ *(\\w+) *([-\\w]+) *\\\"(.*)\\\";");
-                match = regex.match(line);
+                match = sigCommentRegex.match(line);
                 //captured 1 is the ID to match against to get to the message
                 //captured 2 is the signal name from that message
                 //captured 3 is the comment itself
@@ -979,7 +1281,7 @@ bool DBCFile::loadFile(QString fileName)
                     DBC_MESSAGE *msg = messageHandler->findMsgByID(match.captured(1).toUInt());
                     if (msg != nullptr)
                     {
-                        DBC_SIGNAL *sig = msg->sigHandler->findSignalByName(match.captured(2));
+                        DBC_SIGNAL *sig = findSignalForLoad(msg, match.captured(2));
                         if (sig != nullptr)
                         {
                             sig->comment = match.captured(3);
@@ -990,8 +1292,7 @@ bool DBCFile::loadFile(QString fileName)
             if (line.startsWith("CM_ BO_ "))
             {
                 qDebug() << "Found a BO comment line";
-                regex.setPattern("^CM\\_ BO\\_ *(\\w+) *\\\"(.*)\\\";");
-                match = regex.match(line);
+                match = msgCommentRegex.match(line);
                 //captured 1 is the ID to match against to get to the message
                 //captured 2 is the comment itself
                 if (match.hasMatch())
@@ -1007,14 +1308,13 @@ bool DBCFile::loadFile(QString fileName)
             if (line.startsWith("CM_ BU_ "))
             {
                 qDebug() << "Found a BU comment line";
-                regex.setPattern("^CM\\_ BU\\_ *([-\\w]+) *\\\"(.*)\\\";");
-                match = regex.match(line);
+                match = nodeCommentRegex.match(line);
                 //captured 1 is the Node name
                 //captured 2 is the comment itself
                 if (match.hasMatch())
                 {
                     //qDebug() << "Comment was: " << match.captured(2);
-                    DBC_NODE *node = findNodeByName(match.captured(1));
+                    DBC_NODE *node = findNodeForLoad(match.captured(1));
                     if (node != nullptr)
                     {
                         node->comment = match.captured(2);
@@ -1182,6 +1482,9 @@ bool DBCFile::loadFile(QString fileName)
     }
     inFile->close();
     delete inFile;
+    loadNodeIndex.clear();
+    loadSignalIndex.clear();
+    DBCSignalHandler::invalidateTables(); //multiplex relationships were filled in after the signals were added
     QStringList fileList = fileName.split('/');
     this->fileName = fileList[fileList.length() - 1]; //whoops... same name as parameter in this function.
     filePath = fileName.left(fileName.length() - this->fileName.length());
@@ -1212,11 +1515,11 @@ QVariant DBCFile::processAttributeVal(QString input, DBC_ATTRIBUTE_VAL_TYPE typ)
 bool DBCFile::parseAttribute(QString inpString, DBC_ATTRIBUTE &attr)
 {
     bool goodAttr = false;
-    QRegularExpression regex;
+    static const QRegularExpression boundedRegex("\\\"*(\\w+)\\\"* \\\"*(\\w+)\\\"* (\\d+) (\\d+)");
+    static const QRegularExpression unboundedRegex("\\\"*(\\w+)\\\"* \\\"*(\\w+)\\\"* (.*)");
     QRegularExpressionMatch match;
 
-    regex.setPattern("\\\"*(\\w+)\\\"* \\\"*(\\w+)\\\"* (\\d+) (\\d+)");
-    match = regex.match(inpString);
+    match = boundedRegex.match(inpString);
     //captured 1 is the name of the attribute to set up
     //captured 2 is the type of signal attribute to create.
     //captured 3 is the lower bound value for this attribute
@@ -1255,8 +1558,7 @@ bool DBCFile::parseAttribute(QString inpString, DBC_ATTRIBUTE &attr)
     }
     else
     {
-        regex.setPattern("\\\"*(\\w+)\\\"* \\\"*(\\w+)\\\"* (.*)");
-        match = regex.match(inpString);
+        match = unboundedRegex.match(inpString);
         //Same as above but no upper/lower bound values.
         if (match.hasMatch())
         {
@@ -1305,348 +1607,340 @@ bool DBCFile::parseAttribute(QString inpString, DBC_ATTRIBUTE &attr)
     return goodAttr;
 }
 
-bool DBCFile::saveFile(QString fileName)
+//Text of an attribute value the way it goes after the object it applies to in a BA_ line
+static QString attributeValueText(const DBC_ATTRIBUTE_VALUE &val)
 {
-    int nodeNumber = 1;
-    int msgNumber = 1;
-    int sigNumber = 1;
-    QFile *outFile = new QFile(fileName);
-    QString nodesOutput, msgOutput, commentsOutput, valuesOutput, extMultiplexOutput;
-    QString defaultsOutput, attrValOutput;
-    bool hasExtendedMultiplexing = false;
+    switch (val.value.type())
+    {
+    case QVariant::Type::String:
+        return "\"" + val.value.toString() + "\";\n";
+    default:
+        return val.value.toString() + ";\n";
+    }
+}
 
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
+//Builds the text of every section of the file which belongs to one message. Messages and signals without
+//a name are given one here, same as a save always has.
+void DBCFile::renderMessage(DBC_MESSAGE *msg, SavedMessageText &out, int &msgNumber, int &sigNumber)
+{
+    QString text;
+
+    if (msg->name.length() < 1) //detect an empty string and fill it out with something
     {
-        delete outFile;
-        return false;
+        msg->name = "MSG" + QString::number(msgNumber);
+        msgNumber++;
     }
 
-    //right now it outputs a standard hard coded boilerplate
-    outFile->write("VERSION \"\"\n");
-    outFile->write("\n");
-    outFile->write("\n");
-    outFile->write("NS_ :\n");
-    outFile->write("    NS_DESC_\n");
-    outFile->write("    CM_\n");
-    outFile->write("    BA_DEF_\n");
-    outFile->write("    BA_\n");
-    outFile->write("    VAL_\n");
-    outFile->write("    CAT_DEF_\n");
-    outFile->write("    CAT_\n");
-    outFile->write("    FILTER\n");
-    outFile->write("    BA_DEF_DEF_\n");
-    outFile->write("    EV_DATA_\n");
-    outFile->write("    ENVVAR_DATA_\n");
-    outFile->write("    SGTYPE_\n");
-    outFile->write("    SGTYPE_VAL_\n");
-    outFile->write("    BA_DEF_SGTYPE_\n");
-    outFile->write("    BA_SGTYPE_\n");
-    outFile->write("    SIG_TYPE_REF_\n");
-    outFile->write("    VAL_TABLE_\n");
-    outFile->write("    SIG_GROUP_\n");
-    outFile->write("    SIG_VALTYPE_\n");
-    outFile->write("    SIGTYPE_VALTYPE_\n");
-    outFile->write("    BO_TX_BU_\n");
-    outFile->write("    BA_DEF_REL_\n");
-    outFile->write("    BA_REL_\n");
-    outFile->write("    BA_DEF_DEF_REL_\n");
-    outFile->write("    BU_SG_REL_\n");
-    outFile->write("    BU_EV_REL_\n");
-    outFile->write("    BU_BO_REL_\n");
-    outFile->write("    SG_MUL_VAL_\n");
-    outFile->write("\n");
-    outFile->write("BS_: \n");
-
-    //Build list of nodes line
-    nodesOutput.append("BU_: ");
-    for (int x = 0; x < dbc_nodes.count(); x++)
+    uint32_t ID = msg->ID;
+    if (msg->ID > 0x7FF || msg->extendedID)
     {
-        DBC_NODE node = dbc_nodes[x];
-        if (node.name.compare("Vector__XXX", Qt::CaseInsensitive) != 0)
-        {
-            if (node.name.length() < 1) //detect an empty string and fill it out with something
-            {
-                node.name = "NODE" + QString::number(nodeNumber);
-                nodeNumber++;
-            }
-            nodesOutput.append(node.name + " ");
-            if (node.comment.length() > 0)
-            {
-                commentsOutput.append("CM_ BU_ " + node.name + " \"" + node.comment + "\";\n");
-            }
-            if (node.attributes.count() > 0)
-            {
-                foreach (DBC_ATTRIBUTE_VALUE val, node.attributes) {
-                    attrValOutput.append("BA_ \"" + val.attrName + "\" BU_ ");
-                    switch (val.value.type())
-                    {
-                    case QVariant::Type::String:
-                        attrValOutput.append("\"" + val.value.toString() + "\";\n");
-                        break;
-                    default:
-                        attrValOutput.append(val.value.toString() + ";\n");
-                        break;
-                    }
-                }
-            }
-        }
+        ID += 0x80000000ul; //set bit 31 if this ID is extended.
     }
-    nodesOutput.append("\n");
-    outFile->write(nodesOutput.toUtf8());
+    const QString idText = QString::number(ID);
 
-    //Go through all messages one at at time issuing the message line then all signals in there too.
-    for (int x = 0; x < messageHandler->getCount(); x++)
+    out.hasExtendedMultiplexing = false;
+    out.comments.clear();
+    out.attributeValues.clear();
+    out.valueTables.clear();
+    out.extMultiplexing.clear();
+
+    text = "BO_ " + idText + " " + msg->name + ": " + QString::number(msg->len) + " " + msg->sender->name + "\n";
+    if (msg->comment.length() > 0)
     {
-        DBC_MESSAGE *msg = messageHandler->findMsgByIdx(x);
+        out.comments.append(("CM_ BO_ " + idText + " \"" + msg->comment + "\";\n").toUtf8());
+    }
+
+    foreach (DBC_ATTRIBUTE_VALUE val, msg->attributes)
+    {
+        out.attributeValues.append(("BA_ \"" + val.attrName + "\" BO_ " + idText + " " + attributeValueText(val)).toUtf8());
+    }
+
+    for (int s = 0; s < msg->sigHandler->getCount(); s++)
+    {
+        DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(s);
 
-        if (msg->name.length() < 1) //detect an empty string and fill it out with something
+        if (sig->name.length() < 1) //detect an empty string and fill it out with something
         {
-            msg->name = "MSG" + QString::number(msgNumber);
-            msgNumber++;
+            sig->name = "SIG" + QString::number(sigNumber);
+            sigNumber++;
         }
 
-        uint32_t ID = msg->ID;
-        if (msg->ID > 0x7FF || msg->extendedID)
+        text.append("   SG_ " + sig->name);
+
+        if (sig->isMultiplexed)
         {
-            ID += 0x80000000ul; //set bit 31 if this ID is extended.
+            text.append(" m" + QString::number(sig->multiplexLowValue));
         }
-
-        msgOutput.append("BO_ " + QString::number(ID) + " " + msg->name + ": " + QString::number(msg->len) +
-                         " " + msg->sender->name + "\n");
-        if (msg->comment.length() > 0)
+        if (sig->isMultiplexor)
         {
-            commentsOutput.append("CM_ BO_ " + QString::number(ID) + " \"" + msg->comment + "\";\n");
+            if (!sig->isMultiplexed) text.append(" ");
+            text.append("M");
         }
+        //check for the two telltale signs that we've got extended multiplexing going on.
+        if (sig->isMultiplexed && sig->isMultiplexor) out.hasExtendedMultiplexing = true;
+        if (sig->multiplexLowValue != sig->multiplexHighValue) out.hasExtendedMultiplexing = true;
+
+        text.append(" : " + QString::number(sig->startBit) + "|" + QString::number(sig->signalSize) + "@");
 
-        //If this message has attributes then compile them into attributes list to output later on.
-        if (msg->attributes.count() > 0)
+        switch (sig->valType)
         {
-            foreach (DBC_ATTRIBUTE_VALUE val, msg->attributes) {
-                attrValOutput.append("BA_ \"" + val.attrName + "\" BO_ " + QString::number(ID) + " ");
-                switch (val.value.type())
-                {
-                case QVariant::Type::String:
-                    attrValOutput.append("\"" + val.value.toString() + "\";\n");
-                    break;
-                default:
-                    attrValOutput.append(val.value.toString() + ";\n");
-                    break;
-                }
-            }
+        case UNSIGNED_INT:
+            if (sig->intelByteOrder) text.append("1+");
+            else text.append("0+");
+            break;
+        case SIGNED_INT:
+            if (sig->intelByteOrder) text.append("1-");
+            else text.append("0-");
+            break;
+        case SP_FLOAT:
+            if (sig->intelByteOrder) text.append("5-");
+            else text.append("2-");
+            break;
+        case DP_FLOAT:
+            if (sig->intelByteOrder) text.append("6-");
+            else text.append("3-");
+            break;
+        case STRING:
+            text.append("4-");
+            break;
+        default:
+            text.append("0-");
+            break;
+        }
+        text.append(" (" + QString::number(sig->factor) + "," + QString::number(sig->bias) + ") [" +
+                    QString::number(sig->min) + "|" + QString::number(sig->max) + "] \"" + sig->unitName
+                    + "\" " + sig->receiver->name + "\n");
+        if (sig->comment.length() > 0)
+        {
+            out.comments.append(("CM_ SG_ " + idText + " " + sig->name + " \"" + sig->comment + "\";\n").toUtf8());
         }
 
-        for (int s = 0; s < msg->sigHandler->getCount(); s++)
+        foreach (DBC_ATTRIBUTE_VALUE val, sig->attributes)
         {
-            DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(s);
+            out.attributeValues.append(("BA_ \"" + val.attrName + "\" SG_ " + idText + " " + sig->name + " " + attributeValueText(val)).toUtf8());
+        }
 
-            if (sig->name.length() < 1) //detect an empty string and fill it out with something
+        if (sig->valList.count() > 0)
+        {
+            QString values = "VAL_ " + idText + " " + sig->name;
+            for (int v = 0; v < sig->valList.count(); v++)
             {
-                sig->name = "SIG" + QString::number(sigNumber);
-                sigNumber++;
+                const DBC_VAL_ENUM_ENTRY &val = sig->valList[v];
+                values.append(" " + QString::number(val.value) + " \"" + val.descript +"\"");
             }
+            values.append(";\n");
+            out.valueTables.append(values.toUtf8());
+        }
 
-            msgOutput.append("   SG_ " + sig->name);
+        //only written out if some signal in the file needs extended multiplexing but it's cheap to always build
+        if (sig->isMultiplexed && sig->multiplexParent)
+        {
+            out.extMultiplexing.append(("SG_MUL_VAL_ " + idText + " " + sig->name + " " + sig->multiplexParent->name + " "
+                                        + QString::number(sig->multiplexLowValue) + "-" + QString::number(sig->multiplexHighValue) + ";\n").toUtf8());
+        }
+    }
+    text.append("\n");
+    out.definition = text.toUtf8();
+}
 
-            if (sig->isMultiplexed)
-            {
-                msgOutput.append(" m" + QString::number(sig->multiplexLowValue));
-            }
-            if (sig->isMultiplexor)
-            {
-                if (!sig->isMultiplexed) msgOutput.append(" ");
-                msgOutput.append("M");
-            }
-            //check for the two telltale signs that we've got extended multiplexing going on.
-            if (sig->isMultiplexed && sig->isMultiplexor) hasExtendedMultiplexing = true;
-            if (sig->multiplexLowValue != sig->multiplexHighValue) hasExtendedMultiplexing = true;
+/*
+ * The file is written one section at a time, straight through a DBCFileWriter, in a fixed order: boilerplate, nodes,
+ * messages and their signals, comments, attribute definitions, attribute defaults, attribute values, value tables and
+ * finally extended multiplexing. Within each section things go in list order (nodes, then messages, then the signals of
+ * each message) so saving the same data always produces the same file.
+ * The text for each message is kept after a save. With reuseUnchanged set only messages which have been changed
+ * since (see setDirtyFlag) are built again, everything else is written from the kept text.
+*/
+bool DBCFile::saveFile(QString fileName, bool reuseUnchanged)
+{
+    int nodeNumber = 1;
+    int msgNumber = 1;
+    int sigNumber = 1;
+    QFile *outFile = new QFile(fileName);
+    bool hasExtendedMultiplexing = false;
 
-            msgOutput.append(" : " + QString::number(sig->startBit) + "|" + QString::number(sig->signalSize) + "@");
+    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        delete outFile;
+        return false;
+    }
 
-            switch (sig->valType)
-            {
-            case UNSIGNED_INT:
-                if (sig->intelByteOrder) msgOutput.append("1+");
-                else msgOutput.append("0+");
-                break;
-            case SIGNED_INT:
-                if (sig->intelByteOrder) msgOutput.append("1-");
-                else msgOutput.append("0-");
-                break;
-            case SP_FLOAT:
-                if (sig->intelByteOrder) msgOutput.append("5-");
-                else msgOutput.append("2-");
-                break;
-            case DP_FLOAT:
-                if (sig->intelByteOrder) msgOutput.append("6-");
-                else msgOutput.append("3-");
-                break;
-            case STRING:
-                msgOutput.append("4-");
-                break;
-            default:
-                msgOutput.append("0-");
-                break;
-            }
-            msgOutput.append(" (" + QString::number(sig->factor) + "," + QString::number(sig->bias) + ") [" +
-                             QString::number(sig->min) + "|" + QString::number(sig->max) + "] \"" + sig->unitName
-                             + "\" " + sig->receiver->name + "\n");
-            if (sig->comment.length() > 0)
-            {
-                commentsOutput.append("CM_ SG_ " + QString::number(ID) + " " + sig->name + " \"" + sig->comment + "\";\n");
-            }
+    DBCFileWriter out(outFile);
 
-            //if this signal has attributes then compile them in a special list of attributes
-            if (sig->attributes.count() > 0)
-            {
-                foreach (DBC_ATTRIBUTE_VALUE val, sig->attributes) {
-                    attrValOutput.append("BA_ \"" + val.attrName + "\" SG_ " + QString::number(ID) + " " + sig->name + " ");
-                    switch (val.value.type())
-                    {
-                    case QVariant::Type::String:
-                        attrValOutput.append("\"" + val.value.toString() + "\";\n");
-                        break;
-                    default:
-                        attrValOutput.append(val.value.toString() + ";\n");
-                        break;
-                    }
-                }
-            }
+    //right now it outputs a standard hard coded boilerplate
+    out.write("VERSION \"\"\n");
+    out.write("\n");
+    out.write("\n");
+    out.write("NS_ :\n");
+    out.write("    NS_DESC_\n");
+    out.write("    CM_\n");
+    out.write("    BA_DEF_\n");
+    out.write("    BA_\n");
+    out.write("    VAL_\n");
+    out.write("    CAT_DEF_\n");
+    out.write("    CAT_\n");
+    out.write("    FILTER\n");
+    out.write("    BA_DEF_DEF_\n");
+    out.write("    EV_DATA_\n");
+    out.write("    ENVVAR_DATA_\n");
+    out.write("    SGTYPE_\n");
+    out.write("    SGTYPE_VAL_\n");
+    out.write("    BA_DEF_SGTYPE_\n");
+    out.write("    BA_SGTYPE_\n");
+    out.write("    SIG_TYPE_REF_\n");
+    out.write("    VAL_TABLE_\n");
+    out.write("    SIG_GROUP_\n");
+    out.write("    SIG_VALTYPE_\n");
+    out.write("    SIGTYPE_VALTYPE_\n");
+    out.write("    BO_TX_BU_\n");
+    out.write("    BA_DEF_REL_\n");
+    out.write("    BA_REL_\n");
+    out.write("    BA_DEF_DEF_REL_\n");
+    out.write("    BU_SG_REL_\n");
+    out.write("    BU_EV_REL_\n");
+    out.write("    BU_BO_REL_\n");
+    out.write("    SG_MUL_VAL_\n");
+    out.write("\n");
+    out.write("BS_: \n");
+
+    //Build list of nodes line. Nodes without a name get one in the file but not in memory.
+    QList<int> savedNodes;
+    QStringList nodeNames;
+    out.write("BU_: ");
+    for (int x = 0; x < dbc_nodes.count(); x++)
+    {
+        QString name = dbc_nodes[x].name;
+        if (name.compare("Vector__XXX", Qt::CaseInsensitive) == 0) continue;
+        if (name.length() < 1) //detect an empty string and fill it out with something
+        {
+            name = "NODE" + QString::number(nodeNumber);
+            nodeNumber++;
+        }
+        savedNodes.append(x);
+        nodeNames.append(name);
+        out.write(name + " ");
+    }
+    out.write("\n");
 
-            if (sig->valList.count() > 0)
-            {
-                valuesOutput.append("VAL_ " + QString::number(ID) + " " + sig->name);
-                for (int v = 0; v < sig->valList.count(); v++)
-                {
-                    DBC_VAL_ENUM_ENTRY val = sig->valList[v];
-                    valuesOutput.append(" " + QString::number(val.value) + " \"" + val.descript +"\"");
-                }
-                valuesOutput.append(";\n");
-            }
+    //Go through all messages one at at time issuing the message line then all signals in there too.
+    if (!reuseUnchanged) savedMessages.clear();
+    for (int x = 0; x < messageHandler->getCount(); x++)
+    {
+        DBC_MESSAGE *msg = messageHandler->findMsgByIdx(x);
+        QHash<const DBC_MESSAGE *, SavedMessageText>::iterator saved = savedMessages.find(msg);
+        if (saved == savedMessages.end())
+        {
+            saved = savedMessages.insert(msg, SavedMessageText());
+            renderMessage(msg, saved.value(), msgNumber, sigNumber);
         }
-        msgOutput.append("\n");
-        //write it out every message so the string doesn't end up too huge
-        outFile->write(msgOutput.toUtf8());
-        msgOutput.clear(); //got to reset it after writing
+        if (saved.value().hasExtendedMultiplexing) hasExtendedMultiplexing = true;
+        out.write(saved.value().definition);
     }
 
-    outFile->write(commentsOutput.toUtf8());
-    commentsOutput.clear();
+    //nothing gets added to savedMessages from here on so pointers into it stay good
+    QVector<const SavedMessageText *> messageText(messageHandler->getCount());
+    for (int x = 0; x < messageText.count(); x++) messageText[x] = &savedMessages.constFind(messageHandler->findMsgByIdx(x)).value();
+
+    for (int x = 0; x < savedNodes.count(); x++)
+    {
+        const DBC_NODE &node = dbc_nodes[savedNodes[x]];
+        if (node.comment.length() > 0) out.write("CM_ BU_ " + nodeNames[x] + " \"" + node.comment + "\";\n");
+    }
+    for (int x = 0; x < messageText.count(); x++) out.write(messageText[x]->comments);
 
     //Now dump out all of the stored attributes
     for (int x = 0; x < dbc_attributes.count(); x++)
     {
-        msgOutput.append("BA_DEF_ ");
+        QString line = "BA_DEF_ ";
         switch (dbc_attributes[x].attrType)
         {
         case ATTR_TYPE_GENERAL:
             break;
         case ATTR_TYPE_NODE:
-            msgOutput.append("BU_ ");
+            line.append("BU_ ");
             break;
         case ATTR_TYPE_MESSAGE:
-            msgOutput.append("BO_ ");
+            line.append("BO_ ");
             break;
         case ATTR_TYPE_SIG:
-            msgOutput.append("SG_ ");
+            line.append("SG_ ");
             break;
         case ATTR_TYPE_ANY:
             break;
         }
 
-        msgOutput.append("\"" + dbc_attributes[x].name + "\" ");
+        line.append("\"" + dbc_attributes[x].name + "\" ");
 
         switch (dbc_attributes[x].valType)
         {
         case ATTR_INT:
-            msgOutput.append("INT " + QString::number(dbc_attributes[x].lower) + " " + QString::number(dbc_attributes[x].upper));
+            line.append("INT " + QString::number(dbc_attributes[x].lower) + " " + QString::number(dbc_attributes[x].upper));
             break;
         case ATTR_FLOAT:
-            msgOutput.append("FLOAT " + QString::number(dbc_attributes[x].lower) + " " + QString::number(dbc_attributes[x].upper));
+            line.append("FLOAT " + QString::number(dbc_attributes[x].lower) + " " + QString::number(dbc_attributes[x].upper));
             break;
         case ATTR_STRING:
-            msgOutput.append("STRING ");
+            line.append("STRING ");
             break;
         case ATTR_ENUM:
-            msgOutput.append("ENUM ");
+            line.append("ENUM ");
             foreach (QString str, dbc_attributes[x].enumVals)
             {
-                msgOutput.append("\"" + str + "\",");
+                line.append("\"" + str + "\",");
             }
-            msgOutput.truncate(msgOutput.length() - 1); //remove trailing ,
+            line.truncate(line.length() - 1); //remove trailing ,
             break;
         }
 
-        msgOutput.append(";\n");
+        line.append(";\n");
+        out.write(line);
+    }
 
-        outFile->write(msgOutput.toUtf8());
-        msgOutput.clear(); //got to reset it after writing
+    for (int x = 0; x < dbc_attributes.count(); x++)
+    {
+        if (!dbc_attributes[x].defaultValue.isValid()) continue;
+        QString line = "BA_DEF_DEF_ \"" + dbc_attributes[x].name + "\" ";
+        switch (dbc_attributes[x].valType)
+        {
+        case ATTR_STRING:
+            line.append("\"" + dbc_attributes[x].defaultValue.toString() + "\";\n");
+            break;
+        case ATTR_ENUM:
+            line.append("\"" + dbc_attributes[x].enumVals[dbc_attributes[x].defaultValue.toInt()] + "\";\n");
+            break;
+        case ATTR_INT:
+            line.append(QString::number(dbc_attributes[x].defaultValue.toLongLong()) + ";\n");
+            break;
+        case ATTR_FLOAT:
+            line.append(dbc_attributes[x].defaultValue.toString() + ";\n");
+            break;
+        }
+        out.write(line);
+    }
 
-        if (dbc_attributes[x].defaultValue.isValid())
+    for (int x = 0; x < savedNodes.count(); x++)
+    {
+        foreach (DBC_ATTRIBUTE_VALUE val, dbc_nodes[savedNodes[x]].attributes)
         {
-            defaultsOutput.append("BA_DEF_DEF_ \"" + dbc_attributes[x].name + "\" ");
-            switch (dbc_attributes[x].valType)
-            {
-            case ATTR_STRING:
-                defaultsOutput.append("\"" + dbc_attributes[x].defaultValue.toString() + "\";\n");
-                break;
-            case ATTR_ENUM:
-                defaultsOutput.append("\"" + dbc_attributes[x].enumVals[dbc_attributes[x].defaultValue.toInt()] + "\";\n");
-                break;
-            case ATTR_INT:
-                defaultsOutput.append(QString::number(dbc_attributes[x].defaultValue.toLongLong()) + ";\n");
-                break;
-            case ATTR_FLOAT:
-                defaultsOutput.append(dbc_attributes[x].defaultValue.toString() + ";\n");
-                break;
-            }
+            out.write("BA_ \"" + val.attrName + "\" BU_ " + nodeNames[x] + " " + attributeValueText(val));
         }
     }
+    for (int x = 0; x < messageText.count(); x++) out.write(messageText[x]->attributeValues);
+
+    for (int x = 0; x < messageText.count(); x++) out.write(messageText[x]->valueTables);
 
     //extended multiplexing uses SG_MUL_VAL_ to specify the relationships. If a signal is marked
     //as multiplexed then output a record for it. That's the most complete option. We've already
     //given the single value multiplex above for backward compatibility with things that don't support extended mode
     if (hasExtendedMultiplexing)
     {
-        for (int x = 0; x < messageHandler->getCount(); x++)
-        {
-            DBC_MESSAGE *msg = messageHandler->findMsgByIdx(x);
-
-            uint32_t ID = msg->ID;
-            if (msg->ID > 0x7FF || msg->extendedID)
-            {
-                ID += 0x80000000ul; //set bit 31 if this ID is extended.
-            }
-
-            for (int s = 0; s < msg->sigHandler->getCount(); s++)
-            {
-                DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(s);
-
-                if (sig->isMultiplexed)
-                {
-                    msgOutput.append("SG_MUL_VAL_ " + QString::number(ID) + " ");
-                    msgOutput.append(sig->name + " " + sig->multiplexParent->name + " ");
-                    msgOutput.append(QString::number(sig->multiplexLowValue) + "-" + QString::number(sig->multiplexHighValue) + ";");
-                    msgOutput.append("\n");
-                    extMultiplexOutput.append(msgOutput);
-                    msgOutput.clear(); //got to reset it after writing
-                }
-            }
-        }
+        for (int x = 0; x < messageText.count(); x++) out.write(messageText[x]->extMultiplexing);
     }
 
-    //now write out all of the accumulated comments and value tables from above
-    outFile->write(defaultsOutput.toUtf8());
-    outFile->write(attrValOutput.toUtf8());    
-    outFile->write(valuesOutput.toUtf8());
-    outFile->write(extMultiplexOutput.toUtf8());
-
-    attrValOutput.clear();
-    defaultsOutput.clear();
-    valuesOutput.clear();
-    extMultiplexOutput.clear();
-
+    bool written = out.flush();
     outFile->close();
     delete outFile;
+    if (!written) return false;
 
     isDirty = false;
 
@@ -1681,7 +1975,7 @@ void DBCHandler::saveDBCFile(int idx)
     {
         filename = dialog.selectedFiles()[0];
         if (!filename.contains('.')) filename += ".dbc";
-        loadedFiles[idx].saveFile(filename);
+        loadedFiles[idx].saveFile(filename, settings.value("DBC/IncrementalSave", true).toBool());
         settings.setValue("DBC/LoadSaveDirectory", dialog.directory().path());
     }
 }
@@ -2136,11 +2430,13 @@ void DBCHandler::removeDBCFile(int idx)
     if (idx < 0) return;
     if (idx >= loadedFiles.count()) return;
     loadedFiles.removeAt(idx);
+    invalidateLookup();
 }
 
 void DBCHandler::removeAllFiles()
 {
     loadedFiles.clear();
+    invalidateLookup();
 }
 
 void DBCHandler::swapFiles(int pos1, int pos2)
@@ -2152,6 +2448,7 @@ void DBCHandler::swapFiles(int pos1, int pos2)
     if (pos2 >= loadedFiles.count()) return;
 
     loadedFiles.swapItemsAt(pos1, pos2);
+    invalidateLookup();
 }
 
 /*
@@ -2159,18 +2456,62 @@ void DBCHandler::swapFiles(int pos1, int pos2)
  * You give it a canbus frame and it'll tell you whether there is a loaded DBC file that can
  * interpret that frame for you.
  * Returns nullptr if there is no message definition that matches.
+ * The answer for each bus and ID is remembered so repeated frames cost a single hash lookup. Anything which
+ * could change the answer (loading, removing or reordering files, changing the bus or matching criteria
+ * of a file, editing messages) calls invalidateLookup() which causes the remembered answers to be dropped.
 */
 DBC_MESSAGE* DBCHandler::findMessage(const CANFrame &frame)
 {
+    if (frameLookupGeneration != lookupGeneration)
+    {
+        frameLookup.clear();
+        frameLookupGeneration = lookupGeneration;
+    }
+
+    quint64 key = (static_cast<quint64>(static_cast<uint32_t>(frame.bus)) << 32) | frame.frameId();
+    QHash<quint64, DBC_MESSAGE*>::const_iterator it = frameLookup.constFind(key);
+    if (it != frameLookup.constEnd()) return it.value();
+
+    DBC_MESSAGE* msg = nullptr;
     for(int i = 0; i < loadedFiles.count(); i++)
     {
         if (loadedFiles[i].getAssocBus() == -1 || frame.bus == loadedFiles[i].getAssocBus())
         {
-            DBC_MESSAGE* msg = loadedFiles[i].messageHandler->findMsgByID(frame.frameId());
-            if (msg != nullptr) return msg;
+            msg = loadedFiles[i].messageHandler->findMsgByID(frame.frameId());
+            if (msg != nullptr) break;
         }
     }
-    return nullptr;
+
+    if (frameLookup.count() >= FRAME_LOOKUP_MAX) frameLookup.clear();
+    frameLookup.insert(key, msg);
+    return msg;
+}
+
+void DBCHandler::invalidateLookup()
+{
+    lookupGeneration++;
+}
+
+/*
+ * Returns a frozen copy of everything loaded right now, for decoding on other threads. Must be called from the
+ * thread which owns the live DBC data (the GUI thread). The same snapshot is returned until a message lookup or a
+ * signal definition could have changed, then a new one is built. Snapshots already handed out stay as they were.
+*/
+QSharedPointer<const DBCSnapshot> DBCHandler::getSnapshot()
+{
+    if (currentSnapshot && snapshotLookupGeneration == lookupGeneration
+            && snapshotEditGeneration == DBCSignalHandler::editGeneration())
+        return currentSnapshot;
+
+    DBCSnapshot *snapshot = new DBCSnapshot;
+    snapshot->version = ++snapshotVersion;
+    for (int i = 0; i < loadedFiles.count(); i++) snapshot->copyFile(loadedFiles[i]);
+    currentSnapshot = QSharedPointer<const DBCSnapshot>(snapshot);
+
+    //building the copies bumps both generations so only note them down afterward
+    snapshotLookupGeneration = lookupGeneration;
+    snapshotEditGeneration = DBCSignalHandler::editGeneration();
+    return currentSnapshot;
 }
 
 DBC_MESSAGE* DBCHandler::findMessage(uint32_t id)
@@ -2290,6 +2631,11 @@ DBCFile* DBCHandler::getFileByName(QString name)
 
 DBCHandler::DBCHandler()
 {
+    frameLookupGeneration = -1;
+    snapshotLookupGeneration = -1;
+    snapshotEditGeneration = -1;
+    snapshotVersion = 0;
+
     // Load previously saved DBC file settings
     QSettings settings;
     qDebug() <<"Settings file: " << settings.fileName();
@@ -2,6 +2,11 @@
 #define DBCHANDLER_H
 
 #include <QObject>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
 #include "dbc_classes.h"
 #include "can_structs.h"
 
@@ -17,10 +22,20 @@
  * Finish coding up the decoupled design
  *
 */
+/*
+ * Decoding a whole frame goes through a multiplex table compiled from the signal list. Every signal gets an entry and
+ * every multiplexor entry maps each multiplex value straight to the entries it selects (signals with a range of values
+ * are kept in a short side list) so a multiplexor is decoded once per frame no matter how many signals hang off it.
+ * Extended multiplexing is just a multiplexor entry selecting another multiplexor entry. The table is rebuilt the next
+ * time it is needed after any signal in any file changes. The value tables of the signals (see DBC_VALUE_TABLE) get
+ * checked along with it but each one is only rebuilt if its own value list was edited. Anything which edits signals
+ * without going through this class or DBCFile::setDirtyFlag() must call invalidateTables() afterward.
+*/
 class DBCSignalHandler: public QObject
 {
     Q_OBJECT
 public:
+    DBCSignalHandler();
     DBC_SIGNAL *findSignalByName(QString name);
     DBC_SIGNAL *findSignalByIdx(int idx);
     bool addSignal(DBC_SIGNAL &sig);
@@ -30,15 +45,43 @@ public:
     void removeAllSignals();
     int getCount();
     void sort();
+    //every signal the frame carries along with its value. Top level signals in order, each multiplexor followed by what it selects
+    void decodeFrame(const CANFrame &frame, QVector<DBC_DECODED_SIGNAL> &outSignals);
+    void freeze();
+    static void invalidateTables();
+    static int editGeneration(); //changes every time invalidateTables() is called
 
 private:
+    struct MuxTableEntry
+    {
+        DBC_SIGNAL *signal;
+        QHash<int32_t, QVector<int>> exactChildren; //multiplex value -> entries selected by exactly that value
+        QVector<int> rangedChildren;                //entries selected by a range of values
+    };
+
     QList<DBC_SIGNAL> sigs; //signals is a reserved word or I'd have used that
+    QVector<MuxTableEntry> muxEntries;
+    QVector<int> muxRoots;  //entries for the signals which aren't selected by a multiplexor
+    int muxTableGeneration;
+    bool frozen;
+
+    void buildMuxTable();
+    int addMuxEntry(DBC_SIGNAL *sig, QSet<DBC_SIGNAL *> &visited);
+    void decodeMuxEntry(int idx, const CANFrame &frame, QVector<DBC_DECODED_SIGNAL> &outSignals);
 };
 
+/*
+ * Message lookups by ID go through a set of hash tables built from the message list. There is one table for exact
+ * IDs and one for each of the masked forms the matching criteria can compare (J1939 PDU1 and PDU2 PGNs, GMLAN arbitration ID)
+ * so finding a message is a constant time affair no matter how many messages the file defines. The tables are
+ * kept up to date as messages are added and thrown away by anything else which changes the list. Code which changes
+ * the ID of a message in place must call invalidateIndex() afterward.
+*/
 class DBCMessageHandler: public QObject
 {
     Q_OBJECT
 public:
+    DBCMessageHandler();
     DBC_MESSAGE *findMsgByID(uint32_t id);
     DBC_MESSAGE *findMsgByIdx(int idx);
     DBC_MESSAGE *findMsgByName(QString name);
@@ -56,11 +99,23 @@ public:
     void setFilterLabeling( bool labelFiltering );
     bool filterLabeling();
     void sort();
+    void invalidateIndex();
+    void freeze();
 
 private:
     QList<DBC_MESSAGE> messages;
     MatchingCriteria_t matchingCriteria;
     bool filterLabelingEnabled;
+
+    //each table maps a (possibly masked) ID to the index of the message it resolves to
+    QHash<uint32_t, int> exactIndex;
+    QHash<uint32_t, int> pdu1Index;
+    QHash<uint32_t, int> pdu2Index;
+    QHash<uint32_t, int> gmlanIndex;
+    bool indexValid;
+
+    void buildIndex();
+    void indexMessage(int idx);
 };
 
 //technically there should be a node handler too but I'm sort of treating nodes as second class
@@ -78,7 +133,7 @@ public:
     DBC_ATTRIBUTE *findAttributeByName(QString name, DBC_ATTRIBUTE_TYPE type = ATTR_TYPE_ANY);
     DBC_ATTRIBUTE *findAttributeByIdx(int idx);
     void findAttributesByType(DBC_ATTRIBUTE_TYPE typ, QList<DBC_ATTRIBUTE> *list);
-    bool saveFile(QString);
+    bool saveFile(QString fileName, bool reuseUnchanged = false);
     bool loadFile(QString);
     QString getFullFilename();
     QString getFilename();
@@ -87,6 +142,7 @@ public:
     int getAssocBus();
     void setAssocBus(int bus);
     void setDirtyFlag();
+    void setDirtyFlag(const DBC_MESSAGE *msg);
     bool getDirtyFlag();
     void clearDirtyFlag();
     void sort();
@@ -100,6 +156,23 @@ private:
     int assocBuses; //-1 = all buses, 0 = first bus, 1 = second bus, etc.
     bool isDirty; //has the file been modified?
 
+    //name lookups used while loading a file. Keys are lower case since DBC names are matched without regard to case
+    QHash<QString, int> loadNodeIndex;
+    int loadNodesIndexed;
+    QHash<QPair<DBC_MESSAGE *, QString>, DBC_SIGNAL *> loadSignalIndex;
+
+    //what saveFile wrote for a message last time, one piece per section of the file
+    struct SavedMessageText
+    {
+        QByteArray definition;      //BO_ line and its SG_ lines
+        QByteArray comments;
+        QByteArray attributeValues;
+        QByteArray valueTables;
+        QByteArray extMultiplexing;
+        bool hasExtendedMultiplexing;
+    };
+    QHash<const DBC_MESSAGE *, SavedMessageText> savedMessages;
+
     bool parseAttribute(QString inpString, DBC_ATTRIBUTE &attr);
     QVariant processAttributeVal(QString input, DBC_ATTRIBUTE_VAL_TYPE typ);
     DBC_SIGNAL* parseSignalLine(QString line, DBC_MESSAGE *msg);
@@ -108,8 +181,13 @@ private:
     bool parseValueLine(QString line);
     bool parseAttributeLine(QString line);
     bool parseDefaultAttrLine(QString line);
+    DBC_NODE* findNodeForLoad(const QString &name);
+    DBC_SIGNAL* findSignalForLoad(DBC_MESSAGE *msg, const QString &name);
+    void renderMessage(DBC_MESSAGE *msg, SavedMessageText &out, int &msgNumber, int &sigNumber);
 };
 
+class DBCSnapshot;
+
 class DBCHandler: public QObject
 {
     Q_OBJECT
@@ -133,9 +211,17 @@ public:
     DBCFile* loadJSONFile(QString);
     DBCFile* loadSecretCSVFile(QString);
     static DBCHandler *getReference();
+    static void invalidateLookup();
+    QSharedPointer<const DBCSnapshot> getSnapshot();
 
 private:
     QList<DBCFile> loadedFiles;
+    QHash<quint64, DBC_MESSAGE*> frameLookup; //(bus, id) -> message, misses are cached too
+    int frameLookupGeneration;
+    QSharedPointer<const DBCSnapshot> currentSnapshot;
+    int snapshotLookupGeneration;
+    int snapshotEditGeneration;
+    int snapshotVersion;
 
     DBCHandler();
     static DBCHandler *instance;
@@ -79,6 +79,7 @@ DBCNodeRebaseEditor::DBCNodeRebaseEditor(QWidget *parent) :
                 messagesForNode[i]->ID += rebaseDiff;
                 emit updatedTreeInfo(messagesForNode[i]);
             }
+            dbcFile->messageHandler->invalidateIndex();
 
             dbcFile->setDirtyFlag();
 
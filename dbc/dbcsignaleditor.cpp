@@ -51,7 +51,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal == nullptr) return;
                 if (currentSignal->intelByteOrder != ui->cbIntelFormat->isChecked())
                 {
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     pushToUndoBuffer();
                     currentSignal->intelByteOrder = ui->cbIntelFormat->isChecked();
                     //fillSignalForm(currentSignal);
@@ -68,7 +68,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 DBC_NODE *node = dbcFile->findNodeByName(ui->comboReceiver->currentText());
                 if (currentSignal->receiver != node)
                 {
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     pushToUndoBuffer();
                     currentSignal->receiver = node;
                 }
@@ -84,7 +84,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     {
                         pushToUndoBuffer();
                         currentSignal->valType = UNSIGNED_INT;
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         fillSignalForm(currentSignal);
                     }
                     break;
@@ -93,7 +93,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     {
                         pushToUndoBuffer();
                         currentSignal->valType = SIGNED_INT;
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         fillSignalForm(currentSignal);
                     }
                     break;
@@ -102,7 +102,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     {
                         pushToUndoBuffer();
                         currentSignal->valType = SP_FLOAT;
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         if (dbcMessage) //if we have a good msg reference we can use it to get the # of bytes expected.
                         {
                             int maxBit = ((dbcMessage->len * 8) - 32 + 7);
@@ -119,7 +119,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     {
                         pushToUndoBuffer();
                         currentSignal->valType = DP_FLOAT;
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         if (dbcMessage)
                         {
                             int maxBit = ((dbcMessage->len * 8) - 64 + 7);
@@ -135,7 +135,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     {
                         pushToUndoBuffer();
                         currentSignal->valType = STRING;
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         fillSignalForm(currentSignal);
                     }
                     break;
@@ -153,7 +153,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     if (currentSignal->bias != temp)
                     {
                         pushToUndoBuffer();
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         currentSignal->bias = temp;
                     }
                 }
@@ -171,7 +171,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     if (currentSignal->max != temp)
                     {
                         pushToUndoBuffer();
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         currentSignal->max = temp;
                     }
                 }
@@ -189,7 +189,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     if (currentSignal->min != temp)
                     {
                         pushToUndoBuffer();
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         currentSignal->min = temp;
                     }
                 }
@@ -207,7 +207,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                     if (currentSignal->factor != temp)
                     {
                         pushToUndoBuffer();
-                        dbcFile->setDirtyFlag();
+                        dbcFile->setDirtyFlag(dbcMessage);
                         currentSignal->factor = temp;
                     }
                 }
@@ -220,7 +220,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->comment != ui->txtComment->text().simplified().replace(' ','_'))
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->comment = ui->txtComment->text().simplified().replace(' ', '_');
                     emit updatedTreeInfo(currentSignal);
                 }
@@ -233,7 +233,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->unitName != ui->txtUnitName->text().simplified().replace(' ','_'))
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->unitName = ui->txtUnitName->text().simplified().replace(' ', '_');
                 }
             });
@@ -257,7 +257,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->signalSize != temp)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->signalSize = temp;
                     //fillSignalForm(currentSignal);
                     refreshBitGrid();
@@ -273,7 +273,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->name != tempNameStr)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->name = tempNameStr;
                     refreshBitGrid();
                     //need to update the tree too.
@@ -290,7 +290,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->multiplexLowValue != temp)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     //TODO: could look up the multiplexor and ensure that the value is within a range that the multiplexor could return
                     currentSignal->multiplexLowValue = temp;
                 }
@@ -305,7 +305,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->multiplexHighValue != temp)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     //TODO: could look up the multiplexor and ensure that the value is within a range that the multiplexor could return
                     currentSignal->multiplexHighValue = temp;
                 }
@@ -321,7 +321,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (!currentSignal->isMultiplexed || !currentSignal->isMultiplexor)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->isMultiplexed = true;
                     currentSignal->isMultiplexor = true;
                     //an extended multi signal cannot be the root multiplexor for a message so make sure to remove it if it was.
@@ -343,7 +343,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (!currentSignal->isMultiplexed || currentSignal->isMultiplexor)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->isMultiplexed = true;
                     currentSignal->isMultiplexor = false;
                     //if the set multiplexor for the message was this signal then clear it
@@ -364,7 +364,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->isMultiplexed || !currentSignal->isMultiplexor)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->isMultiplexed = false;
                     currentSignal->isMultiplexor = true;
                     //we just set that this is the multiplexor so update the message to show that as well.
@@ -385,7 +385,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (currentSignal->isMultiplexed || currentSignal->isMultiplexor)
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     currentSignal->isMultiplexed = false;
                     currentSignal->isMultiplexor = false;
                     if (dbcMessage->multiplexorSignal == currentSignal) dbcMessage->multiplexorSignal = nullptr;
@@ -410,7 +410,7 @@ DBCSignalEditor::DBCSignalEditor(QWidget *parent) :
                 if (newSig && oldParent && (newSig != oldParent))
                 {
                     pushToUndoBuffer();
-                    dbcFile->setDirtyFlag();
+                    dbcFile->setDirtyFlag(dbcMessage);
                     oldParent->multiplexedChildren.removeOne(currentSignal);
                     currentSignal->multiplexParent = newSig;
                     newSig->multiplexedChildren.append(currentSignal);
@@ -526,6 +526,7 @@ void DBCSignalEditor::onValuesCellChanged(int row,int col)
         newVal.value = 0;
         newVal.descript = "No Description";
         currentSignal->valList.append(newVal);
+        dbcFile->setDirtyFlag(dbcMessage);
         qDebug() << "Created new entry in value list";
 
         //QTableWidgetItem *widgetVal = new QTableWidgetItem(QString::number(newVal.value));
@@ -540,10 +541,12 @@ void DBCSignalEditor::onValuesCellChanged(int row,int col)
     if (col == 0)
     {
         currentSignal->valList[row].value = Utility::ParseStringToNum(ui->valuesTable->item(row, col)->text());
+        dbcFile->setDirtyFlag(dbcMessage);
     }
     else if (col == 1)
     {
         currentSignal->valList[row].descript = ui->valuesTable->item(row, col)->text().simplified().replace(' ', '_');
+        dbcFile->setDirtyFlag(dbcMessage);
     }
 }
 
@@ -564,6 +567,7 @@ void DBCSignalEditor::deleteCurrentValue()
     {
         ui->valuesTable->removeRow(currIdx);
         currentSignal->valList.removeAt(currIdx);
+        dbcFile->setDirtyFlag(dbcMessage);
     }
 }
 
@@ -892,6 +896,7 @@ void DBCSignalEditor::pushToUndoBuffer()
     //store a copy of the pointer so that if we need to pop we can pop to the proper place
     currentSignal->self = currentSignal;
     undoBuffer.append(*currentSignal); //save the whole thing
+    dbcFile->setDirtyFlag(dbcMessage); //everything which pushes is about to change the signal
     qDebug() << "Pushing to undo buffer";
 }
 
@@ -909,6 +914,7 @@ void DBCSignalEditor::popFromUndoBuffer()
     undoBuffer.pop_back();
     currentSignal = sig.self; //restore the pointer
     *currentSignal = sig; //write the contents into the memory pointed to
+    dbcFile->setDirtyFlag(dbcMessage);
 
     fillSignalForm(currentSignal);
     fillValueTable(currentSignal);
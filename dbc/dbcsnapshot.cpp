@@ -0,0 +1,114 @@
+#include "dbcsnapshot.h"
+
+DBCSnapshot::DBCSnapshot()
+{
+    version = 0;
+}
+
+DBCSnapshot::~DBCSnapshot()
+{
+    //the messages in here got their own signal handlers when they were copied so those have to go too
+    for (int f = 0; f < files.count(); f++)
+    {
+        DBCMessageHandler *handler = files[f].messageHandler;
+        for (int m = 0; m < handler->getCount(); m++) delete handler->findMsgByIdx(m)->sigHandler;
+        delete handler;
+    }
+}
+
+//Deep copy of one live file. Every pointer between nodes, messages and signals is pointed at the copies.
+void DBCSnapshot::copyFile(DBCFile &liveFile)
+{
+    //filled in where it sits in the list so the node pointers handed out below never move
+    files.append(SnapshotFile());
+    SnapshotFile &file = files.last();
+    file.assocBus = liveFile.getAssocBus();
+    file.nodes = liveFile.dbc_nodes;
+    file.nodes.detach();
+
+    QHash<const DBC_NODE *, DBC_NODE *> nodeMap;
+    for (int n = 0; n < liveFile.dbc_nodes.count(); n++) nodeMap.insert(&liveFile.dbc_nodes.at(n), &file.nodes[n]);
+
+    DBCMessageHandler *liveMessages = liveFile.messageHandler;
+    file.messageHandler = new DBCMessageHandler;
+    file.messageHandler->setMatchingCriteria(liveMessages->getMatchingCriteria());
+    file.messageHandler->setFilterLabeling(liveMessages->filterLabeling());
+    for (int m = 0; m < liveMessages->getCount(); m++) file.messageHandler->addMessage(*liveMessages->findMsgByIdx(m));
+
+    for (int m = 0; m < liveMessages->getCount(); m++)
+    {
+        DBC_MESSAGE *liveMsg = liveMessages->findMsgByIdx(m);
+        DBC_MESSAGE *msg = file.messageHandler->findMsgByIdx(m);
+        messageMap.insert(liveMsg, msg);
+        msg->sender = nodeMap.value(liveMsg->sender, nullptr);
+
+        //the copy still shares the signal handler of the live message, give it one of its own
+        QHash<const DBC_SIGNAL *, DBC_SIGNAL *> sigMap;
+        msg->sigHandler = new DBCSignalHandler;
+        for (int s = 0; s < liveMsg->sigHandler->getCount(); s++)
+        {
+            DBC_SIGNAL *liveSig = liveMsg->sigHandler->findSignalByIdx(s);
+            msg->sigHandler->addSignal(*liveSig);
+            sigMap.insert(liveSig, msg->sigHandler->findSignalByIdx(s));
+        }
+
+        for (int s = 0; s < msg->sigHandler->getCount(); s++)
+        {
+            DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(s);
+            sig->parentMessage = msg;
+            sig->self = sig;
+            sig->receiver = nodeMap.value(sig->receiver, nullptr);
+            sig->multiplexParent = sigMap.value(sig->multiplexParent, nullptr);
+            for (int c = 0; c < sig->multiplexedChildren.count(); c++)
+                sig->multiplexedChildren[c] = sigMap.value(sig->multiplexedChildren[c], nullptr);
+            sig->multiplexedChildren.removeAll(nullptr);
+        }
+        msg->multiplexorSignal = sigMap.value(liveMsg->multiplexorSignal, nullptr);
+
+        for (QHash<const DBC_SIGNAL *, DBC_SIGNAL *>::const_iterator it = sigMap.constBegin(); it != sigMap.constEnd(); ++it)
+            signalMap.insert(it.key(), it.value());
+
+        msg->sigHandler->freeze();
+    }
+    file.messageHandler->freeze();
+}
+
+int DBCSnapshot::getVersion() const
+{
+    return version;
+}
+
+int DBCSnapshot::getFileCount() const
+{
+    return files.count();
+}
+
+DBCMessageHandler *DBCSnapshot::getMessageHandler(int fileIdx) const
+{
+    if (fileIdx < 0 || fileIdx >= files.count()) return nullptr;
+    return files.at(fileIdx).messageHandler;
+}
+
+const DBC_MESSAGE *DBCSnapshot::findMessage(const CANFrame &frame) const
+{
+    for (int i = 0; i < files.count(); i++)
+    {
+        const SnapshotFile &file = files.at(i);
+        if (file.assocBus == -1 || frame.bus == file.assocBus)
+        {
+            DBC_MESSAGE *msg = file.messageHandler->findMsgByID(frame.frameId());
+            if (msg != nullptr) return msg;
+        }
+    }
+    return nullptr;
+}
+
+const DBC_SIGNAL *DBCSnapshot::findSignal(const DBC_SIGNAL *liveSignal) const
+{
+    return signalMap.value(liveSignal, nullptr);
+}
+
+const DBC_MESSAGE *DBCSnapshot::findMessage(const DBC_MESSAGE *liveMessage) const
+{
+    return messageMap.value(liveMessage, nullptr);
+}
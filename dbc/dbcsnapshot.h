@@ -0,0 +1,51 @@
+#ifndef DBCSNAPSHOT_H
+#define DBCSNAPSHOT_H
+
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include "dbchandler.h"
+
+/*
+ * A frozen copy of every loaded DBC file, made by DBCHandler::getSnapshot(). The editors keep changing the live
+ * files in DBCHandler while any number of threads decode from a snapshot. Nothing in a snapshot changes after it
+ * is built. The message and signal handlers inside it are frozen (see DBCSignalHandler::freeze) so findMessage,
+ * DBCSignalHandler::decodeFrame and the DBC_SIGNAL decode functions only ever read.
+ * Snapshots are shared. DBCHandler hands out the same one until something is edited and only then builds a new one.
+ * Holding on to the QSharedPointer keeps a snapshot alive, and everything it points to valid, for as long as needed.
+ * Treat everything reached through a snapshot as read only even where the types don't enforce it.
+*/
+class DBCSnapshot
+{
+public:
+    ~DBCSnapshot();
+
+    int getVersion() const;
+    int getFileCount() const;
+    DBCMessageHandler *getMessageHandler(int fileIdx) const;
+    //same rules as DBCHandler::findMessage(const CANFrame &)
+    const DBC_MESSAGE *findMessage(const CANFrame &frame) const;
+    //the copy of a live signal or message in this snapshot, nullptr if it didn't exist when the snapshot was taken
+    const DBC_SIGNAL *findSignal(const DBC_SIGNAL *liveSignal) const;
+    const DBC_MESSAGE *findMessage(const DBC_MESSAGE *liveMessage) const;
+
+private:
+    struct SnapshotFile
+    {
+        DBCMessageHandler *messageHandler;
+        QList<DBC_NODE> nodes;
+        int assocBus;
+    };
+
+    QList<SnapshotFile> files;
+    QHash<const DBC_SIGNAL *, const DBC_SIGNAL *> signalMap;
+    QHash<const DBC_MESSAGE *, const DBC_MESSAGE *> messageMap;
+    int version;
+
+    DBCSnapshot();
+    void copyFile(DBCFile &liveFile);
+
+    friend class DBCHandler;
+};
+
+#endif // DBCSNAPSHOT_H
@@ -0,0 +1,205 @@
+#include "signaldecoder.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+
+//frames per chunk handed to each thread
+#define DECODE_CHUNK_FRAMES     16384
+
+//a multiplexor chain deeper than this has to be a loop in a broken DBC file
+#define MAX_MUX_DEPTH           32
+
+struct DecodeChunk
+{
+    int first;
+    int last;
+    QVector<SignalColumn> columns;
+};
+
+SignalDecoder::SignalDecoder(const QList<DBC_SIGNAL *> &sigs)
+{
+    for (int i = 0; i < sigs.count(); i++)
+    {
+        DBC_SIGNAL *sig = sigs[i];
+        SignalPlan plan;
+
+        plan.signal = sig;
+        plan.id = 0;
+        plan.valType = STRING;
+        plan.factor = 1.0;
+        plan.bias = 0.0;
+        plan.neverPresent = true;
+
+        if (sig && sig->parentMessage && sig->valType != STRING)
+        {
+            plan.id = sig->parentMessage->ID;
+            plan.valType = sig->valType;
+            plan.factor = sig->factor;
+            plan.bias = sig->bias;
+            plan.neverPresent = false;
+
+            //floats are read as a 32 or 64 bit unsigned integer and the bits reinterpreted, same as DBC_SIGNAL::decode does
+            if (sig->valType == SP_FLOAT) plan.bits = BitExtractor(sig->startBit, 32, sig->intelByteOrder, false);
+            else if (sig->valType == DP_FLOAT) plan.bits = BitExtractor(sig->startBit, 64, sig->intelByteOrder, false);
+            else plan.bits = sig->layoutExtractor();
+
+            //walk up the multiplex tree collecting the value range each level has to be in. Same rules as isSignalInMessage
+            const DBC_SIGNAL *child = sig;
+            int depth = 0;
+            while (child->isMultiplexed)
+            {
+                const DBC_SIGNAL *parent = child->multiplexParent;
+                if (!parent || !child->parentMessage || !child->parentMessage->multiplexorSignal || ++depth > MAX_MUX_DEPTH)
+                {
+                    plan.neverPresent = true;
+                    break;
+                }
+                MuxCondition cond;
+                cond.bits = parent->layoutExtractor();
+                cond.isInteger = (parent->valType == SIGNED_INT || parent->valType == UNSIGNED_INT);
+                cond.factor = parent->factor;
+                cond.bias = parent->bias;
+                cond.lowValue = child->multiplexLowValue;
+                cond.highValue = child->multiplexHighValue;
+                plan.muxChain.prepend(cond);
+                child = parent;
+            }
+        }
+
+        if (!plan.neverPresent) plansByID[plan.id].append(plans.count());
+        plans.append(plan);
+    }
+}
+
+bool SignalDecoder::decodeFrame(const SignalPlan &plan, const QByteArray &payload, double &value) const
+{
+    const uchar *data = reinterpret_cast<const uchar *>(payload.constData());
+    int length = payload.size();
+
+    for (int m = 0; m < plan.muxChain.count(); m++)
+    {
+        const MuxCondition &cond = plan.muxChain.at(m);
+        if (!cond.isInteger) return false;
+        //integer rounding identical to processAsInt
+        if (!cond.bits.fits(length)) return false;
+        int64_t scaled = static_cast<int64_t>((static_cast<double>(cond.bits.extract(data, length)) * cond.factor) + cond.bias);
+        int32_t muxVal = static_cast<int32_t>(scaled);
+        if (muxVal < cond.lowValue || muxVal > cond.highValue) return false;
+    }
+
+    if (plan.valType == DP_FLOAT ? (length < 8) : !plan.bits.fits(length)) return false;
+
+    int64_t raw = plan.bits.extract(data, length);
+    if (plan.valType == SP_FLOAT)
+    {
+        uint32_t rawBits = static_cast<uint32_t>(raw);
+        float asFloat;
+        memcpy(&asFloat, &rawBits, 4);
+        value = (asFloat * plan.factor) + plan.bias;
+    }
+    else if (plan.valType == DP_FLOAT)
+    {
+        double asDouble;
+        memcpy(&asDouble, &raw, 8);
+        value = (asDouble * plan.factor) + plan.bias;
+    }
+    else value = (static_cast<double>(raw) * plan.factor) + plan.bias;
+    return true;
+}
+
+QVector<SignalColumn> SignalDecoder::decode(const QVector<CANFrame> *frames, int first, int last) const
+{
+    QVector<SignalColumn> output(plans.count());
+    for (int s = 0; s < plans.count(); s++) output[s].signal = plans[s].signal;
+
+    if (!frames || plans.isEmpty()) return output;
+    if (first < 0) first = 0;
+    if (last < 0 || last >= frames->count()) last = frames->count() - 1;
+    if (first > last) return output;
+
+    QVector<DecodeChunk> chunks;
+    for (int start = first; start <= last; start += DECODE_CHUNK_FRAMES)
+    {
+        DecodeChunk chunk;
+        chunk.first = start;
+        chunk.last = qMin(start + DECODE_CHUNK_FRAMES - 1, last);
+        chunks.append(chunk);
+    }
+
+    QtConcurrent::blockingMap(chunks, [this, frames](DecodeChunk &chunk)
+    {
+        chunk.columns.resize(plans.count());
+        for (int i = chunk.first; i <= chunk.last; i++)
+        {
+            const CANFrame &frame = frames->at(i);
+            if (frame.frameType() != QCanBusFrame::DataFrame) continue;
+
+            QHash<uint32_t, QVector<int>>::const_iterator it = plansByID.constFind(frame.frameId());
+            if (it == plansByID.constEnd()) continue;
+
+            const QByteArray payload = frame.payload();
+            const QVector<int> &candidates = it.value();
+            for (int c = 0; c < candidates.count(); c++)
+            {
+                const SignalPlan &plan = plans.at(candidates[c]);
+                double value;
+                if (!decodeFrame(plan, payload, value)) continue;
+
+                SignalColumn &col = chunk.columns[candidates[c]];
+                col.frameIndices.append(i);
+                col.timeStamps.append(frame.timeStamp().microSeconds());
+                col.values.append(value);
+            }
+        }
+    });
+
+    //stitch the chunks back together in frame order
+    for (int s = 0; s < plans.count(); s++)
+    {
+        int total = 0;
+        for (int c = 0; c < chunks.count(); c++) total += chunks[c].columns[s].values.count();
+
+        SignalColumn &col = output[s];
+        col.frameIndices.reserve(total);
+        col.timeStamps.reserve(total);
+        col.values.reserve(total);
+        for (int c = 0; c < chunks.count(); c++)
+        {
+            col.frameIndices += chunks[c].columns[s].frameIndices;
+            col.timeStamps += chunks[c].columns[s].timeStamps;
+            col.values += chunks[c].columns[s].values;
+        }
+    }
+
+    return output;
+}
+
+QVector<int> SignalDecoder::lastFrames(const QVector<CANFrame> *frames) const
+{
+    QVector<int> output(plans.count(), -1);
+    if (!frames) return output;
+
+    int remaining = 0;
+    for (int s = 0; s < plans.count(); s++) if (!plans[s].neverPresent) remaining++;
+
+    for (int i = frames->count() - 1; i >= 0 && remaining > 0; i--)
+    {
+        const CANFrame &frame = frames->at(i);
+        if (frame.frameType() != QCanBusFrame::DataFrame) continue;
+
+        QHash<uint32_t, QVector<int>>::const_iterator it = plansByID.constFind(frame.frameId());
+        if (it == plansByID.constEnd()) continue;
+
+        const QByteArray payload = frame.payload();
+        const QVector<int> &candidates = it.value();
+        for (int c = 0; c < candidates.count(); c++)
+        {
+            if (output[candidates[c]] != -1) continue;
+            double value;
+            if (!decodeFrame(plans.at(candidates[c]), payload, value)) continue;
+            output[candidates[c]] = i;
+            remaining--;
+        }
+    }
+
+    return output;
+}
@@ -0,0 +1,69 @@
+#ifndef SIGNALDECODER_H
+#define SIGNALDECODER_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "dbc_classes.h"
+#include "can_structs.h"
+
+//Every decoded value of one signal, in frame order. The three vectors are always the same length
+struct SignalColumn
+{
+    DBC_SIGNAL *signal;
+    QVector<int> frameIndices;      //index into the decoded frame list of the frame each value came from
+    QVector<int64_t> timeStamps;    //microseconds, straight from the frames
+    QVector<double> values;         //factor and bias already applied
+};
+
+/*
+ * Decodes a set of signals out of a whole capture (or a range of it) in one pass. Frames are matched to signals by the ID of
+ * the message the signal belongs to. Multiplexed signals only produce values for frames where their multiplexor chain selects
+ * them, extended multiplexing included. Values are computed the same way DBC_SIGNAL::decode computes them.
+ * Everything needed from the signal definitions is copied out when the decoder is constructed so decode() never touches the
+ * DBC_SIGNAL objects themselves. That lets it split the frames into chunks which are decoded in parallel.
+ * Construct the decoder on the thread which owns the DBC data and don't keep it past an edit of the signals.
+*/
+class SignalDecoder
+{
+public:
+    explicit SignalDecoder(const QList<DBC_SIGNAL *> &sigs);
+
+    //decode frames first through last (inclusive). last = -1 means to the end of the list. Columns are in the order
+    //the signals were given to the constructor
+    QVector<SignalColumn> decode(const QVector<CANFrame> *frames, int first = 0, int last = -1) const;
+
+    //index of the last frame in the list each signal has a value in, -1 if there isn't one. Walks the list backwards
+    //and stops as soon as every signal has been found, so it's cheap when only the current values are wanted
+    QVector<int> lastFrames(const QVector<CANFrame> *frames) const;
+
+private:
+    struct MuxCondition
+    {
+        BitExtractor bits;
+        bool isInteger;     //a multiplexor which isn't an integer can never select anything
+        double factor;
+        double bias;
+        int lowValue;
+        int highValue;
+    };
+
+    struct SignalPlan
+    {
+        DBC_SIGNAL *signal;
+        uint32_t id;
+        DBC_SIG_VAL_TYPE valType;
+        BitExtractor bits;
+        double factor;
+        double bias;
+        bool neverPresent;  //broken multiplex definition or a string signal, produces no values
+        QVector<MuxCondition> muxChain; //outermost multiplexor first
+    };
+
+    QVector<SignalPlan> plans;
+    QHash<uint32_t, QVector<int>> plansByID;
+
+    bool decodeFrame(const SignalPlan &plan, const QByteArray &payload, double &value) const;
+};
+
+#endif // SIGNALDECODER_H
@@ -0,0 +1,105 @@
+#include "frameexporter.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include "utils/fastformat.h"
+
+//frames per chunk. Each thread formats one chunk at a time so this bounds the memory used to a few MB per thread
+#define EXPORT_CHUNK_FRAMES     8192
+
+struct ExportChunk
+{
+    int first;
+    int last;
+    int used;
+    QByteArray buffer;
+};
+
+bool FrameExporter::exportFrames(QString filename, const QVector<CANFrame> *frames, const FrameExportFormat &format,
+                                 QIODevice::OpenMode mode)
+{
+    QFile outFile(filename);
+    bool result = true;
+
+    if (!outFile.open(mode)) return false;
+
+    if (!format.header.isEmpty()) outFile.write(format.header);
+
+    int numFrames = frames->count();
+    int numChunks = qMax(1, QThread::idealThreadCount()) * 2; //a few extra so a slow chunk doesn't leave cores idle
+    QVector<ExportChunk> chunks(numChunks);
+
+    //work through the frames in waves of numChunks chunks. The buffers are reused from one wave to the next
+    for (int waveStart = 0; waveStart < numFrames && result; waveStart += numChunks * EXPORT_CHUNK_FRAMES)
+    {
+        int active = 0;
+        for (int c = 0; c < numChunks; c++)
+        {
+            int first = waveStart + (c * EXPORT_CHUNK_FRAMES);
+            if (first >= numFrames) break;
+            chunks[c].first = first;
+            chunks[c].last = qMin(first + EXPORT_CHUNK_FRAMES, numFrames);
+            chunks[c].used = 0;
+            active++;
+        }
+
+        QtConcurrent::blockingMap(chunks.begin(), chunks.begin() + active, [frames, &format](ExportChunk &chunk)
+        {
+            int needed = 0;
+            for (int i = chunk.first; i < chunk.last; i++)
+            {
+                needed += format.lineOverhead + (frames->at(i).payload().size() * format.charsPerDataByte);
+            }
+            if (chunk.buffer.size() < needed) chunk.buffer.resize(needed);
+
+            char *start = chunk.buffer.data();
+            char *p = start;
+            for (int i = chunk.first; i < chunk.last; i++)
+            {
+                p = format.formatLine(p, frames->at(i), i);
+            }
+            chunk.used = static_cast<int>(p - start);
+        });
+
+        for (int c = 0; c < active; c++)
+        {
+            if (outFile.write(chunks[c].buffer.constData(), chunks[c].used) != chunks[c].used) result = false;
+        }
+
+        QCoreApplication::processEvents(); //keeps the progress dialog moving, once per wave is plenty
+    }
+
+    outFile.close();
+    return result;
+}
+
+//Time Stamp,ID,Extended,Dir,Bus,LEN,D1,D2,D3,D4,D5,D6,D7,D8
+char *FrameExporter::formatNativeCSVLine(char *out, const CANFrame &frame)
+{
+    const QByteArray payload = frame.payload();
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+    int dataLen = payload.count();
+
+    out = FastFormat::decSigned(out, frame.timeStamp().microSeconds());
+    *out++ = ',';
+    out = FastFormat::hex(out, frame.frameId(), 8);
+    *out++ = ',';
+    if (frame.hasExtendedFrameFormat()) out = FastFormat::str(out, "true,", 5);
+    else out = FastFormat::str(out, "false,", 6);
+    if (frame.isReceived) out = FastFormat::str(out, "Rx,", 3);
+    else out = FastFormat::str(out, "Tx,", 3);
+    out = FastFormat::decSigned(out, frame.bus);
+    *out++ = ',';
+    out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
+    *out++ = ',';
+    for (int temp = 0; temp < 8; temp++)
+    {
+        if (temp < dataLen) out = FastFormat::hexByte(out, data[temp]);
+        else out = FastFormat::str(out, "00", 2);
+        *out++ = ',';
+    }
+    *out++ = '\n';
+    return out;
+}
@@ -0,0 +1,38 @@
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include <functional>
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+#include "can_structs.h"
+
+//Describes one output format for FrameExporter
+struct FrameExportFormat
+{
+    QByteArray header;      //written once before any frames
+    int lineOverhead;       //the most characters one frame can produce, not counting its data bytes
+    int charsPerDataByte;   //the most characters each data byte can add on top of that
+
+    //writes frame number "index" starting at out and returns a pointer just past the last character written.
+    //This is called from several threads at once so it must not touch anything but its arguments and captured constants
+    std::function<char *(char *out, const CANFrame &frame, int index)> formatLine;
+};
+
+/*
+ * Shared back end for the savers in FrameFileIO. The frames are split into chunks which are formatted in parallel, each into
+ * its own preallocated buffer, and the chunks are then written to the file in order with one write apiece. Each format only
+ * has to supply a header and a function that turns one frame into one line (usually with the FastFormat helpers).
+*/
+class FrameExporter
+{
+public:
+    static bool exportFrames(QString filename, const QVector<CANFrame> *frames, const FrameExportFormat &format,
+                             QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Text);
+
+    //one line of the GVRET native CSV format. Shared by saveNativeCSVFile and the continuous logger
+    static char *formatNativeCSVLine(char *out, const CANFrame &frame);
+};
+
+#endif // FRAMEEXPORTER_H
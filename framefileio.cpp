@@ -8,12 +8,12 @@
 #include <QSettings>
 #include <iostream>
 #include <memory>
-#include "pcaplite.h"
 
 #include "utility.h"
 #include "blfhandler.h"
-
-QFile FrameFileIO::continuousFile;
+#include "pcaphandler.h"
+#include "frameexporter.h"
+#include "utils/fastformat.h"
 
 struct TeslaAPCANRecord
 {
@@ -28,10 +28,105 @@ struct TeslaAPCANRecord
     #pragma pack(pop)
 };
 
+const FrameLoadFilter *FrameFileIO::activeLoadFilter = nullptr;
+bool FrameFileIO::loadFilterSawFirst = false;
+uint64_t FrameFileIO::loadFilterFirstTime = 0;
+int FrameFileIO::loadFilterDecimationCount = 0;
+
+FrameLoadFilter::FrameLoadFilter()
+{
+    useTimeWindow = false;
+    windowStart = 0;
+    windowEnd = 0;
+    idMask = 0;
+    idMatch = 0;
+    decimation = 1;
+}
+
+bool FrameLoadFilter::isActive() const
+{
+    return useTimeWindow || !ids.isEmpty() || !idRanges.isEmpty() || (idMask != 0) || !buses.isEmpty() || (decimation > 1);
+}
+
 FrameFileIO::FrameFileIO()
 {
 }
 
+void FrameFileIO::beginLoadFilter(const FrameLoadFilter *filter)
+{
+    activeLoadFilter = (filter && filter->isActive()) ? filter : nullptr;
+    resetLoadFilterState();
+}
+
+//time window base and decimation phase start over, as if no frame had been looked at yet
+void FrameFileIO::resetLoadFilterState()
+{
+    loadFilterSawFirst = false;
+    loadFilterFirstTime = 0;
+    loadFilterDecimationCount = 0;
+}
+
+//autoDetect tries one loader after another. One that gave up halfway may have loaded some frames and moved the
+//load filter along already, neither of which must carry over to the next loader
+void FrameFileIO::prepareLoadAttempt(QVector<CANFrame>* frames, int startCount)
+{
+    resetLoadFilterState();
+    if (frames->count() > startCount) frames->resize(startCount);
+}
+
+void FrameFileIO::endLoadFilter()
+{
+    activeLoadFilter = nullptr;
+}
+
+bool FrameFileIO::passesLoadFilter(uint64_t timeStamp, uint32_t id, int bus)
+{
+    const FrameLoadFilter *filter = activeLoadFilter;
+    if (!filter) return true;
+
+    //the time window is relative to the first frame in the file, whether or not that frame is kept
+    if (!loadFilterSawFirst)
+    {
+        loadFilterSawFirst = true;
+        loadFilterFirstTime = timeStamp;
+    }
+
+    if (filter->useTimeWindow)
+    {
+        int64_t offset = static_cast<int64_t>(timeStamp - loadFilterFirstTime);
+        if (offset < filter->windowStart || offset > filter->windowEnd) return false;
+    }
+
+    if (!filter->buses.isEmpty() && !filter->buses.contains(bus)) return false;
+
+    if ((id & filter->idMask) != filter->idMatch) return false;
+
+    if (!filter->ids.isEmpty() || !filter->idRanges.isEmpty())
+    {
+        bool found = filter->ids.contains(id);
+        for (int i = 0; !found && i < filter->idRanges.count(); i++)
+        {
+            if (id >= filter->idRanges[i].first && id <= filter->idRanges[i].second) found = true;
+        }
+        if (!found) return false;
+    }
+
+    if (filter->decimation > 1)
+    {
+        bool keep = (loadFilterDecimationCount == 0);
+        if (++loadFilterDecimationCount >= filter->decimation) loadFilterDecimationCount = 0;
+        return keep;
+    }
+
+    return true;
+}
+
+bool FrameFileIO::passesLoadFilter(const CANFrame &frame)
+{
+    if (!activeLoadFilter) return true;
+    return passesLoadFilter(static_cast<uint64_t>(frame.timeStamp().microSeconds()), frame.frameId(), frame.bus);
+}
+
 bool FrameFileIO::saveFrameFile(QString &fileName, const QVector<CANFrame>* frameCache)
 {
     QString filename;
@@ -53,6 +148,8 @@ bool FrameFileIO::saveFrameFile(QString &fileName, const QVector<CANFrame>* fram
     filters.append(QString(tr("Cabana Log (*.csv *.CSV)")));
     filters.append(QString(tr("CANalyzer Ascii Log (*.asc *.ASC)")));
     filters.append(QString(tr("CARBUS Analyzer (*.trc *.TRC)")));
+    filters.append(QString(tr("Wireshark pcapng (*.pcapng *.PCAPNG)")));
+    filters.append(QString(tr("Wireshark pcap (*.pcap *.PCAP)")));
 
     dialog.setDirectory(settings.value("FileIO/LoadSaveDirectory", dialog.directory().path()).toString());
     dialog.setFileMode(QFileDialog::AnyFile);
@@ -143,6 +240,16 @@ bool FrameFileIO::saveFrameFile(QString &fileName, const QVector<CANFrame>* fram
             if (!filename.contains('.')) filename += ".trc";
             result = saveCARBUSAnalzyer(filename, frameCache);
         }
+        if (dialog.selectedNameFilter() == filters[13])
+        {
+            if (!filename.contains('.')) filename += ".pcapng";
+            result = saveWiresharkFile(filename, frameCache, true);
+        }
+        if (dialog.selectedNameFilter() == filters[14])
+        {
+            if (!filename.contains('.')) filename += ".pcap";
+            result = saveWiresharkFile(filename, frameCache, false);
+        }
 
         progress.cancel();
 
@@ -158,7 +265,7 @@ bool FrameFileIO::saveFrameFile(QString &fileName, const QVector<CANFrame>* fram
     return false;
 }
 
-bool FrameFileIO::loadFrameFile(QString &fileName, QVector<CANFrame>* frameCache)
+bool FrameFileIO::loadFrameFile(QString &fileName, QVector<CANFrame>* frameCache, const FrameLoadFilter *filter)
 {
     QString filename;
     QFileDialog dialog;
@@ -191,6 +298,7 @@ bool FrameFileIO::loadFrameFile(QString &fileName, QVector<CANFrame>* frameCache
     filters.append(QString(tr("CLX000 (*.txt *.TXT)")));
     filters.append(QString(tr("CANServer Binary Log (*.log *.LOG)")));
     filters.append(QString(tr("Wireshark (*.pcap *.PCAP *.pcapng *.PCAPNG)")));
+    filters.append(QString(tr("SavvyCAN Binary Log (*.svcl *.SVCL)")));
 
     dialog.setDirectory(settings.value("FileIO/LoadSaveDirectory", dialog.directory().path()).toString());
     dialog.setFileMode(QFileDialog::ExistingFile);
@@ -212,7 +320,9 @@ bool FrameFileIO::loadFrameFile(QString &fileName, QVector<CANFrame>* frameCache
 
         qApp->processEvents();
 
-        if (selectedNameFilter == filters[0]) result = autoDetectLoadFile(filename, frameCache);
+        beginLoadFilter(filter);
+
+        if (selectedNameFilter == filters[0]) result = autoDetect(filename, frameCache);
         if (selectedNameFilter == filters[1]) result = loadNativeCSVFile(filename, frameCache);
         if (selectedNameFilter == filters[2]) result = loadCRTDFile(filename, frameCache);
         if (selectedNameFilter == filters[3]) result = loadLogFile(filename, frameCache);
@@ -237,7 +347,9 @@ bool FrameFileIO::loadFrameFile(QString &fileName, QVector<CANFrame>* frameCache
         if (selectedNameFilter == filters[22]) result = loadCLX000File(filename, frameCache);
         if (selectedNameFilter == filters[23]) result = loadCANServerFile(filename, frameCache);
         if (selectedNameFilter == filters[24]) result = loadWiresharkFile(filename, frameCache);
+        if (selectedNameFilter == filters[25]) result = loadSavvyBinaryFile(filename, frameCache);
 
+        endLoadFilter();
 
         progress.cancel();
 
@@ -266,11 +378,22 @@ bool FrameFileIO::loadFrameFile(QString &fileName, QVector<CANFrame>* frameCache
 //Try every format by first using the "is" functions which try to detect whether a given file is a good match to that
 //file format or not. Those functions are much less tolerant than the load functions and so should help to discriminate
 //whether a file could be loaded or not by a given loader. The loader return is still used in case the guess was wrong.
-bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames)
+bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames, const FrameLoadFilter *filter)
+{
+    beginLoadFilter(filter);
+    bool result = autoDetect(filename, frames);
+    endLoadFilter();
+    return result;
+}
+
+bool FrameFileIO::autoDetect(QString filename, QVector<CANFrame>* frames)
 {
+    int startCount = frames->count();
+
     qDebug() << "Attempting Canalyzer BLF";
     if (isCanalyzerBLF(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCanalyzerBLF(filename, frames))
         {
             qDebug() << "Loaded as Canalyzer BLF successfully!";
@@ -278,9 +401,21 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
         }
     }
 
+    qDebug() << "Attempting SavvyCAN binary log";
+    if (isSavvyBinaryFile(filename))
+    {
+        prepareLoadAttempt(frames, startCount);
+        if (loadSavvyBinaryFile(filename, frames))
+        {
+            qDebug() << "Loaded as SavvyCAN binary log successfully!";
+            return true;
+        }
+    }
+
     qDebug() << "Attempting native CSV";
     if (isNativeCSVFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadNativeCSVFile(filename, frames))
         {
             qDebug() << "Loaded as native CSV successfully!";
@@ -291,6 +426,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting Tesla AP Snapshot";
     if (isTeslaAPFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadTeslaAPFile(filename, frames))
         {
             qDebug() << "Loaded as Tesla AP Snapshot successfully!";
@@ -301,6 +437,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting CANServer Binary Log";
     if (isCANServerFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCANServerFile(filename, frames))
         {
             qDebug() << "Loaded as CANServer Binary Log successfully!";
@@ -311,6 +448,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting Wireshark Log";
     if (isWiresharkFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadWiresharkFile(filename, frames))
         {
             qDebug() << "Loaded as Wireshark Log successfully!";
@@ -321,6 +459,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting canalyzer ASC";
     if (isCanalyzerASC(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCanalyzerASC(filename, frames))
         {
             qDebug() << "Loaded as Canalyzer ASC successfully!";
@@ -331,6 +470,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting CRTD";
     if (isCRTDFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCRTDFile(filename, frames))
         {
             qDebug() << "Loaded as CRTD successfully!";
@@ -342,6 +482,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting trace file";
     if (isTraceFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadTraceFile(filename, frames))
         {
             qDebug() << "Loaded as trace successfully!";
@@ -352,6 +493,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting vehicle spy";
     if (isVehicleSpyFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadVehicleSpyFile(filename, frames))
         {
             qDebug() << "Loaded as vehicle spy successfully!";
@@ -362,6 +504,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting candump";
     if (isCanDumpFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCanDumpFile(filename, frames))
         {
             qDebug() << "Loaded as candump successfully!";
@@ -372,6 +515,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting 'CARBUS Analyzer'";
     if (isCARBUSAnalyzerFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCARBUSAnalyzerFile(filename, frames))
         {
             qDebug() << "Loaded as 'CARBUS Analyzer' successfully!";
@@ -382,6 +526,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting canhacker";
     if (isCANHackerFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCANHackerFile(filename, frames))
         {
             qDebug() << "Loaded as CANHacker successfully!";
@@ -392,6 +537,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting cabana";
     if (isCabanaFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCabanaFile(filename, frames))
         {
             qDebug() << "Loaded as Cabana successfully!";
@@ -402,6 +548,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting canopen";
     if (isCANOpenFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCANOpenFile(filename, frames))
         {
             qDebug() << "Loaded as CANOpen Magic successfully!";
@@ -412,6 +559,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting busmaster log";
     if (isLogFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadLogFile(filename, frames))
         {
             qDebug() << "Loaded as Busmaster Log successfully!";
@@ -422,6 +570,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting pcan";
     if (isPCANFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadPCANFile(filename, frames))
         {
             qDebug() << "Loaded as PCAN successfully!";
@@ -432,6 +581,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting ixxat";
     if (isIXXATFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadIXXATFile(filename, frames))
         {
             qDebug() << "Loaded as IXXAT successfully!";
@@ -442,6 +592,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting microchip";
     if (isMicrochipFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadMicrochipFile(filename, frames))
         {
             qDebug() << "Loaded as microchip successfully!";
@@ -452,6 +603,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting CANDo";
     if (isCANDOFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCANDOFile(filename, frames))
         {
             qDebug() << "Loaded as CANDO successfully!";
@@ -462,11 +614,13 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting kvaser";
     if (isKvaserFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadKvaserFile(filename, frames,true))
         {
             qDebug() << "Loaded as Kvaser HEX successfully!";
             return true;
         }
+        prepareLoadAttempt(frames, startCount);
         if (loadKvaserFile(filename, frames,false))
         {
             qDebug() << "Loaded as KVaser Decimal successfully!";
@@ -477,6 +631,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting CLX000";
     if (isCLX000File(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadCLX000File(filename, frames))
         {
             qDebug() << "Loaded as CLX000 successfully!";
@@ -487,6 +642,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting lawicel";
     if (isLawicelFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadLawicelFile(filename, frames))
         {
             qDebug() << "Loaded as lawicel successfully!";
@@ -497,6 +653,7 @@ bool FrameFileIO::autoDetectLoadFile(QString filename, QVector<CANFrame>* frames
     qDebug() << "Attempting generic CSV";
     if (isGenericCSVFile(filename))
     {
+        prepareLoadAttempt(frames, startCount);
         if (loadGenericCSVFile(filename, frames))
         {
             qDebug() << "Loaded as generic CSV successfully!";
@@ -620,7 +777,7 @@ bool FrameFileIO::loadVehicleSpyFile(QString filename, QVector<CANFrame> *frames
                 else break;
             }
             thisFrame.setPayload(bytes);
-            frames->append(thisFrame);
+            if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
         }
         else foundErrors = true;
     }
@@ -783,7 +940,7 @@ bool FrameFileIO::loadCRTDFile(QString filename, QVector<CANFrame>* frames)
                         else bytes[d] = 0;
                     }
                     thisFrame.setPayload(bytes);
-                    frames->append(thisFrame);
+                    if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                 }
             }
             else foundErrors = true;
@@ -893,7 +1050,7 @@ bool FrameFileIO::loadCARBUSAnalyzerFile(QString filename, QVector<CANFrame>* fr
                     else bytes[d] = 0;
                 }
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
             else
             {
@@ -908,15 +1065,7 @@ bool FrameFileIO::loadCARBUSAnalyzerFile(QString filename, QVector<CANFrame>* fr
 
 bool FrameFileIO::saveCARBUSAnalzyer(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-    QTextStream outTextStream(outFile);
-
-    int lineCounter = 0;
+    FrameExportFormat format;
 
     qint64 minTime = frames->at(0).timeStamp().microSeconds();
     qint64 maxTime = minTime;
@@ -938,70 +1087,52 @@ bool FrameFileIO::saveCARBUSAnalzyer(QString filename, const QVector<CANFrame>*
     //
     // "@ TEXT @ 3 @ 64 @ 0 @ 14012 @ 15688 @ 00:00:15.688 @"
     // saving in version format 3 with microseconds in packets time
-    outTextStream << "@ TEXT @ 3 @ 64 @ 0 @ " << frames->count() <<  " @ " << totalTime
-                  <<" @ " << someTime.toString("hh:mm:ss.zzz") <<" @\r";
-
-    const unsigned char *data;
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
+    format.header = "@ TEXT @ 3 @ 64 @ 0 @ " + QByteArray::number(frames->count()) + " @ " + QByteArray::number(totalTime)
+                  + " @ " + someTime.toString("hh:mm:ss.zzz").toUtf8() + " @\r";
+
+    format.lineOverhead = 128;
+    format.charsPerDataByte = 4;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
+
+        uint64_t timeStamp = static_cast<uint64_t>(frame.timeStamp().microSeconds());
+        out = FastFormat::dec(out, timeStamp / 1000000);
+        *out++ = ',';
+        out = FastFormat::dec(out, timeStamp % 1000000);
+        *out++ = '\t';
+        out = FastFormat::decSigned(out, frame.bus); // bus channel
+        out = FastFormat::str(out, "\t0004\t", 6); // it's CAN frame
+        out = FastFormat::hexAtLeast(out, frame.frameId(), 3);
+        *out++ = '\t';
+        out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
+        *out++ = '\t';
+
+        //data bytes separated by spaces, left justified in a 23 character field
+        char *dataStart = out;
+        for (int d = 0; d < dataLen; d++)
         {
-            qApp->processEvents();
-            lineCounter = 0;
+            if (d > 0) *out++ = ' ';
+            out = FastFormat::hexByte(out, data[d]);
         }
-        auto frame = frames->at(c);
-
-        uint64_t timeStamp = frame.timeStamp().microSeconds();
-        QString canId = QString::number(frame.frameId(), 16).toUpper().rightJustified(3, '0').toUtf8();
-        QString canDlc = QString::number(frame.payload().length()).toUtf8();
+        while ((out - dataStart) < 23) *out++ = ' ';
+        out = FastFormat::str(out, "\t00000000\t", 10);
 
-        QString ascii = "";
-        QString finalCanData;
-
-        data = reinterpret_cast<const unsigned char *>(frame.payload().constData());
-        for (int d = 0; d < frame.payload().length(); d++)
+        //printable characters as themselves, everything else as a space. Left justified in an 8 character field
+        for (int d = 0; d < dataLen; d++)
         {
-            auto octet = data[d];
-            finalCanData.append(QString::number(octet, 16).toUpper().rightJustified(2, '0').toUtf8());
-            finalCanData.append(" ");
-
-            QString strCode = QString::number(octet, 16);
-            bool conv;
-            uint symbolCode = strCode.toInt(&conv, 16);
-
-            if ((symbolCode >= 32 && symbolCode < 126)) {
-                QChar localQChar = QChar(symbolCode);
-                if (localQChar.toLatin1() != 0) {
-                   ascii += QString::fromLocal8Bit(QByteArray::fromHex(strCode.toLatin1()));
-              }
-            } else {
-                ascii += " ";
-            }
+            if (data[d] >= 32 && data[d] < 126) *out++ = static_cast<char>(data[d]);
+            else *out++ = ' ';
         }
-        finalCanData = finalCanData.trimmed().leftJustified(23, ' ');
-        ascii = ascii.leftJustified(8, ' ');
-        auto seconds = QString::number(timeStamp / 1000000);
-        auto uSeconds = QString::number(timeStamp % 1000000);
-        QString localArg = "";
-        localArg.append(seconds).append(",").append(uSeconds).append("\t")
-                .append(QString::number(frame.bus)).append("\t") // bus channel
-                .append("0004").append("\t") // it's CAN frame
-                .append(canId).append("\t")
-                .append(canDlc).append("\t")
-                .append(finalCanData).append("\t")
-                .append("00000000").append("\t")
-                .append(ascii).append("\t")
-                .append("\r");
-
-        qDebug() << localArg;
-        outTextStream << localArg;
-    }
-
-    outFile->close();
-    delete outFile;
+        for (int d = dataLen; d < 8; d++) *out++ = ' ';
+        out = FastFormat::str(out, "\t\r", 2);
+        return out;
+    };
 
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isCANHackerFile(QString filename)
@@ -1121,7 +1252,7 @@ bool FrameFileIO::loadCANHackerFile(QString filename, QVector<CANFrame>* frames)
                     else bytes[d] = 0;
                 }
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
             else foundErrors = true;
         }
@@ -1239,7 +1370,7 @@ bool FrameFileIO::loadCANOpenFile(QString filename, QVector<CANFrame>* frames)
                     else bytes[d] = 0;
                 }
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
             else foundErrors = true;
         }
@@ -1251,63 +1382,39 @@ bool FrameFileIO::loadCANOpenFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveCRTDFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    int lineCounter = 0;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
-
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
+    FrameExportFormat format;
 
     //write in float format with 6 digits after the decimal point
-    outFile->write(QString::number(frames->at(0).timeStamp().microSeconds() / 1000000.0, 'f', 6).toUtf8() + tr(" CXX GVRET-PC Reverse Engineering Tool Output V").toUtf8() + QString::number(VERSION).toUtf8());
-    outFile->write("\n");
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        outFile->write(QString::number(frame->timeStamp().microSeconds() / 1000000.0, 'f', 6).toUtf8());
-        outFile->putChar(' ');
-
-        outFile->write(QString::number(frame->bus + 1).toUtf8());
-        if (frame->isReceived) outFile->putChar('R');
-        else outFile->putChar('T');
-
-        if (frame->hasExtendedFrameFormat())
-        {
-            outFile->write("29 ");
-        }
-        else outFile->write("11 ");
-        outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8());
-        outFile->putChar(' ');
-
+    format.header = QString::number(frames->at(0).timeStamp().microSeconds() / 1000000.0, 'f', 6).toUtf8() + tr(" CXX GVRET-PC Reverse Engineering Tool Output V").toUtf8() + QString::number(VERSION).toUtf8();
+    format.header += "\n";
+    format.lineOverhead = 64;
+    format.charsPerDataByte = 3;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
+
+        out = FastFormat::seconds(out, frame.timeStamp().microSeconds());
+        *out++ = ' ';
+        out = FastFormat::decSigned(out, frame.bus + 1);
+        if (frame.isReceived) *out++ = 'R';
+        else *out++ = 'T';
+        if (frame.hasExtendedFrameFormat()) out = FastFormat::str(out, "29 ", 3);
+        else out = FastFormat::str(out, "11 ", 3);
+        out = FastFormat::hex(out, frame.frameId(), 8);
+        *out++ = ' ';
         for (int temp = 0; temp < dataLen; temp++)
         {
-            outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            outFile->putChar(' ');
+            out = FastFormat::hexByte(out, data[temp]);
+            *out++ = ' ';
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-    }
-    outFile->close();
-    delete outFile;
-
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 
@@ -1461,7 +1568,7 @@ bool FrameFileIO::loadPCANFile(QString filename, QVector<CANFrame>* frames)
                             }
                         }
                         thisFrame.setPayload(bytes);
-                        frames->append(thisFrame);
+                        if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                     }
                 }
             }
@@ -1512,7 +1619,7 @@ bool FrameFileIO::loadPCANFile(QString filename, QVector<CANFrame>* frames)
                             }
                         }
                         thisFrame.setPayload(bytes);
-                        frames->append(thisFrame);
+                        if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                     }
                 }
             }
@@ -1554,7 +1661,7 @@ bool FrameFileIO::loadPCANFile(QString filename, QVector<CANFrame>* frames)
                             }
                         }
                         thisFrame.setPayload(bytes);
-                        frames->append(thisFrame);
+                        if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                     }
                 }
             }
@@ -1606,7 +1713,7 @@ bool FrameFileIO::loadPCANFile(QString filename, QVector<CANFrame>* frames)
                             }
                         }
                         thisFrame.setPayload(bytes);
-                        frames->append(thisFrame);
+                        if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                     }
                 }
             }
@@ -1858,7 +1965,7 @@ bool FrameFileIO::loadCanalyzerASC(QString filename, QVector<CANFrame>* frames)
                         }
                         thisFrame.setPayload(bytes);
                     }
-                    frames->append(thisFrame);
+                    if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                 }
             }
         }
@@ -1871,93 +1978,91 @@ bool FrameFileIO::loadCanalyzerASC(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveCanalyzerASC(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    int lineCounter = 0;
+    FrameExportFormat format;
     int64_t offsetTime = frames->at(0).timeStamp().microSeconds();
 
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
-
     for (int c = 0; c < frames->count(); c++)
     {
         if (frames->at(c).timeStamp().microSeconds() < offsetTime) offsetTime = frames->at(c).timeStamp().microSeconds();
     }
 
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-
     QDateTime now;
     now = QDateTime::currentDateTime();
     if (offsetTime > 10000000000) //chances are the input file had times as system time so load it
     {
         now.setMSecsSinceEpoch(offsetTime / 1000); //offsetTime was in microseconds
     }
-    outFile->write("date " + now.toString("ddd MMM dd h:mm:ss.zzz a yyyy").toUtf8());
+    format.header = "date " + now.toString("ddd MMM dd h:mm:ss.zzz a yyyy").toUtf8();
 
-    outFile->write("\nbase hex  timestamps absolute\n");
-    outFile->write("no internal event logging\n");
-    outFile->write("// version 11.0.0\n");
+    format.header += "\nbase hex  timestamps absolute\n";
+    format.header += "no internal event logging\n";
+    format.header += "// version 11.0.0\n";
 
-    for (int c = 0; c < frames->count(); c++)
+    format.lineOverhead = 80;
+    format.charsPerDataByte = 4;
+    format.formatLine = [offsetTime](char *out, const CANFrame &frame, int index)
     {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
 
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        uint64_t timeStamp = (frame->timeStamp().microSeconds() - offsetTime) / 1000000ull;
-        int tsLen = QString::number(timeStamp).length();
-        int precision = 6;
         //vector seems to keep 10 bytes at the start of the line for the timestamp. It should never exceed this
         //and there should never be a precision over 6 digits after the decimal
-        if (tsLen > 3) precision = 9 - tsLen;
-        outFile->write(QString::number((frame->timeStamp().microSeconds() - offsetTime) / 1000000.0, 'f', precision).rightJustified(10, ' ').toUtf8());
-        outFile->putChar(' ');
-        outFile->write(QString::number(frame->bus + 1).toUtf8());
-        outFile->write("  ");
-        if (frames->at(c).hasExtendedFrameFormat())
+        uint64_t relTime = static_cast<uint64_t>(frame.timeStamp().microSeconds() - offsetTime);
+        char stamp[32];
+        int tsLen = static_cast<int>(FastFormat::dec(stamp, relTime / 1000000ull) - stamp);
+        int precision = 6;
+        if (tsLen > 3) precision = qMax(0, 9 - tsLen);
+        uint64_t scale = 1;
+        uint64_t fracDiv = 1;
+        for (int i = precision; i < 6; i++) scale *= 10;
+        for (int i = 0; i < precision; i++) fracDiv *= 10;
+        uint64_t units = (relTime + (scale / 2)) / scale; //rounded to "precision" digits after the decimal point
+        char *p = FastFormat::dec(stamp, units / fracDiv);
+        if (precision > 0)
+        {
+            *p++ = '.';
+            p = FastFormat::decPadded(p, units % fracDiv, precision);
+        }
+        int stampLen = static_cast<int>(p - stamp);
+        for (int pad = stampLen; pad < 10; pad++) *out++ = ' ';
+        out = FastFormat::str(out, stamp, stampLen);
+
+        *out++ = ' ';
+        out = FastFormat::decSigned(out, frame.bus + 1);
+        out = FastFormat::str(out, "  ", 2);
+        if (frame.hasExtendedFrameFormat())
         {
-            outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8());
-            outFile->write("x");
+            out = FastFormat::hex(out, frame.frameId(), 8);
+            *out++ = 'x';
         }
         else
         {
-            outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(3, '0').toUtf8());
-            outFile->write("      ");
+            out = FastFormat::hexAtLeast(out, frame.frameId(), 3);
+            out = FastFormat::str(out, "      ", 6);
         }
-        outFile->write("   ");
+        out = FastFormat::str(out, "   ", 3);
 
-        if (frames->at(c).isReceived) outFile->write("Rx ");
-        else outFile->write("Tx ");
+        if (frame.isReceived) out = FastFormat::str(out, "Rx ", 3);
+        else out = FastFormat::str(out, "Tx ", 3);
 
-        if (frames->at(c).frameType() == QCanBusFrame::RemoteRequestFrame) outFile->write("r ");
-        else outFile->write("d ");
+        if (frame.frameType() == QCanBusFrame::RemoteRequestFrame) out = FastFormat::str(out, "r ", 2);
+        else out = FastFormat::str(out, "d ", 2);
 
-        outFile->write(QString::number(dataLen).toUtf8());
-        outFile->write("  ");
+        out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
+        out = FastFormat::str(out, "  ", 2);
 
         for (int temp = 0; temp < dataLen; temp++)
         {
-            outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            outFile->write("  ");
+            out = FastFormat::hexByte(out, data[temp]);
+            out = FastFormat::str(out, "  ", 2);
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-    }
-    outFile->close();
-    delete outFile;
-
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isCanalyzerBLF(QString filename)
@@ -2093,6 +2198,12 @@ bool FrameFileIO::loadNativeCSVFile(QString filename, QVector<CANFrame>* frames)
                 }
 
                 thisFrame.setFrameId(tokens[1].toUInt(nullptr, 16));
+
+                //skip the rest of the line if the load filter doesn't want this frame
+                int busToken = (fileVersion == 1) ? 3 : 4;
+                if (!passesLoadFilter(static_cast<uint64_t>(thisFrame.timeStamp().microSeconds()), thisFrame.frameId(),
+                                      tokens[busToken].toInt())) continue;
+
                 if (tokens[2].toUpper().contains("TRUE")) thisFrame.setExtendedFrameFormat(true);
                     else thisFrame.setExtendedFrameFormat(false);
 
@@ -2143,78 +2254,29 @@ bool FrameFileIO::loadNativeCSVFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveNativeCSVFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    int lineCounter = 0;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
-
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
+    FrameExportFormat format;
 
-    outFile->write("Time Stamp,ID,Extended,Dir,Bus,LEN,D1,D2,D3,D4,D5,D6,D7,D8");
-    outFile->write("\n");
-
-    for (int c = 0; c < frames->count(); c++)
+    format.header = "Time Stamp,ID,Extended,Dir,Bus,LEN,D1,D2,D3,D4,D5,D6,D7,D8\n";
+    format.lineOverhead = 96; //only ever writes 8 data bytes
+    format.charsPerDataByte = 0;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
     {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        outFile->write(QString::number(frame->timeStamp().microSeconds()).toUtf8());
-        outFile->putChar(44);
-
-        outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8());
-        outFile->putChar(44);
-
-        if (frame->hasExtendedFrameFormat()) outFile->write("true,");
-        else outFile->write("false,");
-
-        if (frame->isReceived) outFile->write("Rx,");
-        else outFile->write("Tx,");
-
-        outFile->write(QString::number(frame->bus).toUtf8());
-        outFile->putChar(44);
-
-        outFile->write(QString::number(dataLen).toUtf8());
-        outFile->putChar(44);
-
-        for (int temp = 0; temp < 8; temp++)
-        {
-            if (temp < dataLen)
-                outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            else
-                outFile->write("00");
-            outFile->putChar(44);
-        }
-
-        outFile->write("\n");
+        Q_UNUSED(index);
+        return FrameExporter::formatNativeCSVLine(out, frame);
+    };
 
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
-bool FrameFileIO::openContinuousNative()
+bool FrameFileIO::pickContinuousLogFile(QString &filename, int &format)
 {
-    QString filename;
     QFileDialog dialog(qApp->activeWindow());
     QSettings settings;
 
     QStringList filters;
     filters.append(QString(tr("GVRET Logs (*.csv *.CSV)")));
+    filters.append(QString(tr("SavvyCAN Binary Log (*.svcl *.SVCL)")));
+    filters.append(QString(tr("SavvyCAN Compressed Binary Log (*.svcl *.SVCL)")));
 
     dialog.setDirectory(settings.value("FileIO/LoadSaveDirectory", dialog.directory().path()).toString());
     dialog.setFileMode(QFileDialog::AnyFile);
@@ -2225,87 +2287,134 @@ bool FrameFileIO::openContinuousNative()
     if (dialog.exec() == QDialog::Accepted)
     {
         filename = dialog.selectedFiles()[0];
-        continuousFile.setFileName(filename);
+        format = CLF_GVRET_CSV;
+        if (dialog.selectedNameFilter() == filters[1]) format = CLF_BINARY;
+        if (dialog.selectedNameFilter() == filters[2]) format = CLF_COMPRESSED;
 
-        if (!continuousFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        if (!filename.contains('.'))
         {
-            return false;
+            if (format == CLF_GVRET_CSV) filename += ".csv";
+            else filename += ".svcl";
         }
-        continuousFile.write("Time Stamp,ID,Extended,Dir,Bus,LEN,D1,D2,D3,D4,D5,D6,D7,D8");
-        continuousFile.write("\n");
         settings.setValue("FileIO/LoadSaveDirectory", dialog.directory().path());
         return true;
     }
     return false;
 }
 
-bool FrameFileIO::closeContinuousNative()
-{
-    if (continuousFile.isOpen())
-    {
-        continuousFile.close();
-        return true;
-    }
-    return false;
-}
-
-bool FrameFileIO::writeContinuousNative(const QVector<CANFrame>* frames, int beginningFrame)
+//See continuouslogger.h for the layout of these files
+bool FrameFileIO::isSavvyBinaryFile(QString filename)
 {
+    QFile inFile(filename);
 
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
+    if (!inFile.open(QIODevice::ReadOnly)) return false;
 
-    if (!continuousFile.isOpen()) return false;
-    qDebug() << "Bgn: " << beginningFrame << "  Count: " << frames->count();
-    for (int c = beginningFrame; c < frames->count(); c++)
-    {
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
+    QByteArray header = inFile.read(SVCLOG_HEADER_SIZE);
+    inFile.close();
 
-        continuousFile.write(QString::number(frame->timeStamp().microSeconds()).toUtf8());
-        continuousFile.putChar(44);
-
-        continuousFile.write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8());
-        continuousFile.putChar(44);
+    if (header.length() < SVCLOG_HEADER_SIZE) return false;
+    if (!header.startsWith(SVCLOG_MAGIC)) return false;
+    if (header.at(6) != SVCLOG_VERSION) return false;
+    return true;
+}
 
-        if (frame->hasExtendedFrameFormat()) continuousFile.write("true,");
-        else continuousFile.write("false,");
+//parses as many whole records as there are in data and reports how many bytes that took
+void FrameFileIO::parseSavvyBinaryRecords(const char *data, int length, int &used, QVector<CANFrame>* frames)
+{
+    CANFrame thisFrame;
+    used = 0;
+
+    while ((length - used) >= SVCLOG_RECORD_HDR_SIZE)
+    {
+        const char *rec = data + used;
+        int dataLen = static_cast<uint8_t>(rec[14]);
+        if ((length - used) < (SVCLOG_RECORD_HDR_SIZE + dataLen)) break;
+
+        used += SVCLOG_RECORD_HDR_SIZE + dataLen;
+        if (!passesLoadFilter(qFromLittleEndian<quint64>(rec), qFromLittleEndian<quint32>(rec + 8),
+                              static_cast<uint8_t>(rec[12]))) continue;
+
+        uint8_t flags = static_cast<uint8_t>(rec[13]);
+        thisFrame.setTimeStamp(QCanBusFrame::TimeStamp(0, qFromLittleEndian<quint64>(rec)));
+        thisFrame.setFrameId(qFromLittleEndian<quint32>(rec + 8));
+        thisFrame.bus = static_cast<uint8_t>(rec[12]);
+        thisFrame.setExtendedFrameFormat(flags & SVCLOG_FLAG_EXTENDED);
+        thisFrame.isReceived = (flags & SVCLOG_FLAG_RECEIVED);
+        thisFrame.setFlexibleDataRateFormat(flags & SVCLOG_FLAG_FD);
+        thisFrame.setBitrateSwitch(flags & SVCLOG_FLAG_BRS);
+        if (flags & SVCLOG_FLAG_REMOTE) thisFrame.setFrameType(QCanBusFrame::RemoteRequestFrame);
+        else if (flags & SVCLOG_FLAG_ERROR) thisFrame.setFrameType(QCanBusFrame::ErrorFrame);
+        else thisFrame.setFrameType(QCanBusFrame::DataFrame);
+        thisFrame.setPayload(QByteArray(rec + SVCLOG_RECORD_HDR_SIZE, dataLen));
+        frames->append(thisFrame);
+    }
+}
 
-        if (frame->isReceived) continuousFile.write("Rx,");
-        else continuousFile.write("Tx,");
+bool FrameFileIO::loadSavvyBinaryFile(QString filename, QVector<CANFrame>* frames)
+{
+    QFile *inFile = new QFile(filename);
+    QByteArray pending;
+    int lineCounter = 0;
+    int used;
+    bool foundErrors = false;
 
-        continuousFile.write(QString::number(frame->bus).toUtf8());
-        continuousFile.putChar(44);
+    if (!inFile->open(QIODevice::ReadOnly))
+    {
+        delete inFile;
+        return false;
+    }
 
-        continuousFile.write(QString::number(dataLen).toUtf8());
-        continuousFile.putChar(44);
+    QByteArray header = inFile->read(SVCLOG_HEADER_SIZE);
+    if (header.length() < SVCLOG_HEADER_SIZE || !header.startsWith(SVCLOG_MAGIC) || header.at(6) != SVCLOG_VERSION)
+    {
+        inFile->close();
+        delete inFile;
+        return false;
+    }
+    bool compressed = (header.at(7) & SVCLOG_FILE_COMPRESSED);
 
-        for (int temp = 0; temp < 8; temp++)
+    //read in large chunks. A record can straddle two chunks so whatever isn't used is carried over to the next one
+    while (!inFile->atEnd())
+    {
+        lineCounter++;
+        if (lineCounter > 4)
         {
-            if (temp < dataLen)
-                continuousFile.write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            else
-                continuousFile.write("00");
-            continuousFile.putChar(44);
+            qApp->processEvents();
+            lineCounter = 0;
         }
 
-        continuousFile.write("\n");
+        if (compressed)
+        {
+            QByteArray lenBytes = inFile->read(4);
+            if (lenBytes.length() < 4)
+            {
+                foundErrors = true;
+                break;
+            }
+            quint32 blockLen = qFromLittleEndian<quint32>(lenBytes.constData());
+            QByteArray block = qUncompress(inFile->read(blockLen));
+            if (block.isEmpty())
+            {
+                foundErrors = true; //truncated or corrupt block, probably the logger didn't get to finish
+                break;
+            }
+            parseSavvyBinaryRecords(block.constData(), block.length(), used, frames);
+            if (used != block.length()) foundErrors = true; //blocks always hold whole records
+        }
+        else
+        {
+            pending.append(inFile->read(4 * 1024 * 1024));
+            parseSavvyBinaryRecords(pending.constData(), pending.length(), used, frames);
+            pending.remove(0, used);
+        }
     }
-    return true;
-}
+    if (!pending.isEmpty()) foundErrors = true;
 
-bool FrameFileIO::flushContinuousNative()
-{
-    if (continuousFile.isOpen())
-    {
-        return continuousFile.flush();
-    }
-    return false;
+    inFile->close();
+    delete inFile;
+    return !foundErrors;
 }
 
-
 bool FrameFileIO::isGenericCSVFile(QString filename)
 {
     QFile *inFile = new QFile(filename);
@@ -2401,7 +2510,7 @@ bool FrameFileIO::loadGenericCSVFile(QString filename, QVector<CANFrame>* frames
                 QByteArray bytes(dLen, 0);
                 for (int d = 0; d < dLen; d++) bytes[d] = static_cast<char>(dataTok[d].toInt(nullptr, 16));
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
         }
         else foundErrors = true;
@@ -2414,50 +2523,30 @@ bool FrameFileIO::loadGenericCSVFile(QString filename, QVector<CANFrame>* frames
 //4f5,ff 34 23 45 24 e4
 bool FrameFileIO::saveGenericCSVFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    int lineCounter = 0;
+    FrameExportFormat format;
 
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
-
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
+    format.header = "ID,Data Bytes\n";
+    format.lineOverhead = 16;
+    format.charsPerDataByte = 3;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
     {
-        delete outFile;
-        return false;
-    }
-
-    outFile->write("ID,Data Bytes");
-    outFile->write("\n");
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8());
-        outFile->putChar(44);
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
 
+        out = FastFormat::hex(out, frame.frameId(), 8);
+        *out++ = ',';
         for (int temp = 0; temp < dataLen; temp++)
         {
-            outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            outFile->putChar(' ');
+            out = FastFormat::hexByte(out, data[temp]);
+            *out++ = ' ';
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isLogFile(QString filename)
@@ -2607,7 +2696,7 @@ bool FrameFileIO::loadLogFile(QString filename, QVector<CANFrame>* frames)
                         bytes[d] = static_cast<char>(tokens[d + 6].toInt(nullptr, 16));
                 }
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
             else foundErrors = true;
         }
@@ -2619,83 +2708,67 @@ bool FrameFileIO::loadLogFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveLogFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    QDateTime timestamp, tempStamp;
-    int lineCounter = 0;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
+    FrameExportFormat format;
+    QDateTime timestamp;
 
     //timestamp = QDateTime::currentDateTime();
 
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-
-    outFile->write("***BUSMASTER Ver 3.2.0***\n");
-    outFile->write("***PROTOCOL CAN***\n");
-    outFile->write("***NOTE: PLEASE DO NOT EDIT THIS DOCUMENT***\n");
-    outFile->write("***[START LOGGING SESSION]***\n");
-    outFile->write("***START DATE AND TIME ");
-    outFile->write(timestamp.toString("d:M:yyyy h:m:s:z").toUtf8());
-    outFile->write("***\n");
-    outFile->write("***HEX***\n");
-    outFile->write("***SYSTEM MODE***\n");
-    outFile->write("***START CHANNEL BAUD RATE***\n");
-    outFile->write("***CHANNEL 1 - Kvaser - Kvaser Leaf Light HS #0 (Channel 0), Serial Number- 0, Firmware- 0x00000037 0x00020000 - 500000 bps***\n");
-    outFile->write("***END CHANNEL BAUD RATE***\n");
-    outFile->write("***START DATABASE FILES***\n");
-    outFile->write("***END OF DATABASE FILES***\n");
-    outFile->write("***<Time><Tx/Rx><Channel><CAN ID><Type><DLC><DataBytes>***\n");
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        tempStamp = QDateTime::fromMSecsSinceEpoch(frame->timeStamp().microSeconds() / 1000);
-        outFile->write(tempStamp.toString("hh:mm:ss:zzz").toUtf8());
-        if (frame->isReceived) outFile->write(" Rx ");
-        else outFile->write(" Tx ");
+    format.header = "***BUSMASTER Ver 3.2.0***\n";
+    format.header += "***PROTOCOL CAN***\n";
+    format.header += "***NOTE: PLEASE DO NOT EDIT THIS DOCUMENT***\n";
+    format.header += "***[START LOGGING SESSION]***\n";
+    format.header += "***START DATE AND TIME ";
+    format.header += timestamp.toString("d:M:yyyy h:m:s:z").toUtf8();
+    format.header += "***\n";
+    format.header += "***HEX***\n";
+    format.header += "***SYSTEM MODE***\n";
+    format.header += "***START CHANNEL BAUD RATE***\n";
+    format.header += "***CHANNEL 1 - Kvaser - Kvaser Leaf Light HS #0 (Channel 0), Serial Number- 0, Firmware- 0x00000037 0x00020000 - 500000 bps***\n";
+    format.header += "***END CHANNEL BAUD RATE***\n";
+    format.header += "***START DATABASE FILES***\n";
+    format.header += "***END OF DATABASE FILES***\n";
+    format.header += "***<Time><Tx/Rx><Channel><CAN ID><Type><DLC><DataBytes>***\n";
+
+    format.lineOverhead = 80;
+    format.charsPerDataByte = 3;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
+
+        //local time so this has to go through QDateTime. Always 12 characters
+        QDateTime tempStamp = QDateTime::fromMSecsSinceEpoch(frame.timeStamp().microSeconds() / 1000);
+        QByteArray stampText = tempStamp.toString("hh:mm:ss:zzz").toUtf8();
+        out = FastFormat::str(out, stampText.constData(), stampText.length());
+        if (frame.isReceived) out = FastFormat::str(out, " Rx ", 4);
+        else out = FastFormat::str(out, " Tx ", 4);
         // busmaster channel start at 1
-        outFile->write(QString::number(frame->bus + 1).toUtf8() + " ");
-        outFile->write("0x");
-        if (frame->hasExtendedFrameFormat() && frame->frameId() > 0x7FF) {
-            outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8());
-        } else {
-            outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(3, '0').toUtf8());
-        }
-        if (frame->hasExtendedFrameFormat()) outFile->write(" x");
-            else outFile->write(" s");
-        if (frame->frameType() == QCanBusFrame::RemoteRequestFrame) outFile->write("r ");
-            else outFile->write(" ");
-        outFile->write(QString::number(dataLen).toUtf8() + " ");
-
-        if (frame->frameType() != QCanBusFrame::RemoteRequestFrame) {
+        out = FastFormat::decSigned(out, frame.bus + 1);
+        out = FastFormat::str(out, " 0x", 3);
+        if (frame.hasExtendedFrameFormat() && frame.frameId() > 0x7FF) out = FastFormat::hex(out, frame.frameId(), 8);
+        else out = FastFormat::hexAtLeast(out, frame.frameId(), 3);
+        if (frame.hasExtendedFrameFormat()) out = FastFormat::str(out, " x", 2);
+        else out = FastFormat::str(out, " s", 2);
+        if (frame.frameType() == QCanBusFrame::RemoteRequestFrame) out = FastFormat::str(out, "r ", 2);
+        else *out++ = ' ';
+        out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
+        *out++ = ' ';
+
+        if (frame.frameType() != QCanBusFrame::RemoteRequestFrame)
+        {
             for (int temp = 0; temp < dataLen; temp++)
             {
-                outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-                outFile->putChar(' ');
+                out = FastFormat::hexByte(out, data[temp]);
+                *out++ = ' ';
             }
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isIXXATFile(QString filename)
@@ -2804,7 +2877,7 @@ bool FrameFileIO::loadIXXATFile(QString filename, QVector<CANFrame>* frames)
                 if (numBytes > 8) return false;
                 for (int d = 0; d < numBytes; d++) bytes[d] = static_cast<char>(dataToks[d].toInt(nullptr, 16));
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
             else return false;
         }
@@ -2816,64 +2889,52 @@ bool FrameFileIO::loadIXXATFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveIXXATFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    QDateTime timestamp, tempStamp;
-    int lineCounter = 0;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
+    FrameExportFormat format;
+    QDateTime timestamp;
 
     timestamp = QDateTime::currentDateTime();
 
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-
-    outFile->write("ASCII Trace IXXAT SavvyCAN V" + QString::number(VERSION).toUtf8() + "\n");
-    outFile->write("Date: " + timestamp.toString("d:M:yyyy").toUtf8() + "\n");
-    outFile->write("Start time: " + timestamp.toString("h:m:s").toUtf8() + "\n");
+    format.header = "ASCII Trace IXXAT SavvyCAN V" + QString::number(VERSION).toUtf8() + "\n";
+    format.header += "Date: " + timestamp.toString("d:M:yyyy").toUtf8() + "\n";
+    format.header += "Start time: " + timestamp.toString("h:m:s").toUtf8() + "\n";
     timestamp = timestamp.addMSecs((frames->last().timeStamp().microSeconds() - frames->first().timeStamp().microSeconds()) / 1000);
-    outFile->write("Stop time: " + timestamp.toString("h:m:s").toUtf8() + "\n");
-    outFile->write("Overruns: 0\n");
-    outFile->write("Baudrate: 500 kbit/s\n"); //could be a lie... this code has no way to know the baud rate (at the moment)
-    outFile->write("\"Time\",\"Identifier (hex)\",\"Format\",\"Flags\",\"Data (hex)\"\n");
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        tempStamp = QDateTime::fromMSecsSinceEpoch(frame->timeStamp().microSeconds() / 1000);
-        outFile->write("\"" + tempStamp.toString("h:m:s.").toUtf8() + tempStamp.toString("z").rightJustified(3, '0').toUtf8() + "\"");
-
-        outFile->write(",\"" + QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8() + "\"");
-        if (frame->hasExtendedFrameFormat()) outFile->write(",\"Ext\"");
-            else outFile->write(",\"Std\"");
-        outFile->write(",\"\",\"");
+    format.header += "Stop time: " + timestamp.toString("h:m:s").toUtf8() + "\n";
+    format.header += "Overruns: 0\n";
+    format.header += "Baudrate: 500 kbit/s\n"; //could be a lie... this code has no way to know the baud rate (at the moment)
+    format.header += "\"Time\",\"Identifier (hex)\",\"Format\",\"Flags\",\"Data (hex)\"\n";
+
+    format.lineOverhead = 80;
+    format.charsPerDataByte = 3;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
+
+        //local time so this has to go through QDateTime
+        QDateTime tempStamp = QDateTime::fromMSecsSinceEpoch(frame.timeStamp().microSeconds() / 1000);
+        QByteArray stampText = tempStamp.toString("h:m:s.").toUtf8();
+        *out++ = '"';
+        out = FastFormat::str(out, stampText.constData(), stampText.length());
+        out = FastFormat::decPadded(out, static_cast<uint64_t>(tempStamp.time().msec()), 3);
+        out = FastFormat::str(out, "\",\"", 3);
+        out = FastFormat::hex(out, frame.frameId(), 8);
+        *out++ = '"';
+        if (frame.hasExtendedFrameFormat()) out = FastFormat::str(out, ",\"Ext\"", 6);
+        else out = FastFormat::str(out, ",\"Std\"", 6);
+        out = FastFormat::str(out, ",\"\",\"", 5);
 
         for (int temp = 0; temp < dataLen; temp++)
         {
-            outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            outFile->putChar(' ');
+            out = FastFormat::hexByte(out, data[temp]);
+            *out++ = ' ';
         }
+        out = FastFormat::str(out, "\"\n", 2);
+        return out;
+    };
 
-        outFile->write("\"\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isCANDOFile(QString filename)
@@ -2980,7 +3041,7 @@ bool FrameFileIO::loadCANDOFile(QString filename, QVector<CANFrame>* frames)
         {
             for (int d = 0; d < numBytes; d++) bytes[d] = data[4 + d];
             thisFrame.setPayload(bytes);
-            frames->append(thisFrame);
+            if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
         }
         else foundErrors = true;
     }
@@ -2992,65 +3053,40 @@ bool FrameFileIO::loadCANDOFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveCANDOFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    int lineCounter = 0;
-    QByteArray data;
-    CANFrame thisFrame;
-    int id;
+    FrameExportFormat format;
     qint64 ms;
 
-    const unsigned char *inData;
-    int inDataLen;
-    const CANFrame *frame;
-
-    if (!outFile->open(QIODevice::WriteOnly))
-    {
-        delete outFile;
-        return false;
-    }
-
-    data.reserve(13);
-
     //The initial frame in official files sets the global time but I don't care so it is set all zeros here.
-    thisFrame = frames->at(0);
-    ms = (thisFrame.timeStamp().microSeconds() / 1000);
-    data[0] = (((ms / 1000) % 60) << 2) + ((ms % 1000) >> 8);
-    data[1] = (char)(ms & 0xFF);
-    data[2] = (char)0xFF;
-    data[3] = (char)0xFF;
-    for (int l = 0; l < 8; l++) data[4 + l] = 0;
-    outFile->write(data);
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        inData = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        inDataLen = frame->payload().count();
-
-        for (int j = 0; j < 8; j++) data[4 + j] = (char)0xFF;
+    ms = (frames->at(0).timeStamp().microSeconds() / 1000);
+    format.header.fill(0, 12);
+    format.header[0] = static_cast<char>((((ms / 1000) % 60) << 2) + ((ms % 1000) >> 8));
+    format.header[1] = static_cast<char>(ms & 0xFF);
+    format.header[2] = static_cast<char>(0xFF);
+    format.header[3] = static_cast<char>(0xFF);
+
+    //fixed 12 byte records. Only standard frames can be stored, extended frames are skipped
+    format.lineOverhead = 12;
+    format.charsPerDataByte = 0;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        if (frame.hasExtendedFrameFormat()) return out;
+
+        const QByteArray payload = frame.payload();
+        int inDataLen = qMin(payload.count(), 8);
+        qint64 ms = (frame.timeStamp().microSeconds() / 1000);
+        int id = frame.frameId() & 0x7FF;
+
+        out[0] = static_cast<char>((((ms / 1000) % 60) << 2) + ((ms % 1000) >> 8));
+        out[1] = static_cast<char>(ms & 0xFF);
+        out[2] = static_cast<char>(id & 0xFF);
+        out[3] = static_cast<char>((id >> 8) + (inDataLen << 4));
+        for (int j = 0; j < 8; j++) out[4 + j] = static_cast<char>(0xFF);
+        for (int d = 0; d < inDataLen; d++) out[4 + d] = payload.at(d);
+        return out + 12;
+    };
 
-        if (!frame->hasExtendedFrameFormat())
-        {
-            ms = (frame->timeStamp().microSeconds() / 1000);
-            id = frame->frameId() & 0x7FF;
-            data[0] = (((ms / 1000) % 60) << 2) + ((ms % 1000) >> 8);
-            data[1] = (char)(ms & 0xFF);
-            data[2] = (char)(id & 0xFF);
-            data[3] = (char)((id >> 8) + (inDataLen << 4));
-            for (int d = 0; d < inDataLen; d++) data[4 + d] = (char)inData[d];
-            outFile->write(data);
-        }
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format, QIODevice::WriteOnly);
 }
 
 bool FrameFileIO::isMicrochipFile(QString filename)
@@ -3171,7 +3207,7 @@ bool FrameFileIO::loadMicrochipFile(QString filename, QVector<CANFrame>* frames)
                         if (thisFrame.payload().length() + 4 > tokens.length()) thisFrame.payload().resize( tokens.length() - 4 );
                         for (int d = 0; d < numBytes; d++) bytes[d] = static_cast<char>( Utility::ParseStringToNum(tokens[4 + d]) );
                         thisFrame.setPayload(bytes);
-                        frames->append(thisFrame);
+                        if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                     }
                     else foundErrors = true;
                 }
@@ -3196,62 +3232,47 @@ tokens:
 */
 bool FrameFileIO::saveMicrochipFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    QDateTime timestamp, tempStamp;
-    int lineCounter = 0;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
+    FrameExportFormat format;
+    QDateTime timestamp;
 
     timestamp = QDateTime::currentDateTime();
 
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-
-    outFile->write("//---------------------------------\n");
-    outFile->write("Microchip Technology Inc.\n");
-    outFile->write("CAN BUS Analyzer\n");
-    outFile->write("SavvyCAN Exporter\n");
-    outFile->write("Logging Started: ");
-    outFile->write(timestamp.toString("d/M/yyyy h:m:s").toUtf8());
-    outFile->write("\n");
-    outFile->write("//---------------------------------\n");
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        outFile->write(QString::number((frame->timeStamp().microSeconds() / 1000)).toUtf8());
-        if (frame->isReceived) outFile->write(";RX;");
-        else outFile->write(";TX;");
-        outFile->write("0x" + QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8() + ";");
-        outFile->write(QString::number(dataLen).toUtf8() + ";");
-
+    format.header = "//---------------------------------\n";
+    format.header += "Microchip Technology Inc.\n";
+    format.header += "CAN BUS Analyzer\n";
+    format.header += "SavvyCAN Exporter\n";
+    format.header += "Logging Started: ";
+    format.header += timestamp.toString("d/M/yyyy h:m:s").toUtf8();
+    format.header += "\n";
+    format.header += "//---------------------------------\n";
+
+    format.lineOverhead = 64;
+    format.charsPerDataByte = 5;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
+
+        out = FastFormat::decSigned(out, frame.timeStamp().microSeconds() / 1000);
+        if (frame.isReceived) out = FastFormat::str(out, ";RX;0x", 6);
+        else out = FastFormat::str(out, ";TX;0x", 6);
+        out = FastFormat::hex(out, frame.frameId(), 8);
+        *out++ = ';';
+        out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
+        *out++ = ';';
         for (int temp = 0; temp < dataLen; temp++)
         {
-            outFile->write("0x" + QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            outFile->putChar(';');
+            out = FastFormat::str(out, "0x", 2);
+            out = FastFormat::hexByte(out, data[temp]);
+            *out++ = ';';
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isTraceFile(QString filename)
@@ -3397,7 +3418,7 @@ bool FrameFileIO::loadTraceFile(QString filename, QVector<CANFrame>* frames)
                     //if (numBytes > dataToks.length()) thisFrame.payload().resize(dataToks.length());
                     for (int d = 0; d < numBytes; d++) bytes[d] = static_cast<char>(dataToks[d].toInt(nullptr, 16));
                     thisFrame.setPayload(bytes);
-                    frames->append(thisFrame);
+                    if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
                 }
                 else foundErrors = true;
             }
@@ -3410,161 +3431,114 @@ bool FrameFileIO::loadTraceFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveTraceFile(QString filename, const QVector<CANFrame> * frames)
 {
-    QFile *outFile = new QFile(filename);
+    FrameExportFormat format;
     QDateTime timestamp;
-    int lineCounter = 0;
-    int64_t tempTime;
-    int tempTimePiece;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
 
     timestamp = QDateTime::currentDateTime();
 
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-
-    outFile->write(";  SavvyCAN CAN Logger trace file\n");
-    outFile->write(";  Device Serial Number : 0000 \n");
-    outFile->write(";  Start Time : ");
-    outFile->write(timestamp.toString("ddd, MMM dd, yyyy :: h:m:s\n").toUtf8());
-    outFile->write(";\n");
-    outFile->write(";  Column description :\n");
-    outFile->write(";  ~~~~~~~~~~~~~~~~~~~~~\n");
-    outFile->write(";\n");
-    outFile->write(";   + Message Number\n");
-    outFile->write(";   |\n");
-    outFile->write(";   |     	     + Time Stamp (ms)\n");
-    outFile->write(";   |     	     |\n");
-    outFile->write(";   |     	     |      	    + Message ID (hex)\n");
-    outFile->write(";   |     	     |      	    |\n");
-    outFile->write(";   |     	     |      	    |   	+ Data Length Code\n");
-    outFile->write(";   |     	     |      	    |   	|\n");
-    outFile->write(";   |     	     |      	    |   	|	 + Data Bytes (hex)\n");
-    outFile->write(";   |     	     |      	    |   	|	 |\n");
-    outFile->write(";---+-----	-----+------	----+---	+	-+ -- -- -- -- -- -- --\n");
-
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if ((lineCounter % 100) == 0)
-        {
-            qApp->processEvents();
-            //lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
+    format.header = ";  SavvyCAN CAN Logger trace file\n";
+    format.header += ";  Device Serial Number : 0000 \n";
+    format.header += ";  Start Time : ";
+    format.header += timestamp.toString("ddd, MMM dd, yyyy :: h:m:s\n").toUtf8();
+    format.header += ";\n";
+    format.header += ";  Column description :\n";
+    format.header += ";  ~~~~~~~~~~~~~~~~~~~~~\n";
+    format.header += ";\n";
+    format.header += ";   + Message Number\n";
+    format.header += ";   |\n";
+    format.header += ";   |     	     + Time Stamp (ms)\n";
+    format.header += ";   |     	     |\n";
+    format.header += ";   |     	     |      	    + Message ID (hex)\n";
+    format.header += ";   |     	     |      	    |\n";
+    format.header += ";   |     	     |      	    |   	+ Data Length Code\n";
+    format.header += ";   |     	     |      	    |   	|\n";
+    format.header += ";   |     	     |      	    |   	|	 + Data Bytes (hex)\n";
+    format.header += ";   |     	     |      	    |   	|	 |\n";
+    format.header += ";---+-----	-----+------	----+---	+	-+ -- -- -- -- -- -- --\n";
+
+    format.lineOverhead = 96;
+    format.charsPerDataByte = 3;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
 
          //1F D3 3F FF 08 FF E0 CB
-        outFile->write(QString::number(lineCounter).rightJustified(10, ' ').toUtf8());
-        outFile->write("\t");
-
-        tempTime = frame->timeStamp().microSeconds();
-        tempTimePiece = static_cast<int>(tempTime / 1000000l / 60 / 60);
-        tempTime -= tempTimePiece * 1000000l * 60 * 60;
-        outFile->write(QString::number(tempTimePiece).rightJustified(2, '0').toUtf8());
-        outFile->write(":");
-
-        tempTimePiece = static_cast<int>(tempTime / 1000000l / 60);
-        tempTime -= tempTimePiece * 1000000l * 60;
-        outFile->write(QString::number(tempTimePiece).rightJustified(2, '0').toUtf8());
-        outFile->write(":");
-
-        tempTimePiece = static_cast<int>(tempTime / 1000000l);
-        tempTime -= tempTimePiece * 1000000l;
-        outFile->write(QString::number(tempTimePiece).rightJustified(2, '0').toUtf8());
-        outFile->write(":");
-
-        tempTimePiece = static_cast<int>(tempTime / 100);
-        outFile->write(QString::number(tempTimePiece).rightJustified(4, '0').toUtf8());
-        outFile->write("\t");
-
-        outFile->write(QString::number(frame->frameId(), 16).toUpper().rightJustified(8, '0').toUtf8() + "\t");
-
-        outFile->write(QString::number(dataLen).toUtf8() + "\t");
+        out = FastFormat::decWidth(out, static_cast<uint64_t>(index + 1), 10, ' ');
+        *out++ = '\t';
+
+        //hh:mm:ss:tttt where the last field is tenths of a millisecond
+        uint64_t tempTime = static_cast<uint64_t>(frame.timeStamp().microSeconds());
+        out = FastFormat::decWidth(out, tempTime / 3600000000ull, 2, '0');
+        *out++ = ':';
+        tempTime %= 3600000000ull;
+        out = FastFormat::decPadded(out, tempTime / 60000000ull, 2);
+        *out++ = ':';
+        tempTime %= 60000000ull;
+        out = FastFormat::decPadded(out, tempTime / 1000000ull, 2);
+        *out++ = ':';
+        tempTime %= 1000000ull;
+        out = FastFormat::decPadded(out, tempTime / 100, 4);
+        *out++ = '\t';
+
+        out = FastFormat::hex(out, frame.frameId(), 8);
+        *out++ = '\t';
+        out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
+        *out++ = '\t';
 
         for (int temp = 0; temp < dataLen; temp++)
         {
-            outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            outFile->putChar(' ');
+            out = FastFormat::hexByte(out, data[temp]);
+            *out++ = ' ';
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::saveCanDumpFile(QString filename, const QVector<CANFrame> * frames)
 {
-    QFile *outFile = new QFile(filename);
-    QDateTime timestamp;
-    int lineCounter = 0;
-    double tempTime;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
-
-    timestamp = QDateTime::currentDateTime();
-
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
+    FrameExportFormat format;
 
-    for (int c = 0; c < frames->count(); c++)
+    format.lineOverhead = 64;
+    format.charsPerDataByte = 2;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
     {
-        lineCounter++;
-        if ((lineCounter % 100) == 0)
-        {
-            qApp->processEvents();
-        }
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
 
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
+        //seconds with 6 decimal places, zero padded to 17 characters in total
+        uint64_t tempTime = static_cast<uint64_t>(frame.timeStamp().microSeconds());
+        *out++ = '(';
+        out = FastFormat::decWidth(out, tempTime / 1000000ull, 10, '0');
+        *out++ = '.';
+        out = FastFormat::decPadded(out, tempTime % 1000000ull, 6);
+        out = FastFormat::str(out, ") vcan0 ", 8);
 
-        outFile->write("(");
+        if (frame.hasExtendedFrameFormat()) out = FastFormat::hexAtLeast(out, frame.frameId(), 8);
+        else out = FastFormat::hexAtLeast(out, frame.frameId(), 3);
 
-        tempTime = frame->timeStamp().microSeconds() / 1000000.0;
-        outFile->write(QString::number(tempTime,'f', 6).rightJustified(17, '0').toUtf8());
-        outFile->write(") vcan0 ");
+        *out++ = '#';
 
-        if (frame->hasExtendedFrameFormat()) {
-            outFile->write(QString::number(frame->frameId(), 16).rightJustified(8,'0').toUpper().toUtf8());
-        } else {
-            outFile->write(QString::number(frame->frameId(), 16).rightJustified(3,'0').toUpper().toUtf8());
+        if (frame.frameType() == QCanBusFrame::RemoteRequestFrame)
+        {
+            *out++ = 'R';
+            out = FastFormat::dec(out, static_cast<uint64_t>(dataLen));
         }
-
-        outFile->write("#");
-
-        if (frame->frameType() == QCanBusFrame::RemoteRequestFrame) {
-            outFile->write("R");
-            outFile->write(QString::number(dataLen).toUtf8());
-        } else {
-            for (int temp = 0; temp < dataLen; temp++)
-            {
-                outFile->write(QString::number(data[temp], 16).rightJustified(2,'0').toUpper().toUtf8());
-            }
+        else
+        {
+            for (int temp = 0; temp < dataLen; temp++) out = FastFormat::hexByte(out, data[temp]);
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isCanDumpFile(QString filename)
@@ -3820,7 +3794,7 @@ bool FrameFileIO::loadCanDumpFile(QString filename, QVector<CANFrame>* frames)
             /*NB: should we make sure len <= 8? */
             thisFrame.isReceived = true;
        }
-       frames->append(thisFrame);
+       if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
     }
     inFile->close();
     delete inFile;
@@ -3911,7 +3885,7 @@ bool FrameFileIO::loadLawicelFile(QString filename, QVector<CANFrame>* frames)
                 bytes[d] = static_cast<char>(line.mid(d * 2, 2).toInt(nullptr, 16));
             }
             thisFrame.setPayload(bytes);
-            frames->append(thisFrame);
+            if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
         }
     }
     inFile->close();
@@ -4016,7 +3990,7 @@ bool FrameFileIO::loadKvaserFile(QString filename, QVector<CANFrame> *frames, bo
             if (line.mid(72, 1).toUpper() == "R") thisFrame.isReceived = true;
                 else thisFrame.isReceived = false;
             thisFrame.setPayload(bytes);
-            frames->append(thisFrame);
+            if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
         }
         //else foundErrors = true;
     }
@@ -4167,7 +4141,7 @@ bool FrameFileIO::loadCabanaFile(QString filename, QVector<CANFrame>* frames)
                 }
                 
                 thisFrame.setPayload(finalbytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
             else foundErrors = true;
         }
@@ -4179,62 +4153,34 @@ bool FrameFileIO::loadCabanaFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::saveCabanaFile(QString filename, const QVector<CANFrame>* frames)
 {
-    QFile *outFile = new QFile(filename);
-    int lineCounter = 0;
-
-    const unsigned char *data;
-    int dataLen;
-    const CANFrame *frame;
-
-    if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        delete outFile;
-        return false;
-    }
-    
-    outFile->write("time,addr,bus,data");
-    outFile->write("\n");
-
-    for (int c = 0; c < frames->count(); c++)
-    {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-
-        frame = &frames->at(c);
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        dataLen = frame->payload().count();
-
-        double tempTimeStamp = frame->timeStamp().microSeconds();
-        tempTimeStamp /= 1000000;
-
-        outFile->write(QString::number(tempTimeStamp, 'f').toUtf8());
-        outFile->write(".0");
-        outFile->putChar(44);
-
-        outFile->write(QString::number(frame->frameId(), 10).toUpper().toUtf8());
-        outFile->putChar(44);
-
-        outFile->write(QString::number(frame->bus).toUtf8());
-        outFile->putChar(44);
-
+    FrameExportFormat format;
+
+    format.header = "time,addr,bus,data\n";
+    format.lineOverhead = 80; //only ever writes 8 data bytes
+    format.charsPerDataByte = 0;
+    format.formatLine = [](char *out, const CANFrame &frame, int index)
+    {
+        Q_UNUSED(index);
+        const QByteArray payload = frame.payload();
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(payload.constData());
+        int dataLen = payload.count();
+
+        out = FastFormat::seconds(out, frame.timeStamp().microSeconds());
+        out = FastFormat::str(out, ".0,", 3);
+        out = FastFormat::dec(out, static_cast<uint64_t>(frame.frameId()));
+        *out++ = ',';
+        out = FastFormat::decSigned(out, frame.bus);
+        *out++ = ',';
         for (int temp = 0; temp < 8; temp++)
         {
-            if (temp < dataLen)
-                outFile->write(QString::number(data[temp], 16).toUpper().rightJustified(2, '0').toUtf8());
-            else
-                outFile->write("00");
+            if (temp < dataLen) out = FastFormat::hexByte(out, data[temp]);
+            else out = FastFormat::str(out, "00", 2);
         }
+        *out++ = '\n';
+        return out;
+    };
 
-        outFile->write("\n");
-
-    }
-    outFile->close();
-    delete outFile;
-    return true;
+    return FrameExporter::exportFrames(filename, frames, format);
 }
 
 bool FrameFileIO::isTeslaAPFile(QString filename)
@@ -4308,7 +4254,7 @@ bool FrameFileIO::loadTeslaAPFile(QString filename, QVector<CANFrame>* frames)
         {
             for (int d = 0; d < numBytes; d++) bytes[d] = record.data[d];
             thisFrame.setPayload(bytes);
-            frames->append(thisFrame);
+            if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
         }
         else foundErrors = true;
     }
@@ -4750,7 +4696,7 @@ bool FrameFileIO::loadCLX000File(QString filename, QVector<CANFrame>* frames) {
                 currentFrame.setPayload(QByteArray());
             }
 
-            frames->append(currentFrame);
+            if (passesLoadFilter(currentFrame)) frames->append(currentFrame);
         } else {
             qDebug() << "Could not parse:" << recordLine;
         }
@@ -4889,7 +4835,7 @@ bool FrameFileIO::loadCANServerFile(QString filename, QVector<CANFrame>* frames)
                 markFrame.isMark = true;
                 markFrame.markMessage = QString(markData);
                 
-                frames->append(markFrame);
+                if (passesLoadFilter(markFrame)) frames->append(markFrame);
                  */
             }
             else if (data[0] == 0xCE)
@@ -4959,7 +4905,7 @@ bool FrameFileIO::loadCANServerFile(QString filename, QVector<CANFrame>* frames)
                 }
                 
                 thisFrame.setPayload(bytes);
-                frames->append(thisFrame);
+                if (passesLoadFilter(thisFrame)) frames->append(thisFrame);
             }
         }
     }
@@ -4975,83 +4921,16 @@ bool FrameFileIO::loadCANServerFile(QString filename, QVector<CANFrame>* frames)
 
 bool FrameFileIO::loadWiresharkFile(QString filename, QVector<CANFrame>* frames)
 {
-    pcap_t *pcap_data_file;
-    CANFrame thisFrame;
-    long long startTimestamp = 0;
-    long long timeStamp;
-    int lineCounter = 0;
-    bool foundErrors = false;
-    pcap_pkthdr    packetHeader;
-	const char     *packetData = NULL;
-	char errbuf[PCAP_ERRBUF_SIZE];
-
-    thisFrame.setFrameType(QCanBusFrame::DataFrame);
-    
-    QByteArray ba = filename.toLocal8Bit();
-
-    pcap_data_file = pcap_open_offline(ba.data(), errbuf);
-	if (!pcap_data_file) {
-		return false;
-	}
-
-    packetData = (const char*)pcap_next(pcap_data_file, &packetHeader);
-
-    while (packetData) {
-        lineCounter++;
-        if (lineCounter > 100)
-        {
-            qApp->processEvents();
-            lineCounter = 0;
-        }
-        
-        timeStamp = packetHeader.ts.tv_sec * 1000000 + packetHeader.ts.tv_usec;
-        if (0 == startTimestamp) 
-        {
-            startTimestamp = timeStamp;
-        }
-
-        timeStamp -= startTimestamp;
-
-        thisFrame.setTimeStamp(QCanBusFrame::TimeStamp(0, timeStamp));
-        thisFrame.isReceived = true; // TODO: check if tx detection is possible
-            
-        thisFrame.setFrameType(QCanBusFrame::DataFrame);
-        thisFrame.setFrameId((0xff & *(packetData+17)) << 8 | (0xff & *(packetData+16)));
-        if (thisFrame.frameId() <= 0x7FF) thisFrame.setExtendedFrameFormat(false);
-            else thisFrame.setExtendedFrameFormat(true);
-        thisFrame.bus = 0;
-        int numBytes = *(packetData+20);
-        QByteArray bytes(numBytes, 0);
-        if (thisFrame.payload().length() > 8) thisFrame.payload().resize(8);
-        for (int d = 0; d < numBytes; d++) 
-        { 
-            bytes[d] = *(packetData + 24 + d);
-        }
-        thisFrame.setPayload(bytes);
-        frames->append(thisFrame);
-
-        packetData = (const char*)pcap_next(pcap_data_file, &packetHeader);
-    }
-
-    pcap_close(pcap_data_file);
-	pcap_data_file = NULL;
-    
-    return !foundErrors;
+    PCAPHandler pcap;
+    return pcap.loadPCAP(filename, frames);
 }
 
 bool FrameFileIO::isWiresharkFile(QString filename)
 {
-    pcap_t *pcap_data_file;
-    char errbuf[PCAP_ERRBUF_SIZE];
-    QByteArray ba = filename.toLocal8Bit();
-
-    pcap_data_file = pcap_open_offline(ba.data(), errbuf);
-	if (!pcap_data_file) {
-		return false;
-	}
-
-    pcap_close(pcap_data_file);
-	pcap_data_file = NULL;
+    return PCAPHandler::isPCAP(filename);
+}
 
-    return true;
+bool FrameFileIO::saveWiresharkFile(QString filename, const QVector<CANFrame>* frames, bool pcapng)
+{
+    return PCAPHandler::savePCAP(filename, frames, pcapng);
 }
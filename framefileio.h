@@ -7,14 +7,37 @@
 #include <Qt>
 #include <QApplication>
 #include <QObject>
+#include <QPair>
+#include <QSet>
 #include <QVector>
 #include <QFile>
 #include <QString>
 #include <QStringList>
 #include <QFileDialog>
 #include "can_structs.h"
+#include "continuouslogger.h"
 #include "utility.h"
 
+//Conditions applied to every frame while a file is being loaded. Frames which don't pass are thrown away as soon as the
+//loader has parsed enough of them to tell, instead of being loaded and filtered afterward. That way one ECU or a few
+//seconds can be pulled out of a huge log without having to hold the whole log in memory.
+struct FrameLoadFilter
+{
+    FrameLoadFilter();
+
+    bool useTimeWindow;
+    int64_t windowStart;    //microseconds from the first frame in the file, inclusive
+    int64_t windowEnd;      //microseconds from the first frame in the file, inclusive
+    QSet<uint32_t> ids;     //if both this and idRanges are empty any ID is allowed. Otherwise the ID has to be in one of them
+    QVector<QPair<uint32_t, uint32_t>> idRanges; //first and last ID, inclusive
+    uint32_t idMask;        //(ID & idMask) has to equal idMatch. A mask of 0 allows any ID
+    uint32_t idMatch;
+    QSet<int> buses;        //empty allows any bus
+    int decimation;         //keep only every Nth frame out of those which pass all of the above. 1 keeps them all
+
+    bool isActive() const;
+};
+
 class FrameFileIO: public QObject
 {
     Q_OBJECT
@@ -26,11 +49,12 @@ public:
     //The QString returns the filename that was selected and so is really a sort of return value
     //The QVector is used as either the target for loading or the source for saving.
     //These routines call the below loading/saving functions so no need to use them directly if you don't want.
-    static bool loadFrameFile(QString &, QVector<CANFrame>*);
+    //The optional filter limits which frames are loaded, see FrameLoadFilter
+    static bool loadFrameFile(QString &, QVector<CANFrame>*, const FrameLoadFilter *filter = nullptr);
     static bool saveFrameFile(QString &, const QVector<CANFrame>*);
 
     //These do the actual loading and saving and can be used directly if you'd prefer
-    static bool autoDetectLoadFile(QString, QVector<CANFrame>*);
+    static bool autoDetectLoadFile(QString, QVector<CANFrame>*, const FrameLoadFilter *filter = nullptr);
     static bool loadCRTDFile(QString, QVector<CANFrame>*);
     static bool loadNativeCSVFile(QString, QVector<CANFrame>*);
     static bool loadGenericCSVFile(QString, QVector<CANFrame>*);
@@ -54,6 +78,7 @@ public:
     static bool loadCLX000File(QString filename, QVector<CANFrame>* frames);
     static bool loadCANServerFile(QString filename, QVector<CANFrame>* frames);
     static bool loadWiresharkFile(QString filename, QVector<CANFrame>* frames);
+    static bool loadSavvyBinaryFile(QString filename, QVector<CANFrame>* frames);
 
     //functions that pre-scan a file to try to figure out if they could read it. Used to automatically determine
     //file type and load it.
@@ -80,6 +105,7 @@ public:
     static bool isCLX000File(QString filename);
     static bool isCANServerFile(QString filename);
     static bool isWiresharkFile(QString filename);
+    static bool isSavvyBinaryFile(QString filename);
 
     static bool saveCRTDFile(QString, const QVector<CANFrame>*);
     static bool saveNativeCSVFile(QString, const QVector<CANFrame>*);
@@ -94,14 +120,31 @@ public:
     static bool saveCabanaFile(QString filename, const QVector<CANFrame>* frames);
     static bool saveCanalyzerASC(QString filename, const QVector<CANFrame>* frames);
     static bool saveCARBUSAnalzyer(QString filename, const QVector<CANFrame>* frames);
+    static bool saveWiresharkFile(QString filename, const QVector<CANFrame>* frames, bool pcapng);
+
+    //asks the user where to put a continuous log and in which format (one of ContinuousLogFormat)
+    //The actual logging is done by ContinuousLogger on its own thread
+    static bool pickContinuousLogFile(QString &filename, int &format);
 
-    static bool openContinuousNative();
-    static bool closeContinuousNative();
-    static bool writeContinuousNative(const QVector<CANFrame>*, int);
-    static bool flushContinuousNative();
+    //Used by the loaders to apply the filter given to loadFrameFile or autoDetectLoadFile. Returns true if the frame
+    //should be kept, which is always the case if no filter was given. Call it exactly once per frame since it also
+    //does the counting for decimation. Loaders should call it as soon as they have the timestamp, ID and bus.
+    static bool passesLoadFilter(uint64_t timeStamp, uint32_t id, int bus);
+    static bool passesLoadFilter(const CANFrame &frame);
 
 private:
-    static QFile continuousFile;
+    static bool autoDetect(QString, QVector<CANFrame>*);
+    static void beginLoadFilter(const FrameLoadFilter *filter);
+    static void endLoadFilter();
+    static void resetLoadFilterState();
+    static void prepareLoadAttempt(QVector<CANFrame>* frames, int startCount);
+
+    static const FrameLoadFilter *activeLoadFilter;
+    static bool loadFilterSawFirst;
+    static uint64_t loadFilterFirstTime;
+    static int loadFilterDecimationCount;
+
+    static void parseSavvyBinaryRecords(const char *data, int length, int &used, QVector<CANFrame>* frames);
 };
 
 #endif // FRAMEFILEIO_H
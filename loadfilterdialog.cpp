@@ -0,0 +1,146 @@
+#include "loadfilterdialog.h"
+#include "ui_loadfilterdialog.h"
+
+#include <QMessageBox>
+#include <QSettings>
+#include "utility.h"
+
+LoadFilterDialog::LoadFilterDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::LoadFilterDialog)
+{
+    QSettings settings;
+    ui->setupUi(this);
+
+    ui->cbTimeWindow->setChecked(settings.value("LoadFilter/UseTimeWindow", false).toBool());
+    ui->spinStartTime->setValue(settings.value("LoadFilter/StartTime", 0.0).toDouble());
+    ui->spinEndTime->setValue(settings.value("LoadFilter/EndTime", 60.0).toDouble());
+    ui->lineIDs->setText(settings.value("LoadFilter/IDs", "").toString());
+    ui->lineIDMask->setText(settings.value("LoadFilter/IDMask", "0x0").toString());
+    ui->lineIDMatch->setText(settings.value("LoadFilter/IDMatch", "0x0").toString());
+    ui->lineBuses->setText(settings.value("LoadFilter/Buses", "").toString());
+    ui->spinDecimation->setValue(settings.value("LoadFilter/Decimation", 1).toInt());
+
+    ui->spinStartTime->setEnabled(ui->cbTimeWindow->isChecked());
+    ui->spinEndTime->setEnabled(ui->cbTimeWindow->isChecked());
+    connect(ui->cbTimeWindow, &QCheckBox::toggled, ui->spinStartTime, &QWidget::setEnabled);
+    connect(ui->cbTimeWindow, &QCheckBox::toggled, ui->spinEndTime, &QWidget::setEnabled);
+
+    connect(ui->buttonBox, &QDialogButtonBox::accepted, this, &LoadFilterDialog::checkAndAccept);
+    connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+}
+
+LoadFilterDialog::~LoadFilterDialog()
+{
+    delete ui;
+}
+
+void LoadFilterDialog::checkAndAccept()
+{
+    FrameLoadFilter filter;
+
+    if (!parseIDList(ui->lineIDs->text(), filter))
+    {
+        QMessageBox::warning(this, tr("Invalid IDs"), tr("IDs must be a comma separated list of IDs or ranges such as 0x100, 0x200-0x2FF"));
+        return;
+    }
+
+    if (!parseBusList(ui->lineBuses->text(), filter))
+    {
+        QMessageBox::warning(this, tr("Invalid Buses"), tr("Buses must be a comma separated list of bus numbers"));
+        return;
+    }
+
+    if (ui->cbTimeWindow->isChecked() && ui->spinEndTime->value() < ui->spinStartTime->value())
+    {
+        QMessageBox::warning(this, tr("Invalid Time Window"), tr("The end of the time window is before the start"));
+        return;
+    }
+
+    writeSettings();
+    accept();
+}
+
+FrameLoadFilter LoadFilterDialog::getFilter()
+{
+    FrameLoadFilter filter;
+
+    filter.useTimeWindow = ui->cbTimeWindow->isChecked();
+    filter.windowStart = static_cast<int64_t>(ui->spinStartTime->value() * 1000000.0);
+    filter.windowEnd = static_cast<int64_t>(ui->spinEndTime->value() * 1000000.0);
+    parseIDList(ui->lineIDs->text(), filter);
+    filter.idMask = static_cast<uint32_t>(Utility::ParseStringToNum(ui->lineIDMask->text()));
+    filter.idMatch = static_cast<uint32_t>(Utility::ParseStringToNum(ui->lineIDMatch->text())) & filter.idMask;
+    parseBusList(ui->lineBuses->text(), filter);
+    filter.decimation = ui->spinDecimation->value();
+
+    return filter;
+}
+
+//IDs are given as a comma separated list. Each entry is either one ID or a range written as first-last
+bool LoadFilterDialog::parseIDList(const QString &text, FrameLoadFilter &filter)
+{
+    QStringList entries = text.split(',');
+
+    filter.ids.clear();
+    filter.idRanges.clear();
+
+    for (int i = 0; i < entries.count(); i++)
+    {
+        QString entry = entries[i].trimmed();
+        if (entry.isEmpty()) continue;
+
+        QStringList ends = entry.split('-');
+        if (ends.count() > 2) return false;
+        for (int j = 0; j < ends.count(); j++)
+        {
+            if (ends[j].trimmed().isEmpty()) return false;
+        }
+
+        uint32_t first = static_cast<uint32_t>(Utility::ParseStringToNum(ends[0].trimmed()));
+        if (ends.count() == 1)
+        {
+            filter.ids.insert(first);
+        }
+        else
+        {
+            uint32_t last = static_cast<uint32_t>(Utility::ParseStringToNum(ends[1].trimmed()));
+            if (last < first) return false;
+            filter.idRanges.append(qMakePair(first, last));
+        }
+    }
+    return true;
+}
+
+bool LoadFilterDialog::parseBusList(const QString &text, FrameLoadFilter &filter)
+{
+    QStringList entries = text.split(',');
+
+    filter.buses.clear();
+
+    for (int i = 0; i < entries.count(); i++)
+    {
+        QString entry = entries[i].trimmed();
+        if (entry.isEmpty()) continue;
+
+        bool ok;
+        int bus = entry.toInt(&ok);
+        if (!ok || bus < 0) return false;
+        filter.buses.insert(bus);
+    }
+    return true;
+}
+
+void LoadFilterDialog::writeSettings()
+{
+    QSettings settings;
+
+    settings.setValue("LoadFilter/UseTimeWindow", ui->cbTimeWindow->isChecked());
+    settings.setValue("LoadFilter/StartTime", ui->spinStartTime->value());
+    settings.setValue("LoadFilter/EndTime", ui->spinEndTime->value());
+    settings.setValue("LoadFilter/IDs", ui->lineIDs->text());
+    settings.setValue("LoadFilter/IDMask", ui->lineIDMask->text());
+    settings.setValue("LoadFilter/IDMatch", ui->lineIDMatch->text());
+    settings.setValue("LoadFilter/Buses", ui->lineBuses->text());
+    settings.setValue("LoadFilter/Decimation", ui->spinDecimation->value());
+}
@@ -0,0 +1,33 @@
+#ifndef LOADFILTERDIALOG_H
+#define LOADFILTERDIALOG_H
+
+#include <QDialog>
+#include "framefileio.h"
+
+namespace Ui {
+class LoadFilterDialog;
+}
+
+//Asks which frames should be kept when loading a file. See FrameLoadFilter
+class LoadFilterDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LoadFilterDialog(QWidget *parent = nullptr);
+    ~LoadFilterDialog();
+
+    FrameLoadFilter getFilter();
+
+private slots:
+    void checkAndAccept();
+
+private:
+    Ui::LoadFilterDialog *ui;
+
+    bool parseIDList(const QString &text, FrameLoadFilter &filter);
+    bool parseBusList(const QString &text, FrameLoadFilter &filter);
+    void writeSettings();
+};
+
+#endif // LOADFILTERDIALOG_H
@@ -89,8 +89,10 @@ MainSettingsDialog::MainSettingsDialog(QWidget *parent) :
     ui->comboSendingBus->setCurrentIndex(settings.value("Playback/SendingBus", 4).toInt());
     ui->cbUseFiltered->setChecked(settings.value("Main/UseFiltered", false).toBool());
     ui->cbUseOpenGL->setChecked(settings.value("Main/UseOpenGL", false).toBool());
+    ui->spinGraphFPS->setValue(settings.value("Graphing/MaxReplotFPS", 30).toInt());
     ui->cbFilterLabeling->setChecked(settings.value("Main/FilterLabeling", true).toBool());
     ui->cbIgnoreDBCColors->setChecked(settings.value("Main/IgnoreDBCColors", false).toBool());
+    ui->cbIncrementalDBCSave->setChecked(settings.value("DBC/IncrementalSave", true).toBool());
 
     int maxFramesDefault;
     if (QSysInfo::WordSize > 32)
@@ -106,6 +108,8 @@ MainSettingsDialog::MainSettingsDialog(QWidget *parent) :
 
     ui->spinMaximumFrames->setValue(settings.value("Main/MaximumFrames", maxFramesDefault).toInt());
     ui->spinBytesPerLine->setValue(settings.value("Main/BytesPerLine", 8).toInt());
+    ui->spinLogRotateSize->setValue(settings.value("FileIO/LogRotateMB", 0).toInt());
+    ui->spinLogRotateTime->setValue(settings.value("FileIO/LogRotateMinutes", 0).toInt());
 
     //just for simplicity they all call the same function and that function updates all settings at once
     connect(ui->cbDisplayHex, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
@@ -126,6 +130,7 @@ MainSettingsDialog::MainSettingsDialog(QWidget *parent) :
     connect(ui->cbUseFiltered, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
     connect(ui->lineClockFormat, SIGNAL(editingFinished()), this, SLOT(updateSettings()));
     connect(ui->cbUseOpenGL, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
+    connect(ui->spinGraphFPS, SIGNAL(valueChanged(int)), this, SLOT(updateSettings()));
     connect(ui->lineRemoteHost, SIGNAL(editingFinished()), this, SLOT(updateSettings()));
     connect(ui->lineRemotePort, SIGNAL(editingFinished()), this, SLOT(updateSettings()));
     connect(ui->lineRemoteUser, SIGNAL(editingFinished()), this, SLOT(updateSettings()));
@@ -135,9 +140,12 @@ MainSettingsDialog::MainSettingsDialog(QWidget *parent) :
     connect(ui->cbHexGraphFlow, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
     connect(ui->cbHexGraphInfo, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
     connect(ui->cbIgnoreDBCColors, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
+    connect(ui->cbIncrementalDBCSave, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
     connect(ui->spinMaximumFrames, SIGNAL(valueChanged(int)), this, SLOT(updateSettings()));
     connect(ui->cbFontFixedWidth, SIGNAL(toggled(bool)), this, SLOT(updateSettings()));
     connect(ui->spinBytesPerLine, SIGNAL(valueChanged(int)), this, SLOT(updateSettings()));
+    connect(ui->spinLogRotateSize, SIGNAL(valueChanged(int)), this, SLOT(updateSettings()));
+    connect(ui->spinLogRotateTime, SIGNAL(valueChanged(int)), this, SLOT(updateSettings()));
 
     installEventFilter(this);
 }
@@ -196,6 +204,7 @@ void MainSettingsDialog::updateSettings()
     settings.setValue("Playback/SendingBus", ui->comboSendingBus->currentIndex());
     settings.setValue("Main/UseFiltered", ui->cbUseFiltered->isChecked());
     settings.setValue("Main/UseOpenGL", ui->cbUseOpenGL->isChecked());
+    settings.setValue("Graphing/MaxReplotFPS", ui->spinGraphFPS->value());
     settings.setValue("Main/TimeFormat", ui->lineClockFormat->text());
     settings.setValue("Main/FontSize", ui->spinFontSize->value());
     settings.setValue("Remote/Host", ui->lineRemoteHost->text());
@@ -205,9 +214,12 @@ void MainSettingsDialog::updateSettings()
     settings.setValue("Remote/Pass", encPass);
     settings.setValue("Main/FilterLabeling", ui->cbFilterLabeling->isChecked());
     settings.setValue("Main/IgnoreDBCColors", ui->cbIgnoreDBCColors->isChecked());
+    settings.setValue("DBC/IncrementalSave", ui->cbIncrementalDBCSave->isChecked());
     settings.setValue("Main/MaximumFrames", ui->spinMaximumFrames->value());
     settings.setValue("Main/BytesPerLine", ui->spinBytesPerLine->value());
     settings.setValue("Main/FontFixedWidth", ui->cbFontFixedWidth->isChecked());
+    settings.setValue("FileIO/LogRotateMB", ui->spinLogRotateSize->value());
+    settings.setValue("FileIO/LogRotateMinutes", ui->spinLogRotateTime->value());
 
     settings.sync();
     emit updatedSettings();
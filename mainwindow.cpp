@@ -9,6 +9,7 @@
 #include "helpwindow.h"
 #include "utility.h"
 #include "filterutility.h"
+#include "loadfilterdialog.h"
 
 /*
 Some notes on things I'd like to put into the program but haven't put on github (yet)
@@ -103,10 +104,12 @@ MainWindow::MainWindow(QWidget *parent) :
     framesPerSec = 0;
     continuousLogging = false;
     continuousLogFlushCounter = 0;
+    continuousLogger.initialize();
 
     //handlers for all menu entries
     connect(ui->actionSetup, SIGNAL(triggered(bool)), SLOT(showConnectionSettingsWindow()));
     connect(ui->actionOpen_Log_File, &QAction::triggered, this, &MainWindow::handleLoadFile);
+    connect(ui->actionOpen_Filtered_Log_File, &QAction::triggered, this, &MainWindow::handleLoadFilteredFile);
     connect(ui->actionGraph_Dta, &QAction::triggered, this, &MainWindow::showGraphingWindow);
     connect(ui->actionFrame_Data_Analysis, &QAction::triggered, this, &MainWindow::showFrameDataAnalysis);
     connect(ui->actionSave_Log_File, &QAction::triggered, this, &MainWindow::handleSaveFile);
@@ -149,6 +152,7 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(CANConManager::getInstance(), &CANConManager::framesReceived, model, &CANFrameModel::addFrames);
     //new implementation for continuous logging
     connect(CANConManager::getInstance(), &CANConManager::framesReceived, this, &MainWindow::logReceivedFrame);
+    connect(&continuousLogger, &ContinuousLogger::logError, this, [this](QString message){ui->statusBar->showMessage(message, 10000);});
 
     connect(ui->cbInterpret, &QAbstractButton::toggled, this, &MainWindow::interpretToggled);
     connect(ui->cbOverwrite, &QAbstractButton::toggled, this, &MainWindow::overwriteToggled);
@@ -230,6 +234,7 @@ MainWindow::MainWindow(QWidget *parent) :
 MainWindow::~MainWindow()
 {
     updateTimer.stop();
+    continuousLogger.finalize(); //closes out the log if one is still open
     killEmAll(); //Ride the lightning
     delete ui;
     delete model;
@@ -768,7 +773,7 @@ void MainWindow::logReceivedFrame(CANConnection* conn, QVector<CANFrame> frames)
     Q_UNUSED(conn);
     if (continuousLogging)
     {
-        FrameFileIO::writeContinuousNative(&frames, 0);
+        continuousLogger.queueFrames(frames);
     }
 }
 
@@ -800,12 +805,11 @@ void MainWindow::tickGUIUpdate()
 
         if (continuousLogging)
         {
-//            const QVector<CANFrame> *modelFrames = model->getListReference();
-//            FrameFileIO::writeContinuousNative(modelFrames, modelFrames->count() - rxFrames);
-
+            //the logger flushes to disk on its own thread, all that's left to do here is blink the label
             continuousLogFlushCounter++;
             if ((continuousLogFlushCounter % 3) == 0)
             {
+                continuousLogFlushCounter = 0;
                 if (ui->lblContMsg->text().length() > 2)
                 {
                     ui->lblContMsg->setText("");
@@ -815,11 +819,6 @@ void MainWindow::tickGUIUpdate()
                     ui->lblContMsg->setText("LOGGING");
                 }
             }
-            if (continuousLogFlushCounter > 8)
-            {
-                continuousLogFlushCounter = 0;
-                FrameFileIO::flushContinuousNative();
-            }
         }
 
         rxFrames = 0;
@@ -872,13 +871,28 @@ void MainWindow::normalizeTiming()
 }
 
 void MainWindow::handleLoadFile()
+{
+    loadFile(nullptr);
+}
+
+//asks which frames are wanted first and then only loads those
+void MainWindow::handleLoadFilteredFile()
+{
+    LoadFilterDialog dialog(this);
+    if (dialog.exec() != QDialog::Accepted) return;
+
+    FrameLoadFilter filter = dialog.getFilter();
+    loadFile(&filter);
+}
+
+void MainWindow::loadFile(const FrameLoadFilter *filter)
 {
     QString filename;
     QVector<CANFrame> tempFrames;
 
     QMessageBox::StandardButton confirmDialog;
 
-    bool loadResult = FrameFileIO::loadFrameFile(filename, &tempFrames);
+    bool loadResult = FrameFileIO::loadFrameFile(filename, &tempFrames, filter);
 
     if (!loadResult)
     {
@@ -966,18 +980,31 @@ void MainWindow::handleSaveFile()
 
 void MainWindow::handleContinousLogging()
 {
-    continuousLogging = !continuousLogging;
-
-    if (continuousLogging)
+    if (!continuousLogging)
     {
+        QString filename;
+        int format;
+        QSettings settings;
+
+        if (!FrameFileIO::pickContinuousLogFile(filename, format)) return;
+
+        qint64 rotateBytes = settings.value("FileIO/LogRotateMB", 0).toLongLong() * 1024 * 1024;
+        int rotateSeconds = settings.value("FileIO/LogRotateMinutes", 0).toInt() * 60;
+        if (!continuousLogger.open(filename, format, rotateBytes, rotateSeconds))
+        {
+            QMessageBox::warning(this, tr("Continuous Logging"), tr("Could not open %1 for writing").arg(filename));
+            return;
+        }
+
+        continuousLogging = true;
         ui->actionSave_Continuous_Logfile->setText(tr("Cease Continuous Logging"));
-        FrameFileIO::openContinuousNative();
     }
     else
     {
+        continuousLogging = false;
         ui->actionSave_Continuous_Logfile->setText(tr("Start Continuous Logging"));
         ui->lblContMsg->setText("");
-        FrameFileIO::closeContinuousNative();
+        continuousLogger.close();
     }
 }
 
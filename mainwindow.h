@@ -8,6 +8,7 @@
 #include "canframemodel.h"
 #include "can_structs.h"
 #include "framefileio.h"
+#include "continuouslogger.h"
 #include "dbc/dbchandler.h"
 #include "bus_protocols/isotp_handler.h"
 
@@ -59,6 +60,7 @@ public:
 
 private slots:
     void handleLoadFile();
+    void handleLoadFilteredFile();
     void handleSaveFile();
     void handleSaveFilteredFile();
     void handleSaveFilters();
@@ -136,6 +138,8 @@ private:
     Ui::MainWindow *ui;
     static MainWindow *selfRef;
 
+    void loadFile(const FrameLoadFilter *filter);
+
     //canbus related data
     CANFrameModel *model;
     DBCHandler *dbcHandler;
@@ -154,6 +158,7 @@ private:
 
     bool continuousLogging;
     int continuousLogFlushCounter;
+    ContinuousLogger continuousLogger;
 
     //References to other windows we can display
 
@@ -0,0 +1,490 @@
+#include "pcaphandler.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QMap>
+#include <QtEndian>
+#include "framefileio.h"
+#include "frameexporter.h"
+
+//how many packets to work through between calls to processEvents
+#define PCAP_PACKETS_PER_UPDATE     10000
+
+static void appendLE16(QByteArray &out, uint16_t value)
+{
+    char bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    out.append(bytes, 2);
+}
+
+static void appendLE32(QByteArray &out, uint32_t value)
+{
+    char bytes[4];
+    qToLittleEndian<quint32>(value, bytes);
+    out.append(bytes, 4);
+}
+
+//SocketCAN frame as found in LINKTYPE_CAN_SOCKETCAN captures. Returns a pointer just past it
+static char *writeSocketCANFrame(char *out, const CANFrame &frame)
+{
+    bool isFD = frame.hasFlexibleDataRateFormat();
+    int packetLen = isFD ? SOCKETCAN_CANFD_MTU : SOCKETCAN_CAN_MTU;
+    const QByteArray payload = frame.payload();
+    int dataLen = qMin(payload.count(), packetLen - SOCKETCAN_HEADER_SIZE);
+
+    uint32_t rawId = frame.frameId() & SOCKETCAN_ID_MASK;
+    if (frame.hasExtendedFrameFormat()) rawId |= SOCKETCAN_EFF_FLAG;
+    if (frame.frameType() == QCanBusFrame::RemoteRequestFrame) rawId |= SOCKETCAN_RTR_FLAG;
+    if (frame.frameType() == QCanBusFrame::ErrorFrame) rawId |= SOCKETCAN_ERR_FLAG;
+
+    uint8_t fdFlags = 0;
+    if (isFD)
+    {
+        fdFlags = SOCKETCAN_CANFD_FDF;
+        if (frame.hasBitrateSwitch()) fdFlags |= SOCKETCAN_CANFD_BRS;
+        if (frame.hasErrorStateIndicator()) fdFlags |= SOCKETCAN_CANFD_ESI;
+    }
+
+    qToBigEndian<quint32>(rawId, out); //the ID is always big endian for this link type
+    out[4] = static_cast<char>(dataLen);
+    out[5] = static_cast<char>(fdFlags);
+    out[6] = 0;
+    out[7] = 0;
+    memcpy(out + SOCKETCAN_HEADER_SIZE, payload.constData(), dataLen);
+    memset(out + SOCKETCAN_HEADER_SIZE + dataLen, 0, packetLen - SOCKETCAN_HEADER_SIZE - dataLen);
+    return out + packetLen;
+}
+
+PCAPHandler::PCAPHandler()
+{
+    fileData = nullptr;
+    fileLength = 0;
+    swapped = false;
+}
+
+uint16_t PCAPHandler::read16(qint64 offset)
+{
+    if (swapped) return qFromBigEndian<quint16>(fileData + offset);
+    return qFromLittleEndian<quint16>(fileData + offset);
+}
+
+uint32_t PCAPHandler::read32(qint64 offset)
+{
+    if (swapped) return qFromBigEndian<quint32>(fileData + offset);
+    return qFromLittleEndian<quint32>(fileData + offset);
+}
+
+bool PCAPHandler::isPCAP(QString filename)
+{
+    QFile inFile(filename);
+
+    if (!inFile.open(QIODevice::ReadOnly)) return false;
+    QByteArray header = inFile.read(12);
+    inFile.close();
+    if (header.length() < 12) return false;
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(header.constData());
+    uint32_t magic = qFromLittleEndian<quint32>(bytes);
+    if (magic == PCAP_MAGIC_MICRO || magic == PCAP_MAGIC_NANO) return true;
+    magic = qFromBigEndian<quint32>(bytes);
+    if (magic == PCAP_MAGIC_MICRO || magic == PCAP_MAGIC_NANO) return true;
+
+    if (magic == PCAPNG_BLOCK_SHB)
+    {
+        if (qFromLittleEndian<quint32>(bytes + 8) == PCAPNG_BYTE_ORDER_MAGIC) return true;
+        if (qFromBigEndian<quint32>(bytes + 8) == PCAPNG_BYTE_ORDER_MAGIC) return true;
+    }
+    return false;
+}
+
+bool PCAPHandler::loadPCAP(QString filename, QVector<CANFrame>* frames)
+{
+    QFile inFile(filename);
+    QByteArray fallback;
+    bool result = false;
+
+    if (!inFile.open(QIODevice::ReadOnly)) return false;
+
+    fileLength = inFile.size();
+    fileData = inFile.map(0, fileLength);
+    if (!fileData) //not everything can be mapped (some network shares for instance) so fall back to reading it all in
+    {
+        qDebug() << "Could not map " << filename << " reading it instead";
+        fallback = inFile.readAll();
+        fileData = reinterpret_cast<const uchar *>(fallback.constData());
+        fileLength = fallback.size();
+    }
+
+    if (fileLength >= 12)
+    {
+        if (qFromLittleEndian<quint32>(fileData) == PCAPNG_BLOCK_SHB) result = loadNG(frames);
+        else result = loadClassic(frames);
+    }
+
+    inFile.close(); //also unmaps the file
+    fileData = nullptr;
+    fileLength = 0;
+    return result;
+}
+
+bool PCAPHandler::loadClassic(QVector<CANFrame>* frames)
+{
+    bool foundErrors = false;
+    int packetCounter = 0;
+
+    if (fileLength < PCAP_FILE_HEADER_SIZE) return false;
+
+    swapped = false;
+    uint32_t magic = read32(0);
+    if (magic != PCAP_MAGIC_MICRO && magic != PCAP_MAGIC_NANO)
+    {
+        swapped = true;
+        magic = read32(0);
+        if (magic != PCAP_MAGIC_MICRO && magic != PCAP_MAGIC_NANO) return false;
+    }
+    bool nanoSeconds = (magic == PCAP_MAGIC_NANO);
+    uint32_t linkType = read32(20) & 0xFFFF; //upper bits can hold FCS information which doesn't matter here
+
+    qint64 pos = PCAP_FILE_HEADER_SIZE;
+    while (pos + PCAP_RECORD_HEADER_SIZE <= fileLength)
+    {
+        uint32_t capLen = read32(pos + 8);
+        if (pos + PCAP_RECORD_HEADER_SIZE + capLen > fileLength) //the capture was cut off partway through a packet
+        {
+            foundErrors = true;
+            break;
+        }
+
+        uint64_t timeStamp = (read32(pos) * 1000000ull);
+        if (nanoSeconds) timeStamp += read32(pos + 4) / 1000;
+        else timeStamp += read32(pos + 4);
+
+        parsePacket(fileData + pos + PCAP_RECORD_HEADER_SIZE, capLen, linkType, timeStamp, 0, true, frames);
+        pos += PCAP_RECORD_HEADER_SIZE + capLen;
+
+        if (++packetCounter > PCAP_PACKETS_PER_UPDATE)
+        {
+            QCoreApplication::processEvents();
+            packetCounter = 0;
+        }
+    }
+
+    return !foundErrors;
+}
+
+//returns the offset of the value of the first option with the given code in the range or -1 if it isn't there
+qint64 PCAPHandler::findOption(qint64 start, qint64 end, uint16_t code, uint16_t &length)
+{
+    while (start + 4 <= end)
+    {
+        uint16_t optCode = read16(start);
+        uint16_t optLength = read16(start + 2);
+        if (optCode == PCAPNG_OPT_ENDOFOPT) break;
+        if (start + 4 + optLength > end) break;
+        if (optCode == code)
+        {
+            length = optLength;
+            return start + 4;
+        }
+        start += 4 + ((optLength + 3) & ~3); //values are padded out to 32 bits
+    }
+    return -1;
+}
+
+bool PCAPHandler::loadNG(QVector<CANFrame>* frames)
+{
+    bool foundErrors = false;
+    int packetCounter = 0;
+    uint16_t optLength;
+    qint64 pos = 0;
+
+    swapped = false;
+    interfaces.clear();
+
+    while (pos + 12 <= fileLength)
+    {
+        uint32_t blockType = read32(pos);
+
+        //the byte order can change from one section to the next so the section header is checked before the block length
+        if (blockType == PCAPNG_BLOCK_SHB)
+        {
+            if (qFromLittleEndian<quint32>(fileData + pos + 8) == PCAPNG_BYTE_ORDER_MAGIC) swapped = false;
+            else if (qFromBigEndian<quint32>(fileData + pos + 8) == PCAPNG_BYTE_ORDER_MAGIC) swapped = true;
+            else
+            {
+                foundErrors = true;
+                break;
+            }
+            interfaces.clear(); //interface numbering starts over in each section
+        }
+
+        uint32_t blockLength = read32(pos + 4);
+        if (blockLength < 12 || (blockLength & 3) || (pos + blockLength) > fileLength)
+        {
+            foundErrors = true;
+            break;
+        }
+        qint64 blockEnd = pos + blockLength - 4; //the block length is repeated in the last 4 bytes
+
+        switch (blockType)
+        {
+        case PCAPNG_BLOCK_IDB:
+        {
+            if (blockLength < 20)
+            {
+                foundErrors = true;
+                break;
+            }
+            PCAP_INTERFACE iface;
+            iface.linkType = read16(pos + 8);
+            iface.tsResolution = 6; //microseconds unless the interface says otherwise
+            qint64 opt = findOption(pos + 16, blockEnd, PCAPNG_OPT_IF_TSRESOL, optLength);
+            if (opt >= 0 && optLength >= 1) iface.tsResolution = fileData[opt];
+            interfaces.append(iface);
+            break;
+        }
+        case PCAPNG_BLOCK_EPB:
+        case PCAPNG_BLOCK_PB:
+        {
+            if (blockLength < 32)
+            {
+                foundErrors = true;
+                break;
+            }
+            uint32_t ifIndex = (blockType == PCAPNG_BLOCK_EPB) ? read32(pos + 8) : read16(pos + 8);
+            uint64_t rawTime = (static_cast<uint64_t>(read32(pos + 12)) << 32) | read32(pos + 16);
+            uint32_t capLen = read32(pos + 20);
+            if ((28ll + capLen) > (blockLength - 4) || ifIndex >= static_cast<uint32_t>(interfaces.count()))
+            {
+                foundErrors = true;
+                break;
+            }
+
+            //direction is in the lowest two bits of the packet flags, 1 = inbound 2 = outbound
+            bool received = true;
+            if (blockType == PCAPNG_BLOCK_EPB)
+            {
+                qint64 opt = findOption(pos + 28 + ((capLen + 3) & ~3u), blockEnd, PCAPNG_OPT_EPB_FLAGS, optLength);
+                if (opt >= 0 && optLength >= 4 && (read32(opt) & 3) == 2) received = false;
+            }
+
+            const PCAP_INTERFACE &iface = interfaces.at(static_cast<int>(ifIndex));
+            parsePacket(fileData + pos + 28, capLen, iface.linkType, toMicroseconds(rawTime, iface.tsResolution),
+                        static_cast<int>(ifIndex), received, frames);
+            break;
+        }
+        case PCAPNG_BLOCK_SPB:
+        {
+            //no timestamp and always from the first interface
+            if (interfaces.isEmpty() || blockLength < 16) break;
+            uint32_t capLen = qMin(read32(pos + 8), blockLength - 16);
+            parsePacket(fileData + pos + 12, capLen, interfaces.at(0).linkType, 0, 0, true, frames);
+            break;
+        }
+        default: //statistics, name resolution, custom blocks, etc. None of them matter here so they're skipped unread
+            break;
+        }
+
+        pos += blockLength;
+
+        if (++packetCounter > PCAP_PACKETS_PER_UPDATE)
+        {
+            QCoreApplication::processEvents();
+            packetCounter = 0;
+        }
+    }
+
+    return !foundErrors;
+}
+
+uint64_t PCAPHandler::toMicroseconds(uint64_t timeStamp, uint8_t resolution)
+{
+    if (resolution & 0x80) //units of 2^-n seconds
+    {
+        int shift = resolution & 0x7F;
+        if (shift > 40) //keeps the multiply below from overflowing. Nothing is that precise anyway
+        {
+            timeStamp >>= (shift - 40);
+            shift = 40;
+        }
+        uint64_t whole = timeStamp >> shift;
+        uint64_t fraction = timeStamp & ((1ull << shift) - 1);
+        return (whole * 1000000ull) + ((fraction * 1000000ull) >> shift);
+    }
+
+    //units of 10^-n seconds
+    for (int i = resolution; i < 6; i++) timeStamp *= 10;
+    for (int i = 6; i < resolution; i++) timeStamp /= 10;
+    return timeStamp;
+}
+
+void PCAPHandler::parsePacket(const uchar *packet, uint32_t capLen, uint32_t linkType, uint64_t timeStamp, int bus,
+                              bool received, QVector<CANFrame>* frames)
+{
+    bool cooked = false;
+    bool isFD = false;
+    uint16_t protocol = 0;
+
+    switch (linkType)
+    {
+    case PCAP_LINKTYPE_CAN_SOCKETCAN:
+        break;
+    case PCAP_LINKTYPE_LINUX_SLL:
+        if (capLen < PCAP_SLL_HEADER_SIZE) return;
+        if (qFromBigEndian<quint16>(packet) == PCAP_SLL_OUTGOING) received = false;
+        protocol = qFromBigEndian<quint16>(packet + 14);
+        packet += PCAP_SLL_HEADER_SIZE;
+        capLen -= PCAP_SLL_HEADER_SIZE;
+        cooked = true;
+        break;
+    case PCAP_LINKTYPE_LINUX_SLL2:
+        if (capLen < PCAP_SLL2_HEADER_SIZE) return;
+        protocol = qFromBigEndian<quint16>(packet);
+        if (packet[10] == PCAP_SLL_OUTGOING) received = false;
+        packet += PCAP_SLL2_HEADER_SIZE;
+        capLen -= PCAP_SLL2_HEADER_SIZE;
+        cooked = true;
+        break;
+    default: //not CAN traffic
+        return;
+    }
+
+    if (cooked)
+    {
+        if (protocol == PCAP_ETH_P_CANFD) isFD = true;
+        else if (protocol != PCAP_ETH_P_CAN) return;
+    }
+
+    if (capLen < SOCKETCAN_HEADER_SIZE) return;
+
+    //a cooked capture keeps the ID in the byte order of the machine that made it, which is the byte order of the file
+    uint32_t rawId;
+    if (cooked && !swapped) rawId = qFromLittleEndian<quint32>(packet);
+    else rawId = qFromBigEndian<quint32>(packet);
+
+    uint32_t id = rawId & SOCKETCAN_ID_MASK;
+    if (!FrameFileIO::passesLoadFilter(timeStamp, id, bus)) return;
+
+    uint8_t fdFlags = packet[5];
+    if (capLen >= SOCKETCAN_CANFD_MTU || (fdFlags & SOCKETCAN_CANFD_FDF)) isFD = true;
+    int dataLen = qMin(static_cast<int>(packet[4]), isFD ? 64 : 8);
+    dataLen = qMin(dataLen, static_cast<int>(capLen) - SOCKETCAN_HEADER_SIZE);
+
+    CANFrame thisFrame;
+    thisFrame.setTimeStamp(QCanBusFrame::TimeStamp(0, static_cast<qint64>(timeStamp)));
+    thisFrame.setFrameId(id);
+    thisFrame.setExtendedFrameFormat(rawId & SOCKETCAN_EFF_FLAG);
+    thisFrame.bus = bus;
+    thisFrame.isReceived = received;
+    if (rawId & SOCKETCAN_ERR_FLAG) thisFrame.setFrameType(QCanBusFrame::ErrorFrame);
+    else if (rawId & SOCKETCAN_RTR_FLAG) thisFrame.setFrameType(QCanBusFrame::RemoteRequestFrame);
+    else thisFrame.setFrameType(QCanBusFrame::DataFrame);
+    if (isFD)
+    {
+        thisFrame.setFlexibleDataRateFormat(true);
+        thisFrame.setBitrateSwitch(fdFlags & SOCKETCAN_CANFD_BRS);
+        thisFrame.setErrorStateIndicator(fdFlags & SOCKETCAN_CANFD_ESI);
+    }
+    thisFrame.setPayload(QByteArray(reinterpret_cast<const char *>(packet + SOCKETCAN_HEADER_SIZE), dataLen));
+    frames->append(thisFrame);
+}
+
+//Both formats are written little endian with microsecond timestamps and the LINKTYPE_CAN_SOCKETCAN link type.
+//pcapng gets an interface per bus (named canX) so multi bus captures keep their bus numbers. Classic pcap can't store that.
+bool PCAPHandler::savePCAP(QString filename, const QVector<CANFrame>* frames, bool pcapng)
+{
+    FrameExportFormat format;
+    QMap<int, uint32_t> busInterfaces;
+
+    if (pcapng)
+    {
+        for (int i = 0; i < frames->count(); i++) busInterfaces.insert(frames->at(i).bus, 0);
+        if (busInterfaces.isEmpty()) busInterfaces.insert(0, 0);
+
+        //section header
+        appendLE32(format.header, PCAPNG_BLOCK_SHB);
+        appendLE32(format.header, 28);
+        appendLE32(format.header, PCAPNG_BYTE_ORDER_MAGIC);
+        appendLE16(format.header, 1);
+        appendLE16(format.header, 0);
+        appendLE32(format.header, 0xFFFFFFFF); //section length unknown (64 bits of all ones)
+        appendLE32(format.header, 0xFFFFFFFF);
+        appendLE32(format.header, 28);
+
+        //one interface description per bus. Default timestamp resolution is microseconds which is what is needed
+        uint32_t ifIndex = 0;
+        for (QMap<int, uint32_t>::iterator it = busInterfaces.begin(); it != busInterfaces.end(); ++it)
+        {
+            QByteArray name = "can" + QByteArray::number(it.key());
+            int paddedName = (name.length() + 3) & ~3;
+            uint32_t blockLength = 28 + paddedName;
+
+            appendLE32(format.header, PCAPNG_BLOCK_IDB);
+            appendLE32(format.header, blockLength);
+            appendLE16(format.header, PCAP_LINKTYPE_CAN_SOCKETCAN);
+            appendLE16(format.header, 0);
+            appendLE32(format.header, SOCKETCAN_CANFD_MTU);
+            appendLE16(format.header, PCAPNG_OPT_IF_NAME);
+            appendLE16(format.header, static_cast<uint16_t>(name.length()));
+            format.header.append(name);
+            format.header.append(paddedName - name.length(), 0);
+            appendLE32(format.header, PCAPNG_OPT_ENDOFOPT);
+            appendLE32(format.header, blockLength);
+
+            it.value() = ifIndex++;
+        }
+
+        //enhanced packet block: 28 byte header, packet, epb_flags option, end of options, trailing length
+        format.lineOverhead = 44 + SOCKETCAN_CANFD_MTU;
+        format.charsPerDataByte = 0;
+        format.formatLine = [busInterfaces](char *out, const CANFrame &frame, int index)
+        {
+            Q_UNUSED(index);
+            uint32_t packetLen = frame.hasFlexibleDataRateFormat() ? SOCKETCAN_CANFD_MTU : SOCKETCAN_CAN_MTU;
+            uint32_t blockLength = 44 + packetLen;
+            uint64_t timeStamp = static_cast<uint64_t>(frame.timeStamp().microSeconds());
+
+            qToLittleEndian<quint32>(PCAPNG_BLOCK_EPB, out);
+            qToLittleEndian<quint32>(blockLength, out + 4);
+            qToLittleEndian<quint32>(busInterfaces.value(frame.bus), out + 8);
+            qToLittleEndian<quint32>(static_cast<uint32_t>(timeStamp >> 32), out + 12);
+            qToLittleEndian<quint32>(static_cast<uint32_t>(timeStamp), out + 16);
+            qToLittleEndian<quint32>(packetLen, out + 20);
+            qToLittleEndian<quint32>(packetLen, out + 24);
+            out = writeSocketCANFrame(out + 28, frame);
+            qToLittleEndian<quint16>(PCAPNG_OPT_EPB_FLAGS, out);
+            qToLittleEndian<quint16>(4, out + 2);
+            qToLittleEndian<quint32>(frame.isReceived ? 1 : 2, out + 4);
+            qToLittleEndian<quint32>(PCAPNG_OPT_ENDOFOPT, out + 8);
+            qToLittleEndian<quint32>(blockLength, out + 12);
+            return out + 16;
+        };
+    }
+    else
+    {
+        appendLE32(format.header, PCAP_MAGIC_MICRO);
+        appendLE16(format.header, 2);
+        appendLE16(format.header, 4);
+        appendLE32(format.header, 0); //GMT offset
+        appendLE32(format.header, 0); //timestamp accuracy
+        appendLE32(format.header, SOCKETCAN_CANFD_MTU); //snap length
+        appendLE32(format.header, PCAP_LINKTYPE_CAN_SOCKETCAN);
+
+        format.lineOverhead = PCAP_RECORD_HEADER_SIZE + SOCKETCAN_CANFD_MTU;
+        format.charsPerDataByte = 0;
+        format.formatLine = [](char *out, const CANFrame &frame, int index)
+        {
+            Q_UNUSED(index);
+            uint32_t packetLen = frame.hasFlexibleDataRateFormat() ? SOCKETCAN_CANFD_MTU : SOCKETCAN_CAN_MTU;
+            uint64_t timeStamp = static_cast<uint64_t>(frame.timeStamp().microSeconds());
+
+            qToLittleEndian<quint32>(static_cast<uint32_t>(timeStamp / 1000000ull), out);
+            qToLittleEndian<quint32>(static_cast<uint32_t>(timeStamp % 1000000ull), out + 4);
+            qToLittleEndian<quint32>(packetLen, out + 8);
+            qToLittleEndian<quint32>(packetLen, out + 12);
+            return writeSocketCANFrame(out + PCAP_RECORD_HEADER_SIZE, frame);
+        };
+    }
+
+    return FrameExporter::exportFrames(filename, frames, format, QIODevice::WriteOnly);
+}
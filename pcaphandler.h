@@ -0,0 +1,92 @@
+#ifndef PCAPHANDLER_H
+#define PCAPHANDLER_H
+
+#include <Qt>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "can_structs.h"
+
+//classic pcap file magic numbers as read in the file's own byte order
+#define PCAP_MAGIC_MICRO            0xA1B2C3D4
+#define PCAP_MAGIC_NANO             0xA1B23C4D
+#define PCAP_FILE_HEADER_SIZE       24
+#define PCAP_RECORD_HEADER_SIZE     16
+
+//pcapng block types
+#define PCAPNG_BLOCK_SHB            0x0A0D0D0A
+#define PCAPNG_BLOCK_IDB            0x00000001
+#define PCAPNG_BLOCK_PB             0x00000002 //obsolete packet block, still found in old captures
+#define PCAPNG_BLOCK_SPB            0x00000003
+#define PCAPNG_BLOCK_EPB            0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC     0x1A2B3C4D
+
+#define PCAPNG_OPT_ENDOFOPT         0
+#define PCAPNG_OPT_IF_NAME          2
+#define PCAPNG_OPT_IF_TSRESOL       9
+#define PCAPNG_OPT_EPB_FLAGS        2
+
+//link types which carry CAN frames
+#define PCAP_LINKTYPE_LINUX_SLL     113
+#define PCAP_LINKTYPE_CAN_SOCKETCAN 227
+#define PCAP_LINKTYPE_LINUX_SLL2    276
+
+#define PCAP_SLL_HEADER_SIZE        16
+#define PCAP_SLL2_HEADER_SIZE       20
+#define PCAP_SLL_OUTGOING           4
+#define PCAP_ETH_P_CAN              0x000C
+#define PCAP_ETH_P_CANFD            0x000D
+
+//SocketCAN frame layout, see linux/can.h
+#define SOCKETCAN_EFF_FLAG          0x80000000u
+#define SOCKETCAN_RTR_FLAG          0x40000000u
+#define SOCKETCAN_ERR_FLAG          0x20000000u
+#define SOCKETCAN_ID_MASK           0x1FFFFFFFu
+#define SOCKETCAN_HEADER_SIZE       8
+#define SOCKETCAN_CAN_MTU           16
+#define SOCKETCAN_CANFD_MTU         72
+#define SOCKETCAN_CANFD_BRS         0x01
+#define SOCKETCAN_CANFD_ESI         0x02
+#define SOCKETCAN_CANFD_FDF         0x04
+
+struct PCAP_INTERFACE
+{
+    uint32_t linkType;
+    uint8_t tsResolution; //if_tsresol. High bit set = negative power of 2, otherwise negative power of 10
+};
+
+/*
+ * Reads pcap and pcapng captures of CAN traffic. The whole file is memory mapped and walked in place so there is no per packet
+ * file I/O. Supports the LINKTYPE_CAN_SOCKETCAN link type as well as SocketCAN (CAN and CAN-FD) inside Linux cooked captures
+ * (SLL and SLL2). In pcapng files each interface description block becomes its own bus and the per interface timestamp
+ * resolution is honored, as is the packet direction when the capture recorded it. Blocks which aren't needed are skipped
+ * by their length without being looked at.
+ * Writing produces LINKTYPE_CAN_SOCKETCAN captures, pcapng with one interface per bus or classic pcap.
+*/
+class PCAPHandler
+{
+public:
+    PCAPHandler();
+    bool loadPCAP(QString filename, QVector<CANFrame>* frames);
+
+    static bool isPCAP(QString filename);
+    static bool savePCAP(QString filename, const QVector<CANFrame>* frames, bool pcapng);
+
+private:
+    const uchar *fileData;
+    qint64 fileLength;
+    bool swapped; //the file was written on a machine with the other byte order
+    QVector<PCAP_INTERFACE> interfaces;
+
+    bool loadClassic(QVector<CANFrame>* frames);
+    bool loadNG(QVector<CANFrame>* frames);
+    void parsePacket(const uchar *packet, uint32_t capLen, uint32_t linkType, uint64_t timeStamp, int bus, bool received,
+                     QVector<CANFrame>* frames);
+    uint64_t toMicroseconds(uint64_t timeStamp, uint8_t resolution);
+    qint64 findOption(qint64 start, qint64 end, uint16_t code, uint16_t &length);
+
+    uint16_t read16(qint64 offset);
+    uint32_t read32(qint64 offset);
+};
+
+#endif // PCAPHANDLER_H
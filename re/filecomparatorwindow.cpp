@@ -172,23 +172,15 @@ void FileComparatorWindow::calculateDetails()
             }            
             if (msg)
             {
-                int numSignals = msg->sigHandler->getCount();
-                for (int i = 0; i < numSignals; i++)
+                QVector<DBC_DECODED_SIGNAL> decoded;
+                msg->sigHandler->decodeFrame(frame, decoded);
+                for (int i = 0; i < decoded.count(); i++)
                 {
-                    DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(i);
-                    if (sig)
-                    {
-                        if (sig->isSignalInMessage(frame))
-                        {
-                            QString sigVal;
-                            if (sig->processAsText(frame, sigVal, false))
-                            {
-                                QList<QString> tempList = interestedIDs[frame.frameId()].signalInstances[sig->name];
-                                if (!tempList.contains(sigVal)) tempList.append(sigVal);
-                                interestedIDs[frame.frameId()].signalInstances[sig->name] = tempList;
-                            }
-                        }
-                    }
+                    DBC_SIGNAL *sig = decoded[i].signal;
+                    QString sigVal = sig->makePrettyOutput(decoded[i].value, false);
+                    QList<QString> tempList = interestedIDs[frame.frameId()].signalInstances[sig->name];
+                    if (!tempList.contains(sigVal)) tempList.append(sigVal);
+                    interestedIDs[frame.frameId()].signalInstances[sig->name] = tempList;
                 }
                 qApp->processEvents();
             }
@@ -219,23 +211,15 @@ void FileComparatorWindow::calculateDetails()
             }
             if (msg)
             {
-                int numSignals = msg->sigHandler->getCount();
-                for (int i = 0; i < numSignals; i++)
+                QVector<DBC_DECODED_SIGNAL> decoded;
+                msg->sigHandler->decodeFrame(frame, decoded);
+                for (int i = 0; i < decoded.count(); i++)
                 {
-                    DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(i);
-                    if (sig)
-                    {
-                        if (sig->isSignalInMessage(frame))
-                        {
-                            QString sigVal;
-                            if (sig->processAsText(frame, sigVal, false))
-                            {
-                                QList<QString> tempList;
-                                tempList.append(sigVal);
-                                newData->signalInstances[sig->name] = tempList;
-                            }
-                        }
-                    }
+                    DBC_SIGNAL *sig = decoded[i].signal;
+                    QString sigVal = sig->makePrettyOutput(decoded[i].value, false);
+                    QList<QString> tempList;
+                    tempList.append(sigVal);
+                    newData->signalInstances[sig->name] = tempList;
                 }
             }
 
@@ -264,23 +248,15 @@ void FileComparatorWindow::calculateDetails()
             }
             if (msg)
             {
-                int numSignals = msg->sigHandler->getCount();
-                for (int i = 0; i < numSignals; i++)
+                QVector<DBC_DECODED_SIGNAL> decoded;
+                msg->sigHandler->decodeFrame(frame, decoded);
+                for (int i = 0; i < decoded.count(); i++)
                 {
-                    DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(i);
-                    if (sig)
-                    {
-                        if (sig->isSignalInMessage(frame))
-                        {
-                            QString sigVal;
-                            if (sig->processAsText(frame, sigVal, false))
-                            {
-                                QList<QString> tempList = referenceIDs[frame.frameId()].signalInstances[sig->name];
-                                if (!tempList.contains(sigVal)) tempList.append(sigVal);
-                                referenceIDs[frame.frameId()].signalInstances[sig->name] = tempList;
-                            }
-                        }
-                    }
+                    DBC_SIGNAL *sig = decoded[i].signal;
+                    QString sigVal = sig->makePrettyOutput(decoded[i].value, false);
+                    QList<QString> tempList = referenceIDs[frame.frameId()].signalInstances[sig->name];
+                    if (!tempList.contains(sigVal)) tempList.append(sigVal);
+                    referenceIDs[frame.frameId()].signalInstances[sig->name] = tempList;
                 }
             }
         }
@@ -308,23 +284,15 @@ void FileComparatorWindow::calculateDetails()
             }
             if (msg)
             {
-                int numSignals = msg->sigHandler->getCount();
-                for (int i = 0; i < numSignals; i++)
+                QVector<DBC_DECODED_SIGNAL> decoded;
+                msg->sigHandler->decodeFrame(frame, decoded);
+                for (int i = 0; i < decoded.count(); i++)
                 {
-                    DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(i);
-                    if (sig)
-                    {
-                        if (sig->isSignalInMessage(frame))
-                        {
-                            QString sigVal;
-                            if (sig->processAsText(frame, sigVal, false))
-                            {
-                                QList<QString> tempList;
-                                tempList.append(sigVal);
-                                newData->signalInstances[sig->name] = tempList;
-                            }
-                        }
-                    }
+                    DBC_SIGNAL *sig = decoded[i].signal;
+                    QString sigVal = sig->makePrettyOutput(decoded[i].value, false);
+                    QList<QString> tempList;
+                    tempList.append(sigVal);
+                    newData->signalInstances[sig->name] = tempList;
                 }
             }
             referenceIDs.insert(frame.frameId(), *newData);
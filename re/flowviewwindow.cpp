@@ -4,6 +4,9 @@
 #include "helpwindow.h"
 #include "filterutility.h"
 #include "qcpaxistickerhex.h"
+#include "utils/plotrendering.h"
+
+#include <algorithm>
 
 const QColor FlowViewWindow::graphColors[8] = {Qt::blue, Qt::green, Qt::black, Qt::red, //0 1 2 3
                                                Qt::gray, Qt::darkYellow, Qt::cyan, Qt::darkMagenta}; //4 5 6 7
@@ -23,8 +26,12 @@ FlowViewWindow::FlowViewWindow(const QVector<CANFrame> *frames, QWidget *parent)
     playbackTimer = new QTimer();
 
     currentPosition = 0;
+    currentID = 0;
     playbackActive = false;
     playbackForward = true;
+    timesSorted = true;
+    keysSorted = true;
+    for (int i = 0; i < 8; i++) graphRef[i] = nullptr;
 
     memset(refBytes, 0, 64);
     memset(currBytes, 0, 64);
@@ -75,16 +82,8 @@ FlowViewWindow::FlowViewWindow(const QVector<CANFrame> *frames, QWidget *parent)
     //ui->graphView->xAxis->setTickStep(5.0);
     //ui->graphView->xAxis->setSubTickCount(0);
 
-    if (openGLMode)
-    {
-        ui->graphView->setAntialiasedElements(QCP::aeAll);
-        ui->graphView->setOpenGl(true);
-    }
-    else
-    {
-        ui->graphView->setOpenGl(false);
-        ui->graphView->setAntialiasedElements(QCP::aeNone);
-    }
+    PlotRendering::setup(ui->graphView, openGLMode);
+    PlotRendering::addFrameTimeReadout(ui->graphView);
 
     ui->graphView->setBufferDevicePixelRatio(1);
 
@@ -296,7 +295,7 @@ void FlowViewWindow::plottableDoubleClick(QCPAbstractPlottable* plottable, QMous
     int id = 0;
     //apply transforms to get the X axis value where we double clicked
     double coord = plottable->keyAxis()->pixelToCoord(event->localPos().x());
-    if (frameCache.count() > 0) id = frameCache[0].frameId();
+    if (currentFrameCount() > 0) id = currentID;
     if (secondsMode) emit sendCenterTimeID(id, coord);
     else emit sendCenterTimeID(id, coord / 1000000.0);
 }
@@ -321,13 +320,22 @@ void FlowViewWindow::gotCenterTimeID(uint32_t ID, double timestamp)
         }
     }
 
+    //the frame right before the first one past the time stamp, if there is one past it
     int bestIdx = -1;
-    for (int i = 0; i < frameCache.count(); i++)
+    if (timesSorted)
+    {
+        QVector<qint64>::const_iterator after = std::upper_bound(frameTimes.constBegin(), frameTimes.constEnd(), t_stamp);
+        if (after != frameTimes.constEnd()) bestIdx = static_cast<int>(after - frameTimes.constBegin()) - 1;
+    }
+    else
     {
-        if (frameCache[i].timeStamp().microSeconds() > t_stamp)
+        for (int i = 0; i < frameTimes.count(); i++)
         {
-            bestIdx = i - 1;
-            break;
+            if (frameTimes[i] > t_stamp)
+            {
+                bestIdx = i - 1;
+                break;
+            }
         }
     }
     qDebug() << "Best index " << bestIdx;
@@ -341,7 +349,8 @@ void FlowViewWindow::gotCenterTimeID(uint32_t ID, double timestamp)
 
         memset(currBytes, 0, 8); //first zero out all 8 bytes
 
-        memcpy(currBytes, frameCache.at(currentPosition).payload().data(), frameCache.at(currentPosition).payload().length());
+        const CANFrame &frame = frameAt(currentPosition);
+        memcpy(currBytes, frame.payload().constData(), frame.payload().length());
 
         updateDataView();
     }
@@ -388,6 +397,7 @@ void FlowViewWindow::saveFileGraph()
     {
         filename = dialog.selectedFiles()[0];
 
+        PlotExportGuard guard(ui->graphView); //no frame time readout in the saved image
         if (dialog.selectedNameFilter() == filters[0])
         {
             if (!filename.contains('.')) filename += ".pdf";
@@ -443,16 +453,14 @@ void FlowViewWindow::saveFileFlow()
 
 void FlowViewWindow::updatedFrames(int numFrames)
 {
-    QVector<double>newX[8];
-    QVector<double>newY[8];
-    const unsigned char *data;
-    int dataLen = 0;
-
-    const CANFrame *thisFrame;
     if (numFrames == -1) //all frames deleted. Kill the display
     {
         ui->listFrameID->clear();
         foundID.clear();
+        idIndex.clear();
+        graphKeys.clear();
+        for (int k = 0; k < 8; k++) byteColumns[k].clear();
+        frameTimes.clear();
         currentPosition = 0;
         refreshIDList();
         updateFrameLabel();
@@ -463,79 +471,52 @@ void FlowViewWindow::updatedFrames(int numFrames)
     }
     else if (numFrames == -2) //all new set of frames. Reset
     {
-        ui->listFrameID->clear();
-        foundID.clear();
         currentPosition = 0;
-        refreshIDList();
-        //if (ui->listFrameID->count() > 0)
-        //{
-         //   changeID(ui->listFrameID->item(0)->text());
-        //    ui->listFrameID->setCurrentRow(0);
-        //}
-        //updateFrameLabel();
+        reindex();
     }
     else //just got some new frames. See if they are relevant.
     {
         if (numFrames > modelFrames->count()) return;
-        unsigned int refID;
-        if (frameCache.count() > 0) refID = frameCache[0].frameId();
-            else refID = 0;
-        bool needRefresh = false;
-        for (int i = modelFrames->count() - numFrames; i < modelFrames->count(); i++)
+        if (idIndex.sync(*modelFrames)) //not just new frames after all, start over
         {
-            thisFrame = &modelFrames->at(i);
-            data = reinterpret_cast<const unsigned char *>(thisFrame->payload().constData());
-            dataLen = thisFrame->payload().length();
-
-            if (!foundID.contains(thisFrame->frameId()))
-            {
-                foundID.append(thisFrame->frameId());
-                FilterUtility::createFilterItem(thisFrame->frameId(), ui->listFrameID);
-            }
+            reindex();
+            updateFrameLabel();
+            return;
+        }
 
-            if (thisFrame->frameId() == refID)
-            {
-                frameCache.append(*thisFrame);
-
-                for (int k = 0; k < dataLen; k++)
-                {
-                    if (ui->cbTimeGraph->isChecked())
-                    {
-                        if (secondsMode){
-                            newX[k].append((double)(thisFrame->timeStamp().microSeconds()) / 1000000.0);
-                        }
-                        else
-                        {
-                            newX[k].append(thisFrame->timeStamp().microSeconds());
-                        }
-                    }
-                    else
-                    {
-                        newX[k].append(x[k].count());
-                    }
-                    newY[k].append(data[k]);
-                    needRefresh = true;
-                }
-            }
+        //new IDs go to the bottom of the list until it gets sorted again
+        const QList<uint32_t> &ids = idIndex.ids();
+        for (int i = foundID.count(); i < ids.count(); i++)
+        {
+            foundID.append(ids[i]);
+            FilterUtility::createFilterItem(ids[i], ui->listFrameID);
         }
-        if (ui->cbLiveMode->checkState() == Qt::Checked)
+
+        //the index already knows which of the new frames are for the current ID
+        const QVector<int> &rows = currentRows();
+        int firstNew = graphKeys.count();
+        for (int r = firstNew; r < rows.count(); r++) appendColumns(modelFrames->at(rows[r]), r);
+        bool needRefresh = (graphKeys.count() > firstNew);
+
+        if (ui->cbLiveMode->checkState() == Qt::Checked && currentFrameCount() > 0)
         {
-            currentPosition = frameCache.count() - 1;
+            currentPosition = currentFrameCount() - 1;
+            const CANFrame &frame = frameAt(currentPosition);
             memset(currBytes, 0, 64);
-            memcpy(currBytes, frameCache.at(currentPosition).payload().data(), frameCache.at(currentPosition).payload().length());
+            memcpy(currBytes, frame.payload().constData(), frame.payload().length());
             memcpy(refBytes, currBytes, 64);
 
         }
         if (needRefresh)
         {
-            for (int k = 0; k < dataLen; k++)
+            QVector<double> newKeys = graphKeys.mid(firstNew);
+            for (int k = 0; k < 8; k++)
             {
-                if (graphRef[k] && graphRef[k]->data())
-                    graphRef[k]->addData(newX[k], newY[k]);
+                if (graphRef[k]) graphRef[k]->addData(newKeys, byteColumns[k].mid(firstNew), keysSorted);
             }
-            ui->graphView->replot();
+            ui->graphView->replot(QCustomPlot::rpQueuedReplot);
             updateDataView();
-            if (ui->cbSync->checkState() == Qt::Checked) emit sendCenterTimeID(frameCache[currentPosition].frameId(), frameCache[currentPosition].timeStamp().microSeconds() / 1000000.0);
+            if (ui->cbSync->checkState() == Qt::Checked) emit sendCenterTimeID(currentID, frameAt(currentPosition).timeStamp().microSeconds() / 1000000.0);
         }
     }
     updateFrameLabel();
@@ -544,59 +525,18 @@ void FlowViewWindow::updatedFrames(int numFrames)
 void FlowViewWindow::removeAllGraphs()
 {
   ui->graphView->clearGraphs();
+  for (int i = 0; i < 8; i++) graphRef[i] = nullptr;
   ui->graphView->replot();
 }
 
+//The columns are already filled in by loadID() so a graph is just handed its byte's column
 void FlowViewWindow::createGraph(int byteNum)
 {
-    int tempVal;
-    double minval = 1000000.0, maxval = -100000.0;
-    const unsigned char *data;
-    const CANFrame *frame;
-
     qDebug() << "Create Graph " << byteNum;
 
-    bool graphByTime = ui->cbTimeGraph->isChecked();
-
-    int numEntries = frameCache.count();
-
-    x[byteNum].clear();
-    y[byteNum].clear();
-    x[byteNum].resize(numEntries);
-    y[byteNum].resize(numEntries);
-
-    for (int j = 0; j < numEntries; j++)
-    {
-        frame = &frameCache[j];
-        data = reinterpret_cast<const unsigned char *>(frame->payload().constData());
-        if (byteNum < frameCache[j].payload().length())
-            tempVal = data[byteNum];
-        else
-            tempVal = 0;
-
-        if (graphByTime)
-        {
-            if (secondsMode){
-                x[byteNum][j] = frame->timeStamp().microSeconds() / 1000000.0;
-            }
-            else
-            {
-                x[byteNum][j] = frame->timeStamp().microSeconds();
-            }
-        }
-        else
-        {
-            x[byteNum][j] = j;
-        }
-
-        y[byteNum][j] = tempVal;
-        if (y[byteNum][j] < minval) minval = y[byteNum][j];
-        if (y[byteNum][j] > maxval) maxval = y[byteNum][j];
-    }
-
     graphRef[byteNum] = ui->graphView->addGraph();
     ui->graphView->graph()->setName(QString("Graph %1").arg(ui->graphView->graphCount()-1));
-    ui->graphView->graph()->setData(x[byteNum],y[byteNum]);
+    ui->graphView->graph()->setData(graphKeys, byteColumns[byteNum], keysSorted);
     ui->graphView->graph()->setLineStyle(QCPGraph::lsLine); //connect points with lines
     QPen graphPen;
     graphPen.setColor(graphColors[byteNum]);
@@ -607,55 +547,122 @@ void FlowViewWindow::createGraph(int byteNum)
 
 void FlowViewWindow::refreshIDList()
 {
-    int id;
-    for (int i = 0; i < modelFrames->count(); i++)
+    idIndex.sync(*modelFrames);
+    const QList<uint32_t> &ids = idIndex.ids();
+    for (int i = foundID.count(); i < ids.count(); i++)
     {
-        CANFrame thisFrame = modelFrames->at(i);
-        id = thisFrame.frameId();
-        if (!foundID.contains(id))
-        {
-            foundID.append(id);
-            FilterUtility::createFilterItem(id, ui->listFrameID);
-        }
+        foundID.append(ids[i]);
+        FilterUtility::createFilterItem(ids[i], ui->listFrameID);
     }
     //default is to sort in ascending order
     ui->listFrameID->sortItems();
 }
 
+//The frame list changed in a way the index couldn't just follow along with. Row numbers from before mean nothing now
+//so the IDs get listed again and the ID that was shown is loaded again out of the new frames. Mostly this is the oldest
+//frames being dropped while capturing, so whoever is watching shouldn't notice: live mode stays on the newest frame,
+//otherwise the view stays on the frame with the same time stamp and playback keeps going
+void FlowViewWindow::reindex()
+{
+    uint32_t id = currentID;
+    bool showing = !graphKeys.isEmpty();
+    bool wasPlaying = playbackActive;
+    qint64 shownTime = (currentPosition < frameTimes.count()) ? frameTimes[currentPosition] : 0;
+    unsigned char oldRef[64];
+    memcpy(oldRef, refBytes, 64);
+
+    QSignalBlocker blocker(ui->listFrameID); //clearing the list would otherwise switch over to whatever ID is current then
+    ui->listFrameID->clear();
+    foundID.clear();
+    idIndex.clear();
+    refreshIDList();
+    for (int j = 0; j < ui->listFrameID->count(); j++)
+    {
+        if (FilterUtility::getIdAsInt(ui->listFrameID->item(j)) == id)
+        {
+            ui->listFrameID->setCurrentRow(j);
+            break;
+        }
+    }
+    blocker.unblock();
+
+    if (!showing) return;
+    loadID(id);
+    if (currentFrameCount() == 0) return;
+
+    if (ui->cbLiveMode->checkState() == Qt::Checked) currentPosition = currentFrameCount() - 1;
+    else
+    {
+        int pos = -1;
+        if (timesSorted)
+        {
+            QVector<qint64>::const_iterator it = std::lower_bound(frameTimes.constBegin(), frameTimes.constEnd(), shownTime);
+            if (it != frameTimes.constEnd()) pos = static_cast<int>(it - frameTimes.constBegin());
+        }
+        else pos = frameTimes.indexOf(shownTime);
+        if (pos < 0) pos = (timesSorted) ? currentFrameCount() - 1 : 0; //gone or past the end, get as close as possible
+        currentPosition = pos;
+        memcpy(refBytes, oldRef, 64);
+    }
+
+    const CANFrame &frame = frameAt(currentPosition);
+    memset(currBytes, 0, 64);
+    memcpy(currBytes, frame.payload().constData(), frame.payload().length());
+    if (ui->cbLiveMode->checkState() == Qt::Checked) memcpy(refBytes, currBytes, 64);
+    updateDataView();
+    updateFrameLabel();
+
+    if (wasPlaying)
+    {
+        playbackActive = true;
+        playbackTimer->start();
+    }
+}
+
 void FlowViewWindow::updateFrameLabel()
 {
-    ui->lblNumFrames->setText(QString::number(currentPosition) + tr(" of ") + QString::number(frameCache.count()));
+    ui->lblNumFrames->setText(QString::number(currentPosition) + tr(" of ") + QString::number(currentFrameCount()));
 }
 
 void FlowViewWindow::changeID(QString newID)
 {
     qDebug() << "change id " << newID;
-    //parse the ID and then load up the frame cache with just messages with that ID.
-    uint32_t id = (uint32_t)Utility::ParseStringToNum(newID);
-    frameCache.clear();
+    loadID((uint32_t)Utility::ParseStringToNum(newID));
+}
+
+//Switches over to the frames of another ID. They come straight out of the index, nothing else gets looked at
+void FlowViewWindow::loadID(uint32_t id)
+{
+    currentID = id;
+    graphKeys.clear();
+    for (int k = 0; k < 8; k++) byteColumns[k].clear();
+    frameTimes.clear();
+    timesSorted = true;
+    keysSorted = true;
 
     if (modelFrames->count() == 0) return;
 
     playbackTimer->stop();
     playbackActive = false;
+
+    idIndex.sync(*modelFrames);
+    const QVector<int> &rows = currentRows();
+    graphKeys.reserve(rows.count());
+    for (int k = 0; k < 8; k++) byteColumns[k].reserve(rows.count());
+    frameTimes.reserve(rows.count());
     int maxBytes = 0;
-    for (int x = 0; x < modelFrames->count(); x++)
+    for (int r = 0; r < rows.count(); r++)
     {
-        CANFrame thisFrame = modelFrames->at(x);
-        if (thisFrame.frameId() == id)
-        {
-            thisFrame.payload().clear();
-            frameCache.append(thisFrame);
-            if (thisFrame.payload().length() > maxBytes) maxBytes = thisFrame.payload().length();
-        }
+        const CANFrame &frame = modelFrames->at(rows[r]);
+        if (frame.payload().length() > maxBytes) maxBytes = frame.payload().length();
+        appendColumns(frame, r);
     }
     ui->flowView->setBytesToDraw(maxBytes);
     currentPosition = 0;
 
-    if (frameCache.count() == 0) return;
-
     removeAllGraphs();
-    //for (uint32_t c = 0; c < frameCache.at(0).len; c++)
+    if (rows.count() == 0) return;
+
     for (uint32_t c = 0; c < 8; c++)
     {
         createGraph(c);
@@ -663,8 +670,9 @@ void FlowViewWindow::changeID(QString newID)
 
     updateGraphLocation();
 
+    const CANFrame &first = frameAt(currentPosition);
     memset(currBytes, 0, 64);
-    memcpy(currBytes, frameCache.at(currentPosition).payload().constData(), frameCache.at(currentPosition).payload().length());
+    memcpy(currBytes, first.payload().constData(), first.payload().length());
     memcpy(refBytes, currBytes, 64);
 
     updateDataView();
@@ -678,6 +686,43 @@ void FlowViewWindow::changeID(QString newID)
     ui->check_7->setChecked(true);
 }
 
+//Adds the frame at position pos of the current ID to the graph columns. Frames normally come in time order but nothing
+//guarantees it, so the columns keep track of whether they still are. Both the graphs and the time lookups can only take
+//the fast path while they are
+void FlowViewWindow::appendColumns(const CANFrame &frame, int pos)
+{
+    qint64 time = frame.timeStamp().microSeconds();
+    if (!frameTimes.isEmpty() && time < frameTimes.last()) timesSorted = false;
+    frameTimes.append(time);
+
+    if (ui->cbTimeGraph->isChecked())
+    {
+        if (secondsMode) graphKeys.append(time / 1000000.0);
+        else graphKeys.append(time);
+        keysSorted = timesSorted;
+    }
+    else graphKeys.append(pos);
+
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(frame.payload().constData());
+    int dataLen = frame.payload().length();
+    for (int k = 0; k < 8; k++) byteColumns[k].append((k < dataLen) ? data[k] : 0);
+}
+
+const QVector<int> &FlowViewWindow::currentRows() const
+{
+    return idIndex.rows(currentID);
+}
+
+int FlowViewWindow::currentFrameCount() const
+{
+    return graphKeys.count(); //only what made it into the columns so far, the index might be a step ahead
+}
+
+const CANFrame &FlowViewWindow::frameAt(int pos) const
+{
+    return modelFrames->at(currentRows().at(pos));
+}
+
 void FlowViewWindow::btnBackOneClick()
 {
     ui->cbLiveMode->setChecked(false);
@@ -710,9 +755,11 @@ void FlowViewWindow::btnStopClick()
     playbackTimer->stop(); //pushing this button halts automatic playback
     playbackActive = false;
     currentPosition = 0;
+    if (currentFrameCount() == 0) return;
 
+    const CANFrame &frame = frameAt(currentPosition);
     memset(currBytes, 0, 64);
-    memcpy(currBytes, frameCache.at(currentPosition).payload().constData(), frameCache.at(currentPosition).payload().length());
+    memcpy(currBytes, frame.payload().constData(), frame.payload().length());
     memcpy(refBytes, currBytes, 64);
 
     updateFrameLabel();
@@ -767,7 +814,7 @@ void FlowViewWindow::timerTriggered()
     if (!ui->cbLoopPlayback->isChecked())
     {
         if (currentPosition == 0) playbackActive = false;
-        if (currentPosition == (frameCache.count() - 1)) playbackActive = false;
+        if (currentPosition == (currentFrameCount() - 1)) playbackActive = false;
     }
 }
 
@@ -795,7 +842,7 @@ void FlowViewWindow::updateDataView()
     ui->flowView->setReference(refBytes, false);
     ui->flowView->updateData(currBytes, true);
 
-    ui->timelineSlider->setMaximum(frameCache.count() - 1);
+    ui->timelineSlider->setMaximum(currentFrameCount() - 1);
     ui->timelineSlider->setValue(currentPosition);
 
     for (int i = 0; i < 8; i++)
@@ -815,24 +862,32 @@ void FlowViewWindow::updateDataView()
 }
 
 void FlowViewWindow::gotoFrame(int frame) {
-    if (frameCache.count() >= frame) currentPosition = frame;
+    if (frame == currentPosition) return; //just the slider following playback, which took care of everything already
+    if (frame >= 0 && frame < currentFrameCount()) currentPosition = frame;
     else currentPosition = 0;
 
-    if (ui->cbSync->checkState() == Qt::Checked) emit sendCenterTimeID(frameCache[currentPosition].frameId(), frameCache[currentPosition].timeStamp().microSeconds() / 1000000.0);
+    if (ui->cbSync->checkState() == Qt::Checked && currentFrameCount() > 0) emit sendCenterTimeID(currentID, frameAt(currentPosition).timeStamp().microSeconds() / 1000000.0);
 }
 
 void FlowViewWindow::updatePosition(bool forward)
 {
+    //old frames can get dropped from the front of the list while playing back a live capture. Cheap to check for
+    if (idIndex.sync(*modelFrames))
+    {
+        reindex();
+        return;
+    }
+    if (currentFrameCount() == 0) return;
 
     if (forward)
     {
-        if (currentPosition < (frameCache.count() - 1)) currentPosition++;
+        if (currentPosition < (currentFrameCount() - 1)) currentPosition++;
         else if (ui->cbLoopPlayback->isChecked()) currentPosition = 0;
     }
     else
     {
         if (currentPosition > 0) currentPosition--;
-        else if (ui->cbLoopPlayback->isChecked()) currentPosition = frameCache.count() - 1;
+        else if (ui->cbLoopPlayback->isChecked()) currentPosition = currentFrameCount() - 1;
     }
 
     if (ui->cbAutoRef->isChecked())
@@ -840,76 +895,55 @@ void FlowViewWindow::updatePosition(bool forward)
         memcpy(refBytes, currBytes, 64);
     }
 
+    const CANFrame &frame = frameAt(currentPosition);
+    const unsigned char *data = reinterpret_cast<const unsigned char *>(frame.payload().constData());
+    int dataLen = frame.payload().length();
+
     //figure out which bits changed since the previous frame and then AND that with the trigger bits. If any bits
     //get through that then they're changed and a trigger so we stop playback at this frame.
     //This is complicated by the fact that CAN-FD frames might have far more than 64 bits. It is necessary
     //to thus process them 64 bits at a time and just move chunk to chunk until done.
-    for (int chunk = 0; chunk < frameCache.at(currentPosition).payload().length(); chunk += 8)
+    for (int chunk = 0; chunk < dataLen; chunk += 8)
     {
         uint64_t changedBits = 0;
         uint8_t cngByte;
-        int maxVal = qMin(chunk * 8 + 8, frameCache.at(currentPosition).payload().length());
-        for (int i = chunk * 8; i < maxVal; i++)
+        int maxVal = qMin(chunk + 8, dataLen);
+        for (int i = chunk; i < maxVal; i++)
         {
-            unsigned char thisByte = static_cast<unsigned char>(frameCache.at(currentPosition).payload().data()[i]);
-            cngByte = currBytes[i] ^ thisByte;
+            cngByte = currBytes[i] ^ data[i];
             changedBits |= (uint64_t)cngByte << (8ull * (i & 7));
         }
 
-        qDebug() << "ChangedBits: " << QString::number(changedBits, 16);
-        qDebug() << "TriggerBits: " << QString::number(triggerBits[chunk / 8], 16);
         changedBits &= triggerBits[chunk / 8];
-        qDebug() << "Final ChangedBits: " << QString::number(changedBits, 16);
         if (changedBits)
         {
+            qDebug() << "Trigger bits changed: " << QString::number(changedBits, 16);
             playbackActive = false;
             playbackTimer->stop();
         }
     }
     memset(currBytes, 0, 64);
-    memcpy(currBytes, frameCache.at(currentPosition).payload().constData(), frameCache.at(currentPosition).payload().length());
+    memcpy(currBytes, data, dataLen);
 
-    if (ui->cbSync->checkState() == Qt::Checked) emit sendCenterTimeID(frameCache[currentPosition].frameId(), frameCache[currentPosition].timeStamp().microSeconds() / 1000000.0);
+    if (ui->cbSync->checkState() == Qt::Checked) emit sendCenterTimeID(currentID, frame.timeStamp().microSeconds() / 1000000.0);
     ui->timelineSlider->setValue(currentPosition);
 }
 
+//The columns hold the x of every frame in whatever mode the graphs were built in so the range can come straight from there
 void FlowViewWindow::updateGraphLocation()
 {
-    if (frameCache.count() == 0) return;
+    if (graphKeys.count() == 0) return;
     int start = currentPosition - ui->graphRangeSlider->value();
     if (start < 0) start = 0;
     int end = currentPosition + ui->graphRangeSlider->value();
-    if (end >= frameCache.count()) end = frameCache.count() - 1;
-    if (ui->cbTimeGraph->isChecked())
-    {
-        if (secondsMode)
-        {
-            ui->graphView->xAxis->setRange(frameCache[start].timeStamp().microSeconds() / 1000000.0, frameCache[end].timeStamp().microSeconds() / 1000000.0);
-            /*
-            ui->graphView->xAxis->setTickStep((frameCache[end].timeStamp().microSeconds() - frameCache[start].timeStamp().microSeconds())/ 3000000.0);
-            ui->graphView->xAxis->setSubTickCount(0);
-            ui->graphView->xAxis->setNumberFormat("f");
-            ui->graphView->xAxis->setNumberPrecision(6);
-            */
-        }
-        else
-        {
-            ui->graphView->xAxis->setRange(frameCache[start].timeStamp().microSeconds(), frameCache[end].timeStamp().microSeconds());
-            /*
-            ui->graphView->xAxis->setTickStep((frameCache[end].timeStamp().microSeconds() - frameCache[start].timeStamp().microSeconds())/ 3.0);
-            ui->graphView->xAxis->setSubTickCount(0);
-            ui->graphView->xAxis->setNumberFormat("f");
-            ui->graphView->xAxis->setNumberPrecision(0); */
-        }
-    }
-    else
+    if (end >= graphKeys.count()) end = graphKeys.count() - 1;
+    ui->graphView->xAxis->setRange(graphKeys[start], graphKeys[end]);
+    if (!ui->cbTimeGraph->isChecked())
     {
-        ui->graphView->xAxis->setRange(start, end);
-        //ui->graphView->xAxis->setTickStep(5.0);
-        //ui->graphView->xAxis->setSubTickCount(0);
         ui->graphView->xAxis->setNumberFormat("gb");
     }
 
-    ui->graphView->replot();
+    //queued so playback steps faster than the plot can be drawn don't pile up replots
+    ui->graphView->replot(QCustomPlot::rpQueuedReplot);
 }
 
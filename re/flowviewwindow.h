@@ -6,6 +6,7 @@
 #include <QSlider>
 #include "qcustomplot.h"
 #include "can_structs.h"
+#include "utils/frameidindex.h"
 
 namespace Ui {
 class FlowViewWindow;
@@ -48,9 +49,10 @@ signals:
 
 private:
     Ui::FlowViewWindow *ui;
-    QList<quint32> foundID;
-    QList<CANFrame> frameCache;
+    QList<quint32> foundID; //always the first so many of idIndex.ids()
     const QVector<CANFrame> *modelFrames;
+    FrameIDIndex idIndex;
+    uint32_t currentID;
     unsigned char refBytes[64];
     unsigned char currBytes[64];
     int triggerValues[8];
@@ -63,10 +65,20 @@ private:
     bool secondsMode;
     bool openGLMode;
     bool useHexTicker;
-    QVector<double> x[8], y[8];
+    QVector<double> graphKeys; //x of every frame of the current ID
+    QVector<double> byteColumns[8]; //and the value of each of its first 8 bytes, 0 past the end of the payload
+    QVector<qint64> frameTimes; //and its time stamp in microseconds
+    bool timesSorted; //frameTimes never goes backwards. Merged or hand edited captures can break that
+    bool keysSorted; //graphKeys never goes backwards. Always true when graphing against frame number
     QCPGraph *graphRef[8];
 
     void refreshIDList();
+    void loadID(uint32_t id);
+    void reindex();
+    void appendColumns(const CANFrame &frame, int pos);
+    const QVector<int> &currentRows() const;
+    int currentFrameCount() const;
+    const CANFrame &frameAt(int pos) const;
     void updateFrameLabel();
     void updatePosition(bool forward);
     void gotoFrame(int frame);
@@ -6,6 +6,7 @@
 #include <vector>
 #include "filterutility.h"
 #include "qcpaxistickerhex.h"
+#include "utils/plotrendering.h"
 
 const QColor FrameInfoWindow::byteGraphColors[8] = {Qt::blue, Qt::green,  Qt::black, Qt::red, //0 1 2 3
                                                     Qt::gray, Qt::darkYellow, Qt::cyan,  Qt::darkMagenta}; //4 5 6 7
@@ -95,20 +96,8 @@ FrameInfoWindow::FrameInfoWindow(const QVector<CANFrame> *frames, QWidget *paren
     ui->timeHistogram->legend->setVisible(false);
     ui->timeHistogram->setBufferDevicePixelRatio(1);
 
-    if (useOpenGL)
-    {
-        graphHistogram->setAntialiasedElements(QCP::aeAll);
-        graphHistogram->setOpenGl(true);
-        ui->timeHistogram->setAntialiasedElements(QCP::aeAll);
-        ui->timeHistogram->setOpenGl(true);
-    }
-    else
-    {
-        graphHistogram->setOpenGl(false);
-        graphHistogram->setAntialiasedElements(QCP::aeNone);
-        ui->timeHistogram->setOpenGl(false);
-        ui->timeHistogram->setAntialiasedElements(QCP::aeNone);
-    }
+    PlotRendering::setup(graphHistogram, useOpenGL);
+    PlotRendering::setup(ui->timeHistogram, useOpenGL);
 
     // Prevent annoying accidental horizontal scrolling when filter list is populated with long interpreted message names
     ui->listFrameID->horizontalScrollBar()->setEnabled(false);
@@ -151,16 +140,7 @@ void FrameInfoWindow::setupByteGraph(QCustomPlot *plot, int num)
     plot->legend->setVisible(false);
     plot->setBufferDevicePixelRatio(1);
 
-    if (useOpenGL)
-    {
-        plot->setAntialiasedElements(QCP::aeAll);
-        plot->setOpenGl(true);
-    }
-    else
-    {
-        plot->setOpenGl(false);
-        plot->setAntialiasedElements(QCP::aeNone);
-    }
+    PlotRendering::setup(plot, useOpenGL);
 
     connect(plot, SIGNAL(mousePress(QMouseEvent*)), this, SLOT(mousePress()));
     connect(plot, SIGNAL(mouseWheel(QWheelEvent*)), this, SLOT(mouseWheel()));
@@ -586,21 +566,13 @@ void FrameInfoWindow::updateDetailsWindow(QString newID)
             //how many messages contained each discrete value.
             if (msg)
             {
-                int numSignals = msg->sigHandler->getCount();
-                for (int i = 0; i < numSignals; i++)
+                QVector<DBC_DECODED_SIGNAL> decoded;
+                msg->sigHandler->decodeFrame(frameCache.at(j), decoded);
+                for (int i = 0; i < decoded.count(); i++)
                 {
-                    DBC_SIGNAL *sig = msg->sigHandler->findSignalByIdx(i);
-                    if (sig)
-                    {
-                        if (sig->isSignalInMessage(frameCache.at(j)))
-                        {
-                            QString sigVal;
-                            if (sig->processAsText(frameCache.at(j), sigVal, false))
-                            {
-                                signalInstances[sig->name][sigVal] = signalInstances[sig->name][sigVal] + 1;
-                            }
-                        }
-                    }
+                    DBC_SIGNAL *sig = decoded[i].signal;
+                    QString sigVal = sig->makePrettyOutput(decoded[i].value, false);
+                    signalInstances[sig->name][sigVal] = signalInstances[sig->name][sigVal] + 1;
                 }
             }
         }
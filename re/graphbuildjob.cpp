@@ -0,0 +1,242 @@
+#include "graphbuildjob.h"
+#include "utility.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+
+//frames worked through between two progress updates
+#define GRAPH_BUILD_CHUNK   262144
+
+//frames per piece handed to each thread within a chunk
+#define GRAPH_SCAN_CHUNK    16384
+
+struct GraphScanPiece
+{
+    int first;
+    int last;
+    QVector<QVector<int>> matches; //per graph, indices of the frames it wants
+};
+
+//x value of a frame the same way every graph is laid out, honoring the timestamp display style. Live frames go through
+//here too (GraphingWindow::appendToGraph) so points added after a build line up with the ones the build made
+double GraphBuildJob::graphKey(const CANFrame &frame, double xbias)
+{
+    if (Utility::timeStyle == TS_SECONDS)
+    {
+        return (frame.timeStamp().microSeconds() / 1000000.0) - xbias;
+    }
+    else if (Utility::timeStyle == TS_CLOCK)
+    {
+        QDateTime dt = QDateTime::fromMSecsSinceEpoch((frame.timeStamp().microSeconds() / 1000) - xbias);
+        return (dt.time().msecsSinceStartOfDay() / 1000.0);
+    }
+    return frame.timeStamp().microSeconds() - xbias;
+}
+
+GraphBuildJob::GraphBuildJob(const QVector<CANFrame> &frames, QSharedPointer<const DBCSnapshot> dbc, const QVector<GraphBuildSpec> &specs)
+    : frames(frames), frameCount(frames.count()), dbc(dbc), specs(specs), cancelled(0), framesDone(0)
+{
+    for (int g = 0; g < specs.count(); g++) wanted.insert(specs[g].buildId);
+}
+
+void GraphBuildJob::start()
+{
+    connect(&watcher, SIGNAL(finished()), this, SIGNAL(finished()));
+    watcher.setFuture(QtConcurrent::run([this]()
+    {
+        run();
+        frames = QVector<CANFrame>(); //let go of the shared list before finished() so it can be appended to again
+    }));
+}
+
+void GraphBuildJob::cancel()
+{
+    QMutexLocker locker(&lock);
+    cancelled.storeRelease(1);
+    pending.clear();
+}
+
+void GraphBuildJob::dropGraph(int buildId)
+{
+    QMutexLocker locker(&lock);
+    wanted.remove(buildId);
+    if (wanted.isEmpty()) cancelled.storeRelease(1);
+}
+
+bool GraphBuildJob::hasGraph(int buildId) const
+{
+    QMutexLocker locker(&lock);
+    return wanted.contains(buildId);
+}
+
+bool GraphBuildJob::isDone() const
+{
+    return watcher.isFinished();
+}
+
+QVector<GraphBuildResult> GraphBuildJob::takeResults()
+{
+    QMutexLocker locker(&lock);
+    QVector<GraphBuildResult> out;
+    out.swap(pending);
+    return out;
+}
+
+int GraphBuildJob::getFrameCount() const
+{
+    return frameCount;
+}
+
+int GraphBuildJob::getFramesDone() const
+{
+    return framesDone.loadAcquire();
+}
+
+//One frame's worth of a graph. Value table descriptions are run length encoded into spans like ValueLabelLayer::append() does
+void GraphBuildJob::addPoint(const GraphBuildSpec &spec, GraphState &state, const CANFrame &frame, GraphBuildResult &result) const
+{
+    //don't add this to the graph if the signal isn't in this frame
+    if (spec.signal && !spec.signal->isSignalInMessage(frame)) return;
+
+    int64_t tempVal = spec.extractor.extract(frame.payload()); //& params.mask;
+    double x = graphKey(frame, spec.xbias);
+    double y = (tempVal * spec.scale) + spec.bias;
+    result.keys.append(x);
+    result.values.append(y);
+
+    QString tempStr;
+    if (spec.signal && spec.signal->getValueString(tempVal, tempStr))
+    {
+        if (state.spanOpen && tempStr == state.span.text)
+        {
+            state.span.end = x;
+            return;
+        }
+        if (state.spanOpen)
+        {
+            state.span.end = x;
+            result.spans.append(state.span);
+        }
+        state.spanOpen = true;
+        state.span.start = x;
+        state.span.end = x;
+        state.span.y = y;
+        state.span.text = tempStr;
+    }
+}
+
+void GraphBuildJob::run()
+{
+    QHash<uint32_t, QVector<int>> graphsByID;
+    QVector<GraphState> states(specs.count());
+    for (int g = 0; g < specs.count(); g++)
+    {
+        graphsByID[specs.at(g).ID].append(g);
+        states[g].matchCount = 0;
+        states[g].spanOpen = false;
+    }
+
+    QVector<bool> skip(specs.count());
+    for (int start = 0; start <= frames.count(); start += GRAPH_BUILD_CHUNK)
+    {
+        if (cancelled.loadAcquire()) return;
+
+        {
+            QMutexLocker locker(&lock);
+            for (int g = 0; g < specs.count(); g++) skip[g] = !wanted.contains(specs.at(g).buildId);
+        }
+
+        int end = qMin(start + GRAPH_BUILD_CHUNK, frames.count());
+        bool lastChunk = (end == frames.count());
+
+        QVector<GraphScanPiece> pieces;
+        for (int first = start; first < end; first += GRAPH_SCAN_CHUNK)
+        {
+            GraphScanPiece piece;
+            piece.first = first;
+            piece.last = qMin(first + GRAPH_SCAN_CHUNK, end) - 1;
+            pieces.append(piece);
+        }
+
+        QtConcurrent::blockingMap(pieces, [this, &graphsByID, &skip](GraphScanPiece &piece)
+        {
+            piece.matches.resize(specs.count());
+            for (int i = piece.first; i <= piece.last; i++)
+            {
+                const CANFrame &frame = frames.at(i);
+                if (frame.frameType() != QCanBusFrame::DataFrame) continue;
+
+                QHash<uint32_t, QVector<int>>::const_iterator it = graphsByID.constFind(frame.frameId());
+                if (it == graphsByID.constEnd()) continue;
+
+                const QVector<int> &candidates = it.value();
+                for (int c = 0; c < candidates.count(); c++)
+                {
+                    int g = candidates[c];
+                    if (skip.at(g)) continue;
+                    if (specs.at(g).bus == -1 || specs.at(g).bus == frame.bus) piece.matches[g].append(i);
+                }
+            }
+        });
+
+        QVector<GraphBuildResult> results(specs.count());
+        QVector<int> jobs(specs.count());
+        for (int g = 0; g < specs.count(); g++) jobs[g] = g;
+
+        QtConcurrent::blockingMap(jobs, [this, &pieces, &states, &results, &skip, lastChunk](int g)
+        {
+            const GraphBuildSpec &spec = specs.at(g);
+            GraphState &state = states[g];
+            GraphBuildResult &result = results[g];
+            result.buildId = spec.buildId;
+            result.finished = lastChunk;
+            if (skip.at(g)) return;
+
+            int stride = qMax(spec.stride, 1);
+            for (int p = 0; p < pieces.count(); p++)
+            {
+                const QVector<int> &matches = pieces.at(p).matches.at(g);
+                for (int m = 0; m < matches.count(); m++)
+                {
+                    if ((state.matchCount++ % stride) != 0) continue;
+                    addPoint(spec, state, frames.at(matches[m]), result);
+                }
+            }
+
+            if (!lastChunk) return;
+
+            //to fix weirdness where a graph that has no data won't be able to be edited, selected, or deleted properly
+            //we'll check for the condition that there is nothing to graph and graph a single dummy frame instead
+            //that has all data bytes = 0. This allows the graph to be edited and deleted. No idea why you can't otherwise.
+            if (state.matchCount == 0)
+            {
+                CANFrame dummy;
+                dummy.setFrameId(spec.ID);
+                dummy.bus = 0;
+                dummy.setPayload(QByteArray(8, 0));
+                dummy.setFrameType(QCanBusFrame::DataFrame);
+                addPoint(spec, state, dummy, result);
+            }
+
+            if (state.spanOpen) result.spans.append(state.span);
+        });
+
+        framesDone.storeRelease(end);
+
+        {
+            QMutexLocker locker(&lock);
+            if (cancelled.loadAcquire()) return;
+            for (int g = 0; g < specs.count(); g++)
+            {
+                const GraphBuildResult &result = results[g];
+                if (!wanted.contains(result.buildId)) continue;
+                if (result.finished || !result.keys.isEmpty() || !result.spans.isEmpty()) pending.append(result);
+            }
+        }
+        emit resultsReady();
+
+        if (lastChunk) break;
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef GRAPHBUILDJOB_H
+#define GRAPHBUILDJOB_H
+
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+#include "can_structs.h"
+#include "dbc/dbcsnapshot.h"
+#include "utils/bitextractor.h"
+
+//Everything a GraphBuildJob needs to know about one graph. Copied out of GraphParams on the GUI thread
+struct GraphBuildSpec
+{
+    int buildId;                    //GraphParams::buildId of the graph this is for
+    uint32_t ID;
+    int bus;                        //-1 for any bus
+    BitExtractor extractor;
+    double scale;
+    double bias;
+    double xbias;
+    int stride;
+    const DBC_SIGNAL *signal;       //out of the job's DBC snapshot, never the live signal. nullptr if there isn't one
+};
+
+//A run of points with the same value table description, from the x coordinate start to end at the height of the first point
+struct GraphLabelSpan
+{
+    double start;
+    double end;
+    double y;
+    QString text;
+};
+
+//New points and labels for one graph. Results for a graph are handed over in frame order
+struct GraphBuildResult
+{
+    int buildId;
+    QVector<double> keys;
+    QVector<double> values;
+    QVector<GraphLabelSpan> spans;
+    bool finished;                  //the last result for this graph. Its last span is the one live frames carry on
+};
+
+/*
+ * Builds the points and value table labels of a set of graphs on a worker thread so the GUI stays responsive while a big
+ * capture is graphed. The job works on its own copy of the frame list (implicitly shared, so taking it is cheap, and any
+ * later change to the capture detaches from it) and on a DBC snapshot, so nothing it reads can change underneath it.
+ * Detaching copies the whole capture, so whoever owns the list should hold off appending to it until finished() and
+ * the copy is let go of as soon as run() is done with it.
+ * The frames are processed in chunks. Within a chunk they are matched to graphs by ID in parallel, then each graph's
+ * values are extracted, in parallel across graphs. After every chunk the new points are queued up and resultsReady()
+ * is emitted so the window can show them while the rest is still being worked on.
+ * All public functions are meant to be called from the thread that created the job.
+*/
+class GraphBuildJob : public QObject
+{
+    Q_OBJECT
+public:
+    GraphBuildJob(const QVector<CANFrame> &frames, QSharedPointer<const DBCSnapshot> dbc, const QVector<GraphBuildSpec> &specs);
+
+    void start();
+    //stop as soon as possible. No more results are handed out after this
+    void cancel();
+    //results for this graph aren't wanted any more. Cancels the job once no graph is left
+    void dropGraph(int buildId);
+    bool hasGraph(int buildId) const;
+    bool isDone() const;
+    QVector<GraphBuildResult> takeResults();
+    int getFrameCount() const;
+    int getFramesDone() const;
+
+    static double graphKey(const CANFrame &frame, double xbias);
+
+signals:
+    void resultsReady();
+    void finished();    //emitted once run() has returned, cancelled or not
+
+private:
+    struct GraphState
+    {
+        int matchCount;
+        bool spanOpen;                  //span below is still growing, it is only handed over once the description changes
+        GraphLabelSpan span;
+    };
+
+    QVector<CANFrame> frames;           //only touched by run() once the job is started
+    int frameCount;
+    QSharedPointer<const DBCSnapshot> dbc;
+    QVector<GraphBuildSpec> specs;
+    QAtomicInt cancelled;
+    QAtomicInt framesDone;
+    mutable QMutex lock;                //guards everything below
+    QSet<int> wanted;
+    QVector<GraphBuildResult> pending;
+    QFutureWatcher<void> watcher;
+
+    void run();
+    void addPoint(const GraphBuildSpec &spec, GraphState &state, const CANFrame &frame, GraphBuildResult &result) const;
+};
+
+#endif // GRAPHBUILDJOB_H
@@ -4,6 +4,7 @@
 #include "mainwindow.h"
 #include "helpwindow.h"
 #include "utility.h"
+#include "utils/plotrendering.h"
 #include <QDebug>
 
 #include <algorithm>
@@ -11,7 +12,8 @@
 
 GraphingWindow::GraphingWindow(const QVector<CANFrame> *frames, QWidget *parent) :
     QDialog(parent),
-    ui(new Ui::GraphingWindow)
+    ui(new Ui::GraphingWindow),
+    replotScheduler(this, [this]() { liveReplot(); })
 {
     ui->setupUi(this);
     setWindowFlags(Qt::Window);
@@ -84,6 +86,13 @@ GraphingWindow::GraphingWindow(const QVector<CANFrame> *frames, QWidget *parent)
     connect(ui->graphingView, SIGNAL(legendClick(QCPLegend*,QCPAbstractLegendItem*,QMouseEvent*)), this, SLOT(legendSingleClick(QCPLegend*,QCPAbstractLegendItem*)));
 
     connect(MainWindow::getReference(), SIGNAL(framesUpdated(int)), this, SLOT(updatedFrames(int)));
+    //the graphs are handed just the points needed for the current view right before every replot
+    connect(ui->graphingView, SIGNAL(beforeReplot()), this, SLOT(renderVisible()));
+
+    progressText = nullptr;
+    nextBuildId = 0;
+    exportJob = nullptr;
+    exportProgress = nullptr;
 
     // setup policy and connect slot for context menu popup:
     ui->graphingView->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -95,20 +104,13 @@ GraphingWindow::GraphingWindow(const QVector<CANFrame> *frames, QWidget *parent)
 
     //ui->graphingView->setAttribute(Qt::WA_AcceptTouchEvents);
 
-    if (useOpenGL)
+    if (PlotRendering::setup(ui->graphingView, useOpenGL))
     {
         //Fix the device pixel ratio for openGL so the graph doesn't render double sized
         ui->graphingView->setBufferDevicePixelRatio(1);
-        
-        ui->graphingView->setAntialiasedElements(QCP::aeAll);
         //ui->graphingView->setNoAntialiasingOnDrag(true);
-        ui->graphingView->setOpenGl(true);
-    }
-    else
-    {
-        ui->graphingView->setOpenGl(false);
-        ui->graphingView->setAntialiasedElements(QCP::aeNone);
     }
+    PlotRendering::addFrameTimeReadout(ui->graphingView);
 
     needScaleSetup = true;
     followGraphEnd = false;
@@ -116,6 +118,8 @@ GraphingWindow::GraphingWindow(const QVector<CANFrame> *frames, QWidget *parent)
 
 GraphingWindow::~GraphingWindow()
 {
+    cancelGraphBuilds();
+    cancelSpreadsheet();
     delete ui;
 }
 
@@ -164,6 +168,7 @@ void GraphingWindow::readSettings()
     }
 
     useOpenGL = settings.value("Main/UseOpenGL", false).toBool();
+    replotScheduler.readSettings();
 }
 
 void GraphingWindow::writeSettings()
@@ -179,9 +184,6 @@ void GraphingWindow::writeSettings()
 
 void GraphingWindow::updatedFrames(int numFrames)
 {
-    CANFrame thisFrame;
-    QVector<double> x, y;
-    bool appendedToGraph = false;
     bool needReplot = false;
 
     if (numFrames == -1) //all frames deleted. Kill the display
@@ -190,11 +192,7 @@ void GraphingWindow::updatedFrames(int numFrames)
         //now instead of removing the graphs regenerate them which will blank them out but leave them there in case
         //more traffic that matches comes in or someone otherwise loads more data
         ui->graphingView->clearGraphs(); //temporarily remove the graphs from the graph view
-        for (int i = 0; i < graphParams.count(); i++)
-        {
-            createGraph(graphParams[i], false); //regenerate each one
-        }
-        ui->graphingView->replot(); //now, redisplay them all
+        regenerateGraphs(); //then regenerate all of them in one go and redisplay them
 
     }
     else if (numFrames == -2) //all new set of frames. Reset
@@ -203,58 +201,62 @@ void GraphingWindow::updatedFrames(int numFrames)
         //regenerate them instead
         ui->graphingView->clearGraphs(); //temporarily remove the graphs from the graph view
         //needScaleSetup = true;
-        for (int i = 0; i < graphParams.count(); i++)
-        {
-            createGraph(graphParams[i], false); //regenerate each one
-        }
-        ui->graphingView->replot(); //now, redisplay them all
+        regenerateGraphs(); //then regenerate all of them in one go and redisplay them
     }
     else //just got some new frames. See if they are relevant.
     {  
         if (numFrames > modelFrames->count()) return;
 
-        for (int j = 0; j < graphParams.count(); j++)
+        for (int i = modelFrames->count() - numFrames; i < modelFrames->count(); i++)
         {
-            appendedToGraph = false;
-            x.clear();
-            y.clear();
-            for (int i = modelFrames->count() - numFrames; i < modelFrames->count(); i++)
+            const CANFrame &thisFrame = modelFrames->at(i);
+            QHash<uint32_t, QVector<int>>::const_iterator it = graphsByID.constFind(thisFrame.frameId());
+            if (it == graphsByID.constEnd()) continue;
+
+            const QVector<int> &candidates = it.value();
+            for (int c = 0; c < candidates.count(); c++)
             {
-                thisFrame = modelFrames->at(i);
-                if ( graphParams[j].ID == thisFrame.frameId() && ( (graphParams[j].bus == -1) || (graphParams[j].bus == thisFrame.bus) ) )
+                GraphParams &params = graphParams[candidates[c]];
+                if (params.building) continue; //gets these once it is built, see finishGraph()
+                if ( (params.bus == -1) || (params.bus == thisFrame.bus) )
                 {
-                    appendToGraph(graphParams[j], thisFrame, x, y);
-                    appendedToGraph = true;
+                    appendToGraph(params, thisFrame);
+                    needReplot = true;
                 }
             }
-            if (appendedToGraph)
-            {
-                graphParams[j].ref->addData(x, y);
-                needReplot = true;
-            }
         }
 
-        if (needReplot)
+        if (needReplot) replotScheduler.schedule();
+    }
+}
+
+//The replot replotScheduler decided it is time for
+void GraphingWindow::liveReplot()
+{
+    if (followGraphEnd)
+    {
+        //find the current X span and maintain that span but move the end of it over to match the new end
+        //of the actual graph. This causes the view to move with the data to always show the end
+        QCPRange range = ui->graphingView->xAxis->range();
+        double size = range.size();
+        double lower, upper;
+        if (graphParams.count() > 0 && graphParams.last().series.keyRange(lower, upper))
         {
-            if (followGraphEnd)
-            {
-                //find the current X span and maintain that span but move the end of it over to match the new end
-                //of the actual graph. This causes the view to move with the data to always show the end
-                QCPRange range = ui->graphingView->xAxis->range();
-                double size = range.size();
-                bool foundRange;
-                QCPRange keyRange = ui->graphingView->graph()->getKeyRange(foundRange);
-                if (foundRange)
-                {
-                    double end, start;
-                    end = keyRange.upper;
-                    start = end - size;
-                    ui->graphingView->xAxis->setRange(start, end);
-                }
-            }
-            ui->graphingView->replot();
+            double end, start;
+            end = upper;
+            start = end - size;
+            ui->graphingView->xAxis->setRange(start, end);
         }
     }
+
+    replotScheduler.replot(ui->graphingView);
+}
+
+//Which graphs want frames with which ID, so live frames are only ever compared against the graphs that could use them
+void GraphingWindow::rebuildDispatch()
+{
+    graphsByID.clear();
+    for (int i = 0; i < graphParams.count(); i++) graphsByID[graphParams[i].ID].append(i);
 }
 
 void GraphingWindow::plottableClick(QCPAbstractPlottable* plottable, int dataIdx, QMouseEvent* event)
@@ -504,14 +506,18 @@ void GraphingWindow::resetView()
 {
     double yminval=10000000.0, ymaxval = -1000000.0;
     double xminval=100000000000, xmaxval = -10000000000.0;
+    double lower, upper;
     for (int i = 0; i < graphParams.count(); i++)
     {
-        for (int j = 0; j < graphParams[i].x.count(); j++)
+        if (graphParams[i].series.keyRange(lower, upper))
+        {
+            if (lower < xminval) xminval = lower;
+            if (upper > xmaxval) xmaxval = upper;
+        }
+        if (graphParams[i].series.valueRange(lower, upper))
         {
-            if (graphParams[i].x[j] < xminval) xminval = graphParams[i].x[j];
-            if (graphParams[i].x[j] > xmaxval) xmaxval = graphParams[i].x[j];
-            if (graphParams[i].y[j] < yminval) yminval = graphParams[i].y[j];
-            if (graphParams[i].y[j] > ymaxval) ymaxval = graphParams[i].y[j];
+            if (lower < yminval) yminval = lower;
+            if (upper > ymaxval) ymaxval = upper;
         }
     }
 
@@ -578,17 +584,11 @@ void GraphingWindow::removeSelectedGraph()
             }
         }
 
-        foreach (QCPItemBracket* brk, graphParams[idx].brackets)
-        {
-            ui->graphingView->removeItem(brk);
-        }
-
-        foreach (QCPItemText* txt, graphParams[idx].bracketTexts)
-        {
-            ui->graphingView->removeItem(txt);
-        }
+        delete graphParams[idx].labels;
 
+        dropGraphBuild(graphParams[idx].buildId);
         graphParams.removeAt(idx);
+        rebuildDispatch();
 
         ui->graphingView->removeGraph(ui->graphingView->selectedGraphs().first());
 
@@ -627,17 +627,44 @@ void GraphingWindow::removeAllGraphs()
                                   QMessageBox::Yes|QMessageBox::No);
     if (confirmDialog == QMessageBox::Yes)
     {
+        cancelGraphBuilds();
         ui->graphingView->clearGraphs();
         ui->graphingView->clearItems();
+        progressText = nullptr; //went with the rest of the items
+        PlotRendering::addFrameTimeReadout(ui->graphingView);
+        for (int i = 0; i < graphParams.count(); i++) delete graphParams[i].labels;
         graphParams.clear();
+        rebuildDispatch();
         needScaleSetup = true;
         ui->graphingView->replot();
     }
 }
 
+//The graphs themselves only hold the points in view so the extents come from the full series instead
 void GraphingWindow::rescaleAxis(QCPAxis *axis)
 {
-    axis->rescale(true);
+    bool isKeyAxis = (axis->orientation() == Qt::Horizontal);
+    bool found = false;
+    QCPRange range;
+    double lower, upper;
+
+    for (int i = 0; i < graphParams.count(); i++)
+    {
+        if (!graphParams[i].ref || !graphParams[i].ref->visible()) continue;
+        bool ok = isKeyAxis ? graphParams[i].series.keyRange(lower, upper) : graphParams[i].series.valueRange(lower, upper);
+        if (!ok) continue;
+        if (found) range.expand(QCPRange(lower, upper));
+        else range = QCPRange(lower, upper);
+        found = true;
+    }
+    if (!found) return;
+
+    if (range.lower == range.upper) //single value, keep the current zoom and just center on it
+    {
+        double halfSize = axis->range().size() / 2.0;
+        range = QCPRange(range.lower - halfSize, range.upper + halfSize);
+    }
+    axis->setRange(range);
 }
 
 void GraphingWindow::rescaleToData()
@@ -721,6 +748,7 @@ void GraphingWindow::saveGraphs()
         filename = dialog.selectedFiles()[0];
         settings.setValue("Graphing/LoadSaveDirectory", dialog.directory().path());
 
+        PlotExportGuard guard(ui->graphingView); //no frame times or build progress in the saved image
         if (dialog.selectedNameFilter() == filters[0])
         {
             if (!filename.contains('.')) filename += ".pdf";
@@ -739,12 +767,40 @@ void GraphingWindow::saveGraphs()
     }
 }
 
+/*
+ * Exports the selected graphs, or all of them if none is selected, as a spreadsheet with one column per graph.
+ * The actual writing is done by a SpreadsheetExportJob in the background, see there for how the rows come about.
+*/
 void GraphingWindow::saveSpreadsheet()
 {
     QString filename;
     QFileDialog dialog(this);
     QSettings settings;
 
+    if (exportJob)
+    {
+        QMessageBox::information(this, "SavvyCAN Graphing", "A spreadsheet is still being saved.");
+        return;
+    }
+    if (!buildJobs.isEmpty())
+    {
+        QMessageBox::information(this, "SavvyCAN Graphing", "Graphs are still being built, try again once they're done.");
+        return;
+    }
+
+    QVector<SpreadsheetSeries> series;
+    QList<QCPGraph *> selected = ui->graphingView->selectedGraphs();
+    for (int i = 0; i < graphParams.count(); i++)
+    {
+        if (!selected.isEmpty() && !selected.contains(graphParams[i].ref)) continue;
+        SpreadsheetSeries ser;
+        ser.name = graphParams[i].graphName;
+        ser.keys = graphParams[i].series.keys();
+        ser.values = graphParams[i].series.values();
+        series.append(ser);
+    }
+    if (series.isEmpty()) return;
+
     QStringList filters;
     filters.append(QString(tr("Spreadsheet (*.csv)")));
 
@@ -761,110 +817,52 @@ void GraphingWindow::saveSpreadsheet()
 
         if (!filename.contains('.')) filename += ".csv";
 
-        QFile *outFile = new QFile(filename);
-
-        if (!outFile->open(QIODevice::WriteOnly | QIODevice::Text))
-            return;
-
-        /*
-         * save some data
-         * The problem here is that we've got X number of graphs that all have different
-         * timestamps but a spreadsheet would be best if each graph were taken at the same slice
-         * such that you have a list of slices with the value of each graph at that slice.
-         *
-         * But, for now export each graph in turn with the proper timestamp for each piece of data
-         * and a reference for which graph it came from. This is better than nothing.
-        */
-
-        QList<GraphParams>::iterator iter;
-        double xMin = std::numeric_limits<double>::max(),
-               xMax = std::numeric_limits<double>::min();
-        size_t maxCount = 0;
-        size_t numGraphs = graphParams.length();
-        for (auto && graph : graphParams) {
-            xMin = std::min(xMin, graph.x[0]);
-            xMax = std::max(xMax, graph.x[graph.x.count() - 1]);
-            maxCount = std::max(maxCount, static_cast<size_t>(graph.x.count()));
-        }
-        qDebug() << "xMin: " << xMin;
-        qDebug() << "xMax: " << xMax;
-        qDebug() << "MaxCount: " << maxCount;
-        //The idea now is to iterate from xMin to xMax slicing all graphs up into MaxCount slices.
-        //But, actually, don't visit actual xMin or xMax, inset from there by one slice. Then, if
-        //a given graph doesn't exist there use the value from the nearest place that does exist.
-        double xSize = xMax - xMin;
-        double sliceSize = xSize / ((double)maxCount);
-        double equivValue = sliceSize / 100.0;
-        double currentX;
-        double value;
-        QList<int> indices;
-        indices.reserve(numGraphs);
-
-        outFile->write("TimeStamp");
-        for (auto && graph : graphParams) {
-            indices.append(0);
-            outFile->putChar(',');
-            outFile->write(graph.graphName.toUtf8());
-        }
-        outFile->write("\n");
-
-        for (size_t j = 1; j < (maxCount - 1); j++)
-        {
-            currentX = xMin + (j * sliceSize);
-            qDebug() << "X: " << currentX;
-            outFile->write(QString::number(currentX, 'f').toUtf8());
-            for (size_t k = 0; k < numGraphs; k++)
-            {
-                value = 0.0;
-
-                // move cursor to last sample before currentX
-                while (graphParams[k].x[indices[k]+1] < currentX)
-                {
-                    indices[k]++;
-                }
+        bool ok;
+        double interval = QInputDialog::getDouble(this, "SavvyCAN Graphing", "Resample to a row every (x axis units, 0 for every point):",
+                                                  settings.value("Graphing/ExportInterval", 0.0).toDouble(), 0.0, 1e12, 6, &ok);
+        if (!ok) return;
+        settings.setValue("Graphing/ExportInterval", interval);
+
+        exportProgress = new QProgressDialog("Saving spreadsheet...", "Cancel", 0, 100, this);
+        exportProgress->setMinimumDuration(500);
+        exportProgress->setValue(0);
+
+        exportJob = new SpreadsheetExportJob(filename, series, interval);
+        connect(exportJob, SIGNAL(progress(int)), exportProgress, SLOT(setValue(int)));
+        connect(exportJob, SIGNAL(finished()), this, SLOT(spreadsheetSaved()));
+        connect(exportProgress, SIGNAL(canceled()), this, SLOT(cancelSpreadsheet()));
+        exportJob->start();
+    }
+}
 
-                //five possibilities.
-                //1: we're at the beginning for this graph but the slice is before this graph even starts
-                if (indices[k] == 0 && graphParams[k].x[indices[k]] > currentX)
-                {
-                    value = graphParams[k].y[indices[k]];
-                }
-                //2: The opposite, we're at the end of this graph but the slices keep going
-                else if (indices[k] == (graphParams[k].x.count() - 1) && graphParams[k].x[indices[k]] < currentX)
-                {
-                    value = graphParams[k].y[indices[k]];
-                }
-                //3: the slice is right near the current value we're at for this graph
-                else if (fabs(graphParams[k].x[indices[k]] - currentX) < equivValue)
-                {
-                    value = graphParams[k].y[indices[k]];
-                }
-                //4: the slice is right next to the next value for this graph
-                else if (fabs(graphParams[k].x[indices[k] + 1] - currentX) < equivValue)
-                {
-                    value = graphParams[k].y[indices[k] + 1];
-                }
-                //5: it's somewhere in between two values for this graph
-                //the two values will be indices[k] and indices[k] + 1
-                else
-                {
-                    // find index, where x >= currentX
-                    size_t cursor = indices[k];
-                    double span = graphParams[k].x[cursor+1] - graphParams[k].x[cursor];
-                    double progress = (currentX - graphParams[k].x[cursor]) / span;
-                    Q_ASSERT(progress >= 0.0 && progress <= 1.0);
-                    value = Utility::Lerp(graphParams[k].y[cursor], graphParams[k].y[cursor+1], progress);
-                    qDebug() << "Span: " << span << " Prog: " << progress << " Value: " << value;
-                }
-                outFile->putChar(',');
-                outFile->write(QString::number(value).toUtf8());
-            }
-            outFile->write("\n");
-        }
+void GraphingWindow::spreadsheetSaved()
+{
+    if (!exportJob) return;
+
+    if (!exportJob->succeeded() && !exportJob->getErrorString().isEmpty())
+        QMessageBox::warning(this, "SavvyCAN Graphing", "Couldn't save the spreadsheet: " + exportJob->getErrorString());
+    exportJob->deleteLater();
+    exportJob = nullptr;
+    exportProgress->deleteLater();
+    exportProgress = nullptr;
+}
 
-        outFile->close();
+//Stops a spreadsheet export. The job cleans up after itself once its thread is done
+void GraphingWindow::cancelSpreadsheet()
+{
+    if (!exportJob) return;
+
+    exportJob->cancel();
+    disconnect(exportJob, nullptr, this, nullptr);
+    if (exportJob->isDone()) exportJob->deleteLater();
+    else connect(exportJob, SIGNAL(finished()), exportJob, SLOT(deleteLater()));
+    exportJob = nullptr;
+    if (exportProgress)
+    {
+        disconnect(exportProgress, nullptr, this, nullptr);
+        exportProgress->deleteLater();
+        exportProgress = nullptr;
     }
-
 }
 
 void GraphingWindow::saveDefinitions()
@@ -982,6 +980,8 @@ void GraphingWindow::loadDefinitions()
         if (!inFile->open(QIODevice::ReadOnly | QIODevice::Text))
             return;
 
+        QList<GraphParams> loadedGraphs; //built all together once the whole file is read
+
         while (!inFile->atEnd()) {
             line = inFile->readLine().simplified();
             if (line.length() > 2)
@@ -1039,7 +1039,7 @@ void GraphingWindow::loadDefinitions()
                        else qDebug() << "Couldn't find the message by name! " << tokens[21] << "  " << tokens[22];
                    }
 
-                   createGraph(gp, true);
+                   loadedGraphs.append(gp);
                 }
                 else if (tokens[0] == "X") //second newest format based around signals
                 {
@@ -1087,7 +1087,7 @@ void GraphingWindow::loadDefinitions()
                        else qDebug() << "Couldn't find the message by name! " << tokens[20] << "  " << tokens[21];
                    }
 
-                   createGraph(gp, true);
+                   loadedGraphs.append(gp);
                 }
                 else //one of the two older formats then
                 {
@@ -1115,7 +1115,7 @@ void GraphingWindow::loadDefinitions()
                                 gp.scale = (float)sig->factor;
                                 gp.startBit = sig->startBit;
                                 gp.stride = 1;
-                                createGraph(gp, true);
+                                loadedGraphs.append(gp);
                             }
                         }
                     }
@@ -1200,12 +1200,16 @@ void GraphingWindow::loadDefinitions()
                             gp.graphName = tokens[11];
                         else
                             gp.graphName = QString();
-                        createGraph(gp, true);
+                        loadedGraphs.append(gp);
                     }
                 }
             }
         }
         inFile->close();
+
+        QList<GraphParams *> toCreate;
+        for (int i = 0; i < loadedGraphs.count(); i++) toCreate.append(&loadedGraphs[i]);
+        createGraphs(toCreate, true);
     }
 }
 
@@ -1225,7 +1229,10 @@ void GraphingWindow::showParamsDialog(int idx = -1)
     {
         if (idx > -1) //if there was an existing graph then delete it
         {
+            delete graphParams[idx].labels;
+            dropGraphBuild(graphParams[idx].buildId);
             graphParams.removeAt(idx);
+            rebuildDispatch();
             ui->graphingView->removeGraph(idx);
         }
         //create a new graph with the returned parameters.
@@ -1241,245 +1248,110 @@ void GraphingWindow::addNewGraph()
     showParamsDialog(-1);
 }
 
-void GraphingWindow::appendToGraph(GraphParams &params, CANFrame &frame, QVector<double> &x, QVector<double> &y)
+void GraphingWindow::appendToGraph(GraphParams &params, const CANFrame &frame)
 {
     params.strideSoFar++;
     if (params.strideSoFar >= params.stride)
     {
         params.strideSoFar = 0;
         int64_t tempVal; //64 bit temp value.
-        tempVal = Utility::processIntegerSignal(frame.payload(), params.startBit, params.numBits, params.intelFormat, params.isSigned); //& params.mask;
+        if (!params.extractor.matches(params.startBit, params.numBits, params.intelFormat, params.isSigned))
+            params.extractor = BitExtractor(params.startBit, params.numBits, params.intelFormat, params.isSigned);
+        tempVal = params.extractor.extract(frame.payload()); //& params.mask;
         double xVal, yVal;
-        if (Utility::timeStyle == TS_SECONDS)
-        {
-            xVal = ((double)(frame.timeStamp().microSeconds()) / 1000000.0 - params.xbias);
-        }
-        else if (Utility::timeStyle == TS_CLOCK)
-        {
-            QDateTime dt = QDateTime::fromMSecsSinceEpoch((frame.timeStamp().microSeconds() / 1000) - params.xbias);
-            xVal = (dt.time().second() + dt.time().minute() * 60 + dt.time().hour() * 3600);
-        }
-        else
-        {
-            xVal = (frame.timeStamp().microSeconds() - params.xbias);
-        }
+        xVal = GraphBuildJob::graphKey(frame, params.xbias);
         yVal = (tempVal * params.scale) + params.bias;
-        params.x.append(xVal);
-        params.y.append(yVal);
-        x.append(xVal);
-        y.append(yVal);
+        params.series.append(xVal, yVal);
 
-        //now see if we've got to do anything with the brackets and labels for value table stuff
+        //value table labels are run length encoded, a new span only starts when the description changes
         QString tempStr;
-        if (params.associatedSignal)
+        if (params.labels && params.associatedSignal)
         {
-
-            bool isValid = params.associatedSignal->getValueString(tempVal, tempStr);
-            if (isValid)
-            {
-                //we have a graph with associated signal and we could interpret it. So, see what we need to do
-                if (tempStr == params.prevValStr) //still same value, update bracket only
-                {
-                    params.lastBracket->right->setCoords(xVal, params.prevValLocation.y());
-                }
-                else //changed. See if this is the first value or if we're merely starting another one
-                {
-                    //a quick check for whether this is the first value or not.
-                    if (params.prevValLocation == QPointF(0,0))
-                    {
-                        params.prevValLocation = QPointF(xVal, yVal);
-                        //params.prevValStr = tempStr;
-                        //params.prevValTable = tempVal;
-                    }
-                    else //wasn't the same so complete the previous span and start a new one.
-                    {
-                        params.prevValTable = tempVal;
-                        params.prevValLocation = QPointF(xVal, yVal);
-                        params.prevValStr = tempStr;
-
-                        QCPItemBracket *bracket = new QCPItemBracket(ui->graphingView);
-                        bracket->left->setCoords(params.prevValLocation);
-                        bracket->right->setCoords(params.prevValLocation);
-                        bracket->setLength(12);
-                        params.lastBracket = bracket;
-                        params.brackets.append(bracket);
-                        // add text label for this value table entry
-                        QCPItemText *valueText = new QCPItemText(ui->graphingView);
-                        valueText->position->setParentAnchor(bracket->center);
-                        valueText->position->setCoords(0, -10.0); // move 10 pixels to the top from bracket center anchor
-                        valueText->setPositionAlignment(Qt::AlignBottom|Qt::AlignHCenter);
-                        valueText->setText(tempStr);
-                        qDebug() << "JiggaWatts: " << tempStr;
-                        valueText->setFont(QFont(font().family(), 10));
-                        params.bracketTexts.append(valueText);
-                    }
-                }
-            }
+            params.associatedSignal->updateValueTable();
+            if (params.associatedSignal->getValueString(tempVal, tempStr)) params.labels->append(xVal, yVal, tempStr);
         }
     }
 }
 
+//Rebuilds every graph from scratch out of the current frames, for when the frames got cleared or replaced
+void GraphingWindow::regenerateGraphs()
+{
+    cancelGraphBuilds();
+    QList<GraphParams *> toCreate;
+    for (int i = 0; i < graphParams.count(); i++) toCreate.append(&graphParams[i]);
+    createGraphs(toCreate, false);
+}
+
 void GraphingWindow::createGraph(GraphParams &params, bool createGraphParam)
 {
-    int64_t tempVal; //64 bit temp value.
-    double yminval=10000000.0, ymaxval = -1000000.0;
-    double xminval=10000000000.0, xmaxval = -10000000000.0;
-    GraphParams *refParam = &params;
-    int sBit, bits;
-    bool intelFormat, isSigned;
-    QString tempStr;
-    double x,y;
-
-    qDebug() << "New Graph ID: " << params.ID;
-    qDebug() << "Start bit: " << params.startBit;
-    qDebug() << "Data length: " << params.numBits;
-    qDebug() << "Intel Mode: " << params.intelFormat;
-    qDebug() << "Signed: " << params.isSigned;
-    qDebug() << "Mask: " << params.mask;
-
-    frameCache.clear();
-    for (int i = 0; i < modelFrames->count(); i++)
-    {
-        CANFrame thisFrame = modelFrames->at(i);
-        if (thisFrame.frameId() == params.ID && thisFrame.frameType() == QCanBusFrame::DataFrame &&  ( ( params.bus == -1) ||  (params.bus == thisFrame.bus) ) ) frameCache.append(thisFrame);
-    }
+    QList<GraphParams *> list;
+    list.append(&params);
+    createGraphs(list, createGraphParam);
+}
 
-    //to fix weirdness where a graph that has no data won't be able to be edited, selected, or deleted properly
-    //we'll check for the condition that there is nothing to graph and add a single dummy frame to the cache
-    //that has all data bytes = 0. This allows the graph to be edited and deleted. No idea why you can't otherwise.
-    if (frameCache.count() == 0)
+/*
+ * Puts any number of graphs on the plot right away, empty, and starts a GraphBuildJob to fill them in the background.
+ * The job gets the frames as they are right now and a snapshot of the DBC files so it doesn't matter what happens to
+ * either while it works. Points and value table labels show up chunk by chunk as graphResultsReady() gets them.
+*/
+void GraphingWindow::createGraphs(const QList<GraphParams *> &params, bool createGraphParams)
+{
+    if (params.isEmpty())
     {
-        CANFrame dummy;
-        dummy.setFrameId(params.ID);
-        dummy.bus = 0;
-        dummy.setPayload(QByteArray(8, 0));
-        dummy.setFrameType(QCanBusFrame::DataFrame);
-        frameCache.append(dummy);
+        ui->graphingView->replot();
+        return;
     }
 
-    int numEntries = frameCache.count() / params.stride;
-    if (numEntries < 1) numEntries = 1; //could happen if stride is larger than frame count
-
-    params.x.reserve(numEntries);
-    params.y.reserve(numEntries);
-    //params.x.fill(0, numEntries);
-    //params.y.fill(0, numEntries);
-
-    sBit = params.startBit;
-    bits = params.numBits;
-    intelFormat = params.intelFormat;
-    isSigned = params.isSigned;
+    QSharedPointer<const DBCSnapshot> dbc = dbcHandler->getSnapshot();
+    QVector<GraphBuildSpec> specs;
 
-    for (int j = 0; j < numEntries; j++)
+    for (int g = 0; g < params.count(); g++)
     {
-        int k = j * params.stride;
-        if (params.associatedSignal)
-        {
-            //skip all the rest of the stuff in this loop and don't add this to the graph if this signal isn't in this frame
-            if (!params.associatedSignal->isSignalInMessage(frameCache[k]))
-            {
-                qDebug() << "Signal was not in this frame";
-                continue;
-            }
-            else qDebug() << "Signal in the frame!";
-        }
-        tempVal = Utility::processIntegerSignal(frameCache[k].payload(), sBit, bits, intelFormat, isSigned); //& params.mask;
-        //qDebug() << tempVal;
-        y = (tempVal * params.scale) + params.bias;
-        params.y.append( y );
-
-        if (Utility::timeStyle == TS_SECONDS)
-        {
-            x = (frameCache[k].timeStamp().microSeconds()) / 1000000.0;
-        }
-        else if (Utility::timeStyle == TS_CLOCK)
-        {
-            QDateTime dt = QDateTime::fromMSecsSinceEpoch((frameCache[k].timeStamp().microSeconds() / 1000) - params.xbias);
-            x = (dt.time().msecsSinceStartOfDay() / 1000.0);
-        }
-        else
-        {
-            x = frameCache[k].timeStamp().microSeconds();
-        }
-
-        params.x.append( x );
-
-        if (params.associatedSignal && numEntries > 1)
-        {
-
-            bool isValid = params.associatedSignal->getValueString(tempVal, tempStr);
-            if (isValid)
-            {
-                if (params.prevValLocation == QPointF(0,0)) {
-                    params.prevValLocation = QPointF(x, y);
-                    params.prevValStr = tempStr;
-                    params.prevValTable = 0;
-                }
-                if (tempVal != params.prevValTable)
-                {
-                    qDebug() << "New Value: " << tempStr;
-
-                    //Adding a bracket is a neat idea but you can't do that unless:
-                    //1. you wait until the value changes again so you can put the bracket where it belongs or
-                    //2. you constantly update the bracket in size then relocate the text too to match.
-                    //since this code runs at the beginning of a graph operation it could center the bracket
-                    //but supporting this all in realtime updating code is a bit more complicated.
-                    // add the bracket at the top:
-                    QCPItemBracket *bracket = new QCPItemBracket(ui->graphingView);
-                    bracket->left->setCoords(params.prevValLocation);
-                    bracket->right->setCoords(x, params.prevValLocation.y());
-                    bracket->setLength(12);
-                    params.brackets.append(bracket);
-
-                    // add text label for this value table entry
-                    QCPItemText *valueText = new QCPItemText(ui->graphingView);
-                    valueText->position->setParentAnchor(bracket->center);
-                    valueText->position->setCoords(0, -10.0); // move 10 pixels to the top from bracket center anchor
-                    valueText->setPositionAlignment(Qt::AlignBottom|Qt::AlignHCenter);
-                    valueText->setText(params.prevValStr);
-                    valueText->setFont(QFont(font().family(), 10));
-                    params.bracketTexts.append(valueText);
-                    params.prevValLocation = QPointF(x, y);
-                    params.prevValStr = tempStr;
-                    params.lastBracket = bracket;
-                }
-                params.prevValTable = tempVal;
-            }
-        }
+        GraphParams *gp = params[g];
+        qDebug() << "New Graph ID: " << gp->ID << " Start bit: " << gp->startBit << " Length: " << gp->numBits
+                 << " Intel: " << gp->intelFormat << " Signed: " << gp->isSigned << " Mask: " << gp->mask;
+        gp->extractor = BitExtractor(gp->startBit, gp->numBits, gp->intelFormat, gp->isSigned);
+        gp->series.clear();
+        gp->buildId = nextBuildId++;
+        gp->building = true;
+        //just like before graphs were built in the background only the first new graph sets up the x axis
+        gp->fitX = needScaleSetup;
+        needScaleSetup = false;
 
-        if (y < yminval) yminval = y;
-        if (y > ymaxval) ymaxval = y;
-        if (x < xminval) xminval = x;
-        if (x > xmaxval) xmaxval = x;
-    }
-
-    if (params.prevValLocation != QPointF(0,0))
-    {
-        QCPItemBracket *bracket = new QCPItemBracket(ui->graphingView);
-        bracket->left->setCoords(params.prevValLocation);
-        bracket->right->setCoords(x, params.prevValLocation.y());
-        bracket->setLength(12);
-
-        // add text label for this value table entry
-        QCPItemText *valueText = new QCPItemText(ui->graphingView);
-        valueText->position->setParentAnchor(bracket->center);
-        valueText->position->setCoords(0, -10.0); // move 10 pixels to the top from bracket center anchor
-        valueText->setPositionAlignment(Qt::AlignBottom|Qt::AlignHCenter);
-        valueText->setText(params.prevValStr);
-        valueText->setFont(QFont(font().family(), 10));
-        params.prevValLocation = QPointF(x, y);
-        params.prevValStr = tempStr;
-        params.prevValTable = tempVal;
-        params.lastBracket = bracket;
+        GraphBuildSpec spec;
+        spec.buildId = gp->buildId;
+        spec.ID = gp->ID;
+        spec.bus = gp->bus;
+        spec.extractor = gp->extractor;
+        spec.scale = gp->scale;
+        spec.bias = gp->bias;
+        spec.xbias = gp->xbias;
+        spec.stride = gp->stride;
+        spec.signal = gp->associatedSignal ? dbc->findSignal(gp->associatedSignal) : nullptr;
+        specs.append(spec);
+
+        setupGraph(*gp, createGraphParams);
     }
+    if (createGraphParams) rebuildDispatch();
+
+    //the job shares the model's frame list. Live frames wait until it is done so the list doesn't get copied meanwhile
+    CANFrameModel *frameModel = MainWindow::getReference()->getCANFrameModel();
+    frameModel->holdNewFrames();
+    GraphBuildJob *job = new GraphBuildJob(*modelFrames, dbc, specs);
+    connect(job, SIGNAL(resultsReady()), this, SLOT(graphResultsReady()));
+    connect(job, SIGNAL(finished()), this, SLOT(graphBuildFinished()));
+    connect(job, SIGNAL(finished()), frameModel, SLOT(releaseNewFrames())); //stays connected if the job gets cancelled
+    buildJobs.append(job);
+    job->start();
+
+    updateBuildProgress();
+    ui->graphingView->replot();
+}
 
-    if (numEntries == 0)
-    {
-        yminval = -128.0;
-        ymaxval = 128.0;
-        xminval = 0;
-        xmaxval = 100;
-    }
+//Adds a new graph to the plot and styles it. The points come later, from a GraphBuildJob
+void GraphingWindow::setupGraph(GraphParams &params, bool createGraphParam)
+{
+    GraphParams *refParam = &params;
 
     params.xbias = 0;
 
@@ -1504,7 +1376,14 @@ void GraphingWindow::createGraph(GraphParams &params, bool createGraphParam)
     ui->graphingView->graph()->setName(params.graphName);
     ui->graphingView->graph()->setProperty("id", params.ID);
 
-    ui->graphingView->graph()->setData(refParam->x,refParam->y);
+    refParam->renderedCount = -1; //the data goes in at the next replot, see renderVisible()
+
+    if (params.associatedSignal)
+    {
+        if (!params.labels) params.labels = new ValueLabelLayer(ui->graphingView->xAxis, ui->graphingView->yAxis, QFont(font().family(), 10));
+        params.labels->clear(); //rebuilt along with the points
+        refParam->labels = params.labels;
+    }
 
     ui->graphingView->graph()->setScatterStyle(QCPScatterStyle((QCPScatterStyle::ScatterShape)params.pointType));
 
@@ -1526,6 +1405,22 @@ void GraphingWindow::createGraph(GraphParams &params, bool createGraphParam)
         fillBrush.setStyle(Qt::SolidPattern);
         ui->graphingView->graph()->setBrush(fillBrush);
     }
+}
+
+//Sets the axes up to show everything a graph has so far
+void GraphingWindow::fitGraphRange(GraphParams &params)
+{
+    double yminval, ymaxval;
+    double xminval, xmaxval;
+
+    if (!params.series.keyRange(xminval, xmaxval) || !params.series.valueRange(yminval, ymaxval))
+    {
+        if (params.building) return; //nothing to fit yet
+        yminval = -128.0;
+        ymaxval = 128.0;
+        xminval = 0;
+        xmaxval = 100;
+    }
 
     double xRange = (xmaxval - xminval);
     double yRange = (ymaxval - yminval);
@@ -1538,23 +1433,172 @@ void GraphingWindow::createGraph(GraphParams &params, bool createGraphParam)
     yminval = yMid - (yRange / 1.8);
     ymaxval = yMid + (yRange / 1.80);
 
-    qDebug() << "xmin: " << xminval;
-    qDebug() << "xmax: " << xmaxval;
-    qDebug() << "ymin: " << yminval;
-    qDebug() << "ymax: " << ymaxval;
-
-    if (needScaleSetup)
+    if (params.fitX)
     {
-        needScaleSetup = false;
-        ui->graphingView->xAxis->setRange(xminval, xmaxval);        
+        ui->graphingView->xAxis->setRange(xminval, xmaxval);
         ui->graphingView->axisRect()->setupFullAxesBox();
     }
     //always recalculate Y range so that new graphs actually show up in view
     ui->graphingView->yAxis->setRange(yminval, ymaxval);
+}
+
+//The build of a graph is done. Catches up on frames which came in meanwhile
+void GraphingWindow::finishGraph(GraphParams &params, int builtFrames)
+{
+    params.building = false;
+
+    //live frames skip graphs which are still being built. New frames are held back while building but the list could
+    //still have been added to in other ways, like a file being loaded
+    for (int i = builtFrames; i < modelFrames->count(); i++)
+    {
+        const CANFrame &frame = modelFrames->at(i);
+        if (frame.frameId() == params.ID && frame.frameType() == QCanBusFrame::DataFrame && ( (params.bus == -1) || (params.bus == frame.bus) ))
+            appendToGraph(params, frame);
+    }
+}
+
+//Moves whatever the build jobs have come up with so far into the graphs
+void GraphingWindow::graphResultsReady()
+{
+    for (int j = 0; j < buildJobs.count(); j++)
+    {
+        GraphBuildJob *job = buildJobs[j];
+        QVector<GraphBuildResult> results = job->takeResults();
+        for (int r = 0; r < results.count(); r++)
+        {
+            const GraphBuildResult &result = results[r];
+            GraphParams *params = nullptr;
+            for (int i = 0; i < graphParams.count(); i++)
+            {
+                if (graphParams[i].building && graphParams[i].buildId == result.buildId)
+                {
+                    params = &graphParams[i];
+                    break;
+                }
+            }
+            if (!params) continue; //removed or rebuilt since
+
+            params->series.reserve(params->series.count() + result.keys.count());
+            for (int k = 0; k < result.keys.count(); k++) params->series.append(result.keys[k], result.values[k]);
+            if (params->labels)
+            {
+                for (int s = 0; s < result.spans.count(); s++)
+                {
+                    const GraphLabelSpan &span = result.spans[s];
+                    params->labels->appendSpan(span.start, span.end, span.y, span.text);
+                }
+            }
+            if (result.finished) finishGraph(*params, job->getFrameCount());
+            fitGraphRange(*params);
+            if (result.finished) params->fitX = false;
+        }
+    }
 
+    updateBuildProgress();
+    replotScheduler.schedule();
+}
+
+void GraphingWindow::graphBuildFinished()
+{
+    GraphBuildJob *job = qobject_cast<GraphBuildJob *>(QObject::sender());
+    int idx = buildJobs.indexOf(job);
+    if (idx < 0) return;
+
+    graphResultsReady(); //anything still waiting
+    buildJobs.removeAt(idx);
+    job->deleteLater();
+    updateBuildProgress();
     ui->graphingView->replot();
 }
 
+//Stops every build. The jobs clean up after themselves once their threads are done
+void GraphingWindow::cancelGraphBuilds()
+{
+    for (int j = 0; j < buildJobs.count(); j++)
+    {
+        GraphBuildJob *job = buildJobs[j];
+        job->cancel();
+        disconnect(job, nullptr, this, nullptr);
+        if (job->isDone()) job->deleteLater();
+        else connect(job, SIGNAL(finished()), job, SLOT(deleteLater()));
+    }
+    buildJobs.clear();
+    for (int i = 0; i < graphParams.count(); i++) graphParams[i].building = false;
+    updateBuildProgress();
+}
+
+//A graph is going away. Whatever job is still building it can stop bothering
+void GraphingWindow::dropGraphBuild(int buildId)
+{
+    for (int j = 0; j < buildJobs.count(); j++) buildJobs[j]->dropGraph(buildId);
+}
+
+//Shows how far along the build jobs are, in the middle of the plot, for as long as any are running
+void GraphingWindow::updateBuildProgress()
+{
+    if (buildJobs.isEmpty())
+    {
+        if (progressText) progressText->setVisible(false);
+        return;
+    }
+
+    if (!progressText)
+    {
+        progressText = new QCPItemText(ui->graphingView);
+        progressText->position->setType(QCPItemPosition::ptAxisRectRatio);
+        progressText->position->setCoords(QPointF(0.5, 0.5));
+        progressText->setPositionAlignment(Qt::AlignCenter);
+        progressText->setFont(QFont(font().family(), 14));
+        progressText->setPadding(QMargins(8, 4, 8, 4));
+        progressText->setBrush(QBrush(QColor(255, 255, 255, 200)));
+        progressText->setPen(QPen(Qt::gray));
+        progressText->setSelectable(false);
+        progressText->setLayer(PlotRendering::diagnosticsLayer(ui->graphingView));
+    }
+
+    qint64 done = 0, total = 0;
+    for (int j = 0; j < buildJobs.count(); j++)
+    {
+        done += buildJobs[j]->getFramesDone();
+        total += buildJobs[j]->getFrameCount();
+    }
+    int percent = (total > 0) ? static_cast<int>((done * 100) / total) : 0;
+    progressText->setText(tr("Building graphs... %1%").arg(percent));
+    progressText->setVisible(true);
+}
+
+/*
+ * Hands each graph just the points needed for what is currently in view, picked out of its level of detail pyramid.
+ * Runs right before every replot. Graphs whose view, plot width and number of points haven't changed are left alone.
+*/
+void GraphingWindow::renderVisible()
+{
+    QCPRange range = ui->graphingView->xAxis->range();
+    int width = ui->graphingView->axisRect()->width();
+    QVector<double> keys, values;
+
+    for (int i = 0; i < graphParams.count(); i++)
+    {
+        GraphParams &params = graphParams[i];
+        if (!params.ref) continue;
+        if (params.renderedRange == range && params.renderedWidth == width && params.renderedCount == params.series.count()) continue;
+
+        params.series.render(range.lower, range.upper, width, keys, values);
+        params.ref->setData(keys, values, params.series.isSorted());
+        params.renderedRange = range;
+        params.renderedWidth = width;
+        params.renderedCount = params.series.count();
+
+        //selections are by point index and the points just changed. A selected graph stays selected as a whole
+        if (params.ref->selected())
+        {
+            QCPDataSelection sel;
+            sel.addDataRange(QCPDataRange(0, params.ref->dataCount()));
+            params.ref->setSelection(sel);
+        }
+    }
+}
+
 void GraphingWindow::moveLegend()
 {
     qDebug() << "moveLegend";
@@ -1592,8 +1636,10 @@ GraphParams::GraphParams()
     associatedSignal = nullptr;
     graphName = "default";
     xbias = 0;
-    prevValTable = 9999999999;
-    prevValLocation = QPointF(0,0);
-    prevValStr = "";
-    lastBracket = nullptr;
+    labels = nullptr;
+    buildId = -1;
+    building = false;
+    fitX = false;
+    renderedWidth = -1;
+    renderedCount = -1;
 }
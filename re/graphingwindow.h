@@ -4,8 +4,14 @@
 #include "qcustomplot.h"
 #include "can_structs.h"
 #include "dbc/dbchandler.h"
+#include "utils/minmaxpyramid.h"
+#include "graphbuildjob.h"
+#include "valuelabellayer.h"
+#include "spreadsheetexportjob.h"
+#include "utils/plotrendering.h"
 
 #include <QDialog>
+#include <QProgressDialog>
 
 namespace Ui {
 class GraphingWindow;
@@ -36,14 +42,16 @@ public:
     DBC_SIGNAL *associatedSignal;
 
     //the below stuff is used for internal purposes only - code should be refactored so these can be private
-    QVector<double> x, y;
+    MinMaxPyramid series; //every point of the graph. ref only ever holds what render() picked for the current view
+    QCPRange renderedRange;
+    int renderedWidth;
+    int renderedCount;
     double xbias;
-    int64_t prevValTable;
-    QPointF prevValLocation;
-    QString prevValStr;
-    QCPItemBracket *lastBracket;
-    QList<QCPItemBracket *> brackets;
-    QList<QCPItemText *> bracketTexts;
+    ValueLabelLayer *labels; //value table labels, only there if the graph has a signal. The window deletes it along with the graph
+    BitExtractor extractor;
+    int buildId; //identifies the graph to the GraphBuildJob filling it in
+    bool building; //a GraphBuildJob is still working on this one
+    bool fitX; //set the x axis to fit this graph once it's built
 };
 
 class GraphingWindow : public QDialog
@@ -80,13 +88,19 @@ private slots:
     void rescaleToData();
     void toggleFollowMode();
     void addNewGraph();    
-    void appendToGraph(GraphParams &params, CANFrame &frame, QVector<double> &x, QVector<double> &y);
+    void appendToGraph(GraphParams &params, const CANFrame &frame);
     void editSelectedGraph();
     void updatedFrames(int);
     void gotCenterTimeID(uint32_t ID, double timestamp);
     void resetView();
     void zoomIn();
     void zoomOut();
+    void renderVisible();
+    void liveReplot();
+    void graphResultsReady();
+    void graphBuildFinished();
+    void spreadsheetSaved();
+    void cancelSpreadsheet();
 
 signals:
     void sendCenterTimeID(uint32_t ID, double timestamp);
@@ -94,18 +108,33 @@ signals:
 private:
     Ui::GraphingWindow *ui;
     DBCHandler *dbcHandler;
-    QList<CANFrame> frameCache;
     const QVector<CANFrame> *modelFrames;
     QList<GraphParams> graphParams;
+    QHash<uint32_t, QVector<int>> graphsByID; //indices into graphParams, see rebuildDispatch()
+    ReplotScheduler replotScheduler; //live traffic only asks it for a replot, it decides when that happens
     QPen selectedPen;
     QCPSelectionDecorator *selDecorator;
     QCPItemText *locationText;
+    QCPItemText *progressText; //only exists once something was built in the background
+    QList<GraphBuildJob *> buildJobs;
+    int nextBuildId;
+    SpreadsheetExportJob *exportJob; //only while a spreadsheet is being saved
+    QProgressDialog *exportProgress;
     QCPItemTracer *itemTracer;
     bool needScaleSetup; //do we need to set x,y graphing extents?
     bool useOpenGL;
     bool followGraphEnd;
 
     void showParamsDialog(int idx);
+    void createGraphs(const QList<GraphParams *> &params, bool createGraphParams);
+    void setupGraph(GraphParams &params, bool createGraphParam);
+    void fitGraphRange(GraphParams &params);
+    void finishGraph(GraphParams &params, int builtFrames);
+    void cancelGraphBuilds();
+    void dropGraphBuild(int buildId);
+    void updateBuildProgress();
+    void regenerateGraphs();
+    void rebuildDispatch();
     void closeEvent(QCloseEvent *event);
     void readSettings();
     void writeSettings();
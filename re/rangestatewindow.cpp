@@ -4,6 +4,7 @@
 #include "utility.h"
 #include "helpwindow.h"
 #include "filterutility.h"
+#include "utils/bitextractor.h"
 
 RangeStateWindow::RangeStateWindow(const QVector<CANFrame> *frames, QWidget *parent) :
     QDialog(parent),
@@ -289,10 +290,11 @@ bool RangeStateWindow::processSignal(int startBit, int bitLength, int sensitivit
     diff2.reserve(frameCache.count() - 2);
 
     int i;
+    BitExtractor extractor(startBit, bitLength, !bigEndian, isSigned);
 
     for (i = 0; i < numFrames; i++)
     {
-        valu = Utility::processIntegerSignal(frameCache.at(i).payload(), startBit, bitLength, !bigEndian, isSigned);
+        valu = extractor.extract(frameCache.at(i).payload());
         if (valu < lowestValue) lowestValue = valu;
         if (valu > highestValue) highestValue = valu;
     }
@@ -311,7 +313,7 @@ bool RangeStateWindow::processSignal(int startBit, int bitLength, int sensitivit
         return false; //doesn't range enough.
 
     for (i = 0; i < numFrames; i++)
-        scaledVals.append((int)((Utility::processIntegerSignal(frameCache.at(i).payload(), startBit, bitLength, !bigEndian, isSigned) - lowestValue)));
+        scaledVals.append((int)((extractor.extract(frameCache.at(i).payload()) - lowestValue)));
 
     for (i = 1; i < numFrames; i++)
     {
@@ -475,6 +477,7 @@ void RangeStateWindow::clickedSignalList(int idx)
     int numFrames = frameCache.count();
     QVector<int> values;
     values.reserve(numFrames);
-    for (int i = 0; i < numFrames; i++) values.append((int)((Utility::processIntegerSignal(frameCache.at(i).payload(), startBit, bitLength, !isBigEndian, isSigned))));
+    BitExtractor extractor(startBit, bitLength, !isBigEndian, isSigned);
+    for (int i = 0; i < numFrames; i++) values.append((int)(extractor.extract(frameCache.at(i).payload())));
     createGraph(values);
 }
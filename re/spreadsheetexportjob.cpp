@@ -0,0 +1,189 @@
+#include "spreadsheetexportjob.h"
+
+#include <QFile>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+//rows are collected until the buffer is this big, then written out in one go
+#define EXPORT_BUFFER_SIZE  (1024 * 1024)
+
+SpreadsheetExportJob::SpreadsheetExportJob(const QString &filename, const QVector<SpreadsheetSeries> &series, double interval)
+    : filename(filename), series(series), interval(interval), cancelled(0), success(false)
+{
+}
+
+void SpreadsheetExportJob::start()
+{
+    connect(&watcher, SIGNAL(finished()), this, SIGNAL(finished()));
+    watcher.setFuture(QtConcurrent::run([this]() { run(); }));
+}
+
+void SpreadsheetExportJob::cancel()
+{
+    cancelled.storeRelease(1);
+}
+
+bool SpreadsheetExportJob::isDone() const
+{
+    return watcher.isFinished();
+}
+
+bool SpreadsheetExportJob::succeeded() const
+{
+    return success;
+}
+
+QString SpreadsheetExportJob::getErrorString() const
+{
+    return errorString;
+}
+
+void SpreadsheetExportJob::run()
+{
+    QFile outFile(filename);
+    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        errorString = outFile.errorString();
+        return;
+    }
+
+    QByteArray buffer;
+    buffer.reserve(EXPORT_BUFFER_SIZE + 4096);
+    auto flush = [&]() -> bool
+    {
+        if (outFile.write(buffer) != buffer.size())
+        {
+            errorString = outFile.errorString();
+            return false;
+        }
+        buffer.clear();
+        return true;
+    };
+
+    //false once there's no point going on. A cancelled export doesn't leave half a spreadsheet behind
+    auto writeOut = [&]() -> bool
+    {
+        if (cancelled.loadAcquire())
+        {
+            outFile.remove();
+            return false;
+        }
+        return flush();
+    };
+
+    buffer.append("TimeStamp");
+    for (int s = 0; s < series.count(); s++)
+    {
+        buffer.append(',');
+        buffer.append(series.at(s).name.toUtf8());
+    }
+    buffer.append('\n');
+
+    int numSeries = series.count();
+    QVector<int> pos(numSeries, 0);         //next point of each series not looked at yet
+    QVector<bool> held(numSeries, false);   //whether the series has started yet
+    QVector<double> heldValue(numSeries, 0.0);
+    qint64 totalPoints = 0;
+    double first = std::numeric_limits<double>::max();
+    double last = std::numeric_limits<double>::lowest();
+    for (int s = 0; s < numSeries; s++)
+    {
+        const QVector<double> &keys = series.at(s).keys;
+        totalPoints += keys.count();
+        if (keys.isEmpty()) continue;
+        first = qMin(first, keys.first());
+        last = qMax(last, keys.last());
+    }
+
+    //moves a series past every point at or before t so it holds the last of them
+    auto advance = [&](int s, double t)
+    {
+        const SpreadsheetSeries &ser = series.at(s);
+        while (pos[s] < ser.keys.count() && ser.keys.at(pos[s]) <= t)
+        {
+            heldValue[s] = ser.values.at(pos[s]);
+            held[s] = true;
+            pos[s]++;
+        }
+    };
+
+    auto writeRow = [&](double t)
+    {
+        buffer.append(QByteArray::number(t, 'f'));
+        for (int s = 0; s < numSeries; s++)
+        {
+            buffer.append(',');
+            if (held.at(s)) buffer.append(QByteArray::number(heldValue.at(s)));
+        }
+        buffer.append('\n');
+    };
+
+    qint64 consumed = 0;
+    int lastPercent = -1;
+    auto report = [&]()
+    {
+        for (int s = 0; s < numSeries; s++) consumed += pos[s];
+        int percent = (totalPoints > 0) ? static_cast<int>((consumed * 100) / totalPoints) : 100;
+        consumed = 0;
+        if (percent != lastPercent)
+        {
+            lastPercent = percent;
+            emit progress(percent);
+        }
+    };
+
+    if (interval > 0.0 && totalPoints > 0)
+    {
+        qint64 rows = static_cast<qint64>(std::floor((last - first) / interval)) + 1;
+        for (qint64 r = 0; r < rows; r++)
+        {
+            double t = first + (r * interval); //not accumulated so long exports don't drift
+            for (int s = 0; s < numSeries; s++) advance(s, t);
+            writeRow(t);
+            if (buffer.size() >= EXPORT_BUFFER_SIZE)
+            {
+                if (!writeOut()) return;
+                report();
+            }
+        }
+    }
+    else
+    {
+        //min heap of the next timestamp of every series which has points left
+        typedef std::pair<double, int> HeapEntry;
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+        for (int s = 0; s < numSeries; s++)
+        {
+            if (!series.at(s).keys.isEmpty()) heap.push(HeapEntry(series.at(s).keys.first(), s));
+        }
+
+        while (!heap.empty())
+        {
+            double t = heap.top().first;
+            //every series with a point at t moves on before the row is written, so equal timestamps share a row
+            while (!heap.empty() && heap.top().first == t)
+            {
+                int s = heap.top().second;
+                heap.pop();
+                advance(s, t);
+                if (pos[s] < series.at(s).keys.count()) heap.push(HeapEntry(series.at(s).keys.at(pos[s]), s));
+            }
+            writeRow(t);
+            if (buffer.size() >= EXPORT_BUFFER_SIZE)
+            {
+                if (!writeOut()) return;
+                report();
+            }
+        }
+    }
+
+    if (!writeOut()) return;
+    outFile.close();
+    success = true;
+    emit progress(100);
+}
@@ -0,0 +1,56 @@
+#ifndef SPREADSHEETEXPORTJOB_H
+#define SPREADSHEETEXPORTJOB_H
+
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+//One graph to put in the spreadsheet. The vectors are implicitly shared with the graph so handing them over is cheap
+struct SpreadsheetSeries
+{
+    QString name;
+    QVector<double> keys;
+    QVector<double> values;
+};
+
+/*
+ * Writes the points of a set of graphs out as one spreadsheet, on a worker thread so the window keeps going meanwhile.
+ * The graphs are walked through together in timestamp order (a k way merge), nothing but the current position in each is
+ * ever held. Every row carries the last value each graph had at or before its timestamp, cells of graphs which haven't
+ * started yet stay empty. Without an interval there is a row for every distinct timestamp of any graph. With one, rows
+ * are resampled to exactly that far apart from the first timestamp to the last.
+ * Rows are gathered in a buffer and written out a megabyte at a time.
+ * Keys of each series are expected to never decrease, which is how graphs get built.
+*/
+class SpreadsheetExportJob : public QObject
+{
+    Q_OBJECT
+public:
+    SpreadsheetExportJob(const QString &filename, const QVector<SpreadsheetSeries> &series, double interval);
+
+    void start();
+    void cancel();
+    bool isDone() const;
+    //only meaningful once finished() came. False if the file couldn't be written or the job was cancelled
+    bool succeeded() const;
+    QString getErrorString() const;
+
+signals:
+    void progress(int percent);
+    void finished();
+
+private:
+    QString filename;
+    QVector<SpreadsheetSeries> series;
+    double interval;
+    QAtomicInt cancelled;
+    bool success;
+    QString errorString;
+    QFutureWatcher<void> watcher;
+
+    void run();
+};
+
+#endif // SPREADSHEETEXPORTJOB_H
@@ -2,6 +2,11 @@
 #include "ui_temporalgraphwindow.h"
 #include "helpwindow.h"
 #include "mainwindow.h"
+#include "utils/plotrendering.h"
+#include <cmath>
+
+//size of the density map cells, in pixels
+#define DENSITY_CELL_PIXELS     8
 
 QString HexTicker::getTickLabel (double tick, const QLocale& locale, QChar formatChar, int precision)
 {
@@ -15,7 +20,8 @@ QString HexTicker::getTickLabel (double tick, const QLocale& locale, QChar forma
 
 TemporalGraphWindow::TemporalGraphWindow(const QVector<CANFrame> *frames, QWidget *parent) :
     QDialog(parent),
-    ui(new Ui::TemporalGraphWindow)
+    ui(new Ui::TemporalGraphWindow),
+    replotScheduler(this, [this]() { liveReplot(); })
 {
     ui->setupUi(this);
 
@@ -51,17 +57,18 @@ TemporalGraphWindow::TemporalGraphWindow(const QVector<CANFrame> *frames, QWidge
     connect(ui->graphingView->xAxis, SIGNAL(rangeChanged(QCPRange)), ui->graphingView->xAxis2, SLOT(setRange(QCPRange)));
     connect(ui->graphingView->yAxis, SIGNAL(rangeChanged(QCPRange)), ui->graphingView->yAxis2, SLOT(setRange(QCPRange)));
 
-    if (useOpenGL)
-    {
-        ui->graphingView->setAntialiasedElements(QCP::aeAll);
-        //ui->graphingView->setNoAntialiasingOnDrag(true);
-        ui->graphingView->setOpenGl(true);
-    }
-    else
-    {
-        ui->graphingView->setOpenGl(false);
-        ui->graphingView->setAntialiasedElements(QCP::aeNone);
-    }
+    //ui->graphingView->setNoAntialiasingOnDrag(true);
+    PlotRendering::setup(ui->graphingView, useOpenGL);
+    PlotRendering::addFrameTimeReadout(ui->graphingView);
+
+    graph = nullptr;
+    densityMap = nullptr;
+    followGraphEnd = false;
+    renderedCount = -1;
+    updateExtents();
+
+    //the scatter graph and the density map get their data for the current view right before every replot
+    connect(ui->graphingView, SIGNAL(beforeReplot()), this, SLOT(renderVisible()));
 }
 
 TemporalGraphWindow::~TemporalGraphWindow()
@@ -94,6 +101,7 @@ void TemporalGraphWindow::readSettings()
         move(Utility::constrainedWindowPos(settings.value("Temporal/WindowPos", QPoint(50, 50)).toPoint()));
     }
     useOpenGL = settings.value("Main/UseOpenGL", false).toBool();
+    replotScheduler.readSettings();
 }
 
 void TemporalGraphWindow::writeSettings()
@@ -109,158 +117,144 @@ void TemporalGraphWindow::writeSettings()
 
 void TemporalGraphWindow::updatedFrames(int numFrames)
 {
-    CANFrame thisFrame;
-    QVector<double> x, y;
-    bool appendedToGraph = false;
-    bool needReplot = false;
-
     if (numFrames == -1) //all frames deleted. Kill the display
     {
-        //removeAllGraphs();
-        //now instead of removing the graphs regenerate them which will blank them out but leave them there in case
-        //more traffic that matches comes in or someone otherwise loads more data
-        ui->graphingView->clearGraphs(); //temporarily remove the graphs from the graph view
-        ui->graphingView->clearPlottables();
-        ui->graphingView->replot(); //now, redisplay them all
-
+        //leave the graph there, empty, in case more traffic comes in or someone otherwise loads more data
+        bins.clear();
+        updateExtents();
+        renderedCount = -1;
+        ui->graphingView->replot();
     }
     else if (numFrames == -2) //all new set of frames. Reset
     {
-        //there shouldn't be any need to actually remove the graphs.
-        //regenerate them instead
-        ui->graphingView->clearGraphs(); //temporarily remove the graphs from the graph view
-        //needScaleSetup = true;
         generateGraph();
-        //ui->graphingView->replot(); //now, redisplay them all
     }
-    else //just got some new frames. See if they are relevant.
+    else //just got some new frames. Drop them into their bins, drawing them is left to renderVisible()
     {
         if (numFrames > modelFrames->count()) return;
 
-            appendedToGraph = false;
-            x.clear();
-            y.clear();
-            for (int i = modelFrames->count() - numFrames; i < modelFrames->count(); i++)
-            {
-                thisFrame = modelFrames->at(i);
-                /*
-                if (graphParams[j].ID == thisFrame.ID)
-                {
-                    appendToGraph(graphParams[j], thisFrame, x, y);
-                    appendedToGraph = true;
-                }*/
-            }
-            if (appendedToGraph)
-            {
-                //graphParams[j].ref->addData(x, y);
-                needReplot = true;
-            }
-
-        if (needReplot)
+        for (int i = modelFrames->count() - numFrames; i < modelFrames->count(); i++)
         {
-            if (followGraphEnd)
-            {
-                //find the current X span and maintain that span but move the end of it over to match the new end
-                //of the actual graph. This causes the view to move with the data to always show the end
-                QCPRange range = ui->graphingView->xAxis->range();
-                double size = range.size();
-                bool foundRange;
-                QCPRange keyRange = ui->graphingView->graph()->getKeyRange(foundRange);
-                if (foundRange)
-                {
-                    double end, start;
-                    end = keyRange.upper;
-                    start = end - size;
-                    ui->graphingView->xAxis->setRange(start, end);
-                }
-            }
-            ui->graphingView->replot();
+            const CANFrame &thisFrame = modelFrames->at(i);
+            bins.append(thisFrame.timeStamp().microSeconds() / 1000000.0, thisFrame.frameId());
         }
+        updateExtents();
+
+        if (numFrames > 0) replotScheduler.schedule();
     }
 }
 
-void TemporalGraphWindow::generateGraph()
+void TemporalGraphWindow::liveReplot()
 {
-    if (modelFrames->count() == 0) return;
+    if (followGraphEnd)
+    {
+        //find the current X span and maintain that span but move the end of it over to match the new end
+        //of the actual graph. This causes the view to move with the data to always show the end
+        QCPRange range = ui->graphingView->xAxis->range();
+        double size = range.size();
+        double end, start;
+        end = xmaxval;
+        start = end - size;
+        ui->graphingView->xAxis->setRange(start, end);
+    }
+
+    replotScheduler.replot(ui->graphingView);
+}
+
+void TemporalGraphWindow::updateExtents()
+{
+    if (!bins.timeRange(xminval, xmaxval))
+    {
+        xminval = 0;
+        xmaxval = 8;
+    }
+    if (!bins.idRange(yminval, ymaxval))
+    {
+        yminval = 0;
+        ymaxval = 255;
+    }
+}
 
+void TemporalGraphWindow::generateGraph()
+{
     ui->graphingView->clearGraphs();
     ui->graphingView->clearPlottables();
 
     qDebug() << "Regenerating the graph";
     ui->graphingView->addGraph();
     graph = ui->graphingView->graph();
+    graph->setLineStyle(QCPGraph::lsNone); //no lines
+    graph->setScatterStyle(QCPScatterStyle::ssCircle);
+    QPen graphPen;
+    graphPen.setColor(Qt::blue);
+    graphPen.setWidth(2);
+    graph->setPen(graphPen);
 
-    QVector<double> x, y;
-    int frameCount = modelFrames->count();
-
-    x.reserve(frameCount);
-    y.reserve(frameCount);
-
-    xminval = xmaxval = modelFrames->at(0).timeStamp().microSeconds() / 1000000.0;
-    yminval = ymaxval = modelFrames->at(0).frameId();
+    densityMap = new QCPColorMap(ui->graphingView->xAxis, ui->graphingView->yAxis);
+    densityMap->setGradient(QCPColorGradient::gpJet);
 
-    for (int i = 0; i < frameCount; i++)
+    bins.clear();
+    for (int i = 0; i < modelFrames->count(); i++)
     {
-        x.append(modelFrames->at(i).timeStamp().microSeconds() / 1000000.0);
-        y.append(modelFrames->at(i).frameId());
-        if (x[i] > xmaxval) xmaxval = x[i];
-        if (x[i] < xminval) xminval = x[i];
-        if (y[i] > ymaxval) ymaxval = y[i];
-        if (y[i] < yminval) yminval = y[i];
+        const CANFrame &frame = modelFrames->at(i);
+        bins.append(frame.timeStamp().microSeconds() / 1000000.0, frame.frameId());
     }
-
-    ui->graphingView->graph()->setData(x,y);
-    ui->graphingView->graph()->setLineStyle(QCPGraph::lsNone); //no lines
-    ui->graphingView->graph()->setScatterStyle(QCPScatterStyle::ssCircle);
-    QPen graphPen;
-    graphPen.setColor(Qt::blue);
-    graphPen.setWidth(2);
-    ui->graphingView->graph()->setPen(graphPen);
+    updateExtents();
+    renderedCount = -1;
 
     qDebug() << "xmin: " << xminval;
     qDebug() << "xmax: " << xmaxval;
     qDebug() << "ymin: " << yminval;
     qDebug() << "ymax: " << ymaxval;
 
-    ui->graphingView->xAxis->setRange(xminval, xmaxval);
-    ui->graphingView->yAxis->setRange(yminval, ymaxval);
-    ui->graphingView->axisRect()->setupFullAxesBox();
-
-    ui->graphingView->replot();
-
-
-    QCPColorMap *colorMap = new QCPColorMap(ui->graphingView->xAxis, ui->graphingView->yAxis);
-
-    int ySize = static_cast<int>(ymaxval - yminval) / 30 + 1;
-    int xSize = static_cast<int>((xmaxval - xminval) * 4.0) + 1;
-    colorMap->data()->setSize(xSize, ySize);
-    colorMap->data()->setRange(QCPRange(xminval, xmaxval), QCPRange(yminval, ymaxval));
-    for (int x = 0; x < xSize; ++x)
-    {
-      for (int y = 0; y < ySize; ++y)
-      {
-        colorMap->data()->setAlpha(x, y, 180);
-        colorMap->data()->setCell(x, y, 0.0);
-      }
-    }
+    resetView();
+}
 
-    for (int i = 0; i < frameCount; i++)
+/*
+ * Hands the scatter graph and the density map only what is needed for the current view at its current size, see
+ * TemporalBins. Runs right before every replot and does nothing if neither the view nor the frames changed.
+ * The density map colors each DENSITY_CELL_PIXELS square cell by how many frames landed in it, on a log scale so
+ * the busiest IDs don't wash everything else out.
+*/
+void TemporalGraphWindow::renderVisible()
+{
+    if (!graph || !densityMap) return;
+
+    QCPRange xRange = ui->graphingView->xAxis->range();
+    QCPRange yRange = ui->graphingView->yAxis->range();
+    QRect rect = ui->graphingView->axisRect()->rect();
+    if (xRange == renderedXRange && yRange == renderedYRange && rect.size() == renderedSize && renderedCount == bins.count()) return;
+
+    QVector<double> times, ids;
+    bins.render(xRange.lower, xRange.upper, rect.width(), yRange.lower, yRange.upper, rect.height(), times, ids);
+    graph->setData(times, ids);
+
+    int columns = qMax(1, rect.width() / DENSITY_CELL_PIXELS);
+    int rows = qMax(1, rect.height() / DENSITY_CELL_PIXELS);
+    QVector<int> counts;
+    bins.density(xRange.lower, xRange.upper, columns, yRange.lower, yRange.upper, rows, counts);
+
+    //the data ranges are where the centers of the outermost cells go
+    double cellWidth = xRange.size() / columns;
+    double cellHeight = yRange.size() / rows;
+    QCPColorMapData *data = densityMap->data();
+    data->setSize(columns, rows);
+    data->setRange(QCPRange(xRange.lower + (cellWidth / 2.0), xRange.upper - (cellWidth / 2.0)),
+                   QCPRange(yRange.lower + (cellHeight / 2.0), yRange.upper - (cellHeight / 2.0)));
+    for (int y = 0; y < rows; y++)
     {
-        int x = static_cast<int>(((modelFrames->at(i).timeStamp().microSeconds() / 1000000.0) - xminval) * 4.0);
-        int y = static_cast<int>(modelFrames->at(i).frameId() - yminval) / 30;
-        double val = colorMap->data()->cell(x, y);
-        double inc;
-        inc = 1 / (val + 1); //logarithmic decay
-        inc = inc * inc; //square the increment to make it even more stark
-        val = val + inc;
-        qDebug() << "X: " << x << " Y: " << y << "Val: " << val;
-        colorMap->data()->setCell(x, y, val);
+        for (int x = 0; x < columns; x++)
+        {
+            data->setCell(x, y, std::log1p(counts[(y * columns) + x]));
+            data->setAlpha(x, y, 180);
+        }
     }
+    densityMap->rescaleDataRange(true);
 
-    colorMap->setGradient(QCPColorGradient::gpJet);
-    colorMap->rescaleDataRange(true);
-    ui->graphingView->rescaleAxes();
-    ui->graphingView->replot();
+    renderedXRange = xRange;
+    renderedYRange = yRange;
+    renderedSize = rect.size();
+    renderedCount = bins.count();
 }
 
 void TemporalGraphWindow::selectionChanged()
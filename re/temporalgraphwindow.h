@@ -4,6 +4,8 @@
 #include <QDialog>
 #include "qcustomplot.h"
 #include "can_structs.h"
+#include "utils/temporalbins.h"
+#include "utils/plotrendering.h"
 
 namespace Ui {
 class TemporalGraphWindow;
@@ -31,6 +33,8 @@ private slots:
     void zoomIn();
     void zoomOut();
     void selectionChanged();
+    void renderVisible();
+    void liveReplot();
 
 private:
     Ui::TemporalGraphWindow *ui;    
@@ -38,12 +42,19 @@ private:
     bool useOpenGL;
     bool followGraphEnd;
     QCPGraph *graph;
+    QCPColorMap *densityMap;
+    TemporalBins bins; //every frame, graph and densityMap only ever hold what renderVisible() picked for the view
+    QCPRange renderedXRange, renderedYRange;
+    QSize renderedSize;
+    int renderedCount;
+    ReplotScheduler replotScheduler; //paces live replots the same way the graphing window does
     double xminval, xmaxval, yminval, ymaxval;
     void closeEvent(QCloseEvent *event);
     bool eventFilter(QObject *obj, QEvent *event);
     void readSettings();
     void writeSettings();
     void generateGraph();
+    void updateExtents();
 
 };
 
@@ -0,0 +1,132 @@
+#include "valuelabellayer.h"
+
+#include <algorithm>
+
+//spans narrower than this many pixels get merged with their neighbours
+#define MIN_SPAN_PIXELS     3.0
+
+//how far above the graph the bracket is drawn and how far down its arms reach
+#define BRACKET_RAISE       12.0
+
+//gap between the bracket and the text over it
+#define TEXT_GAP            2.0
+
+ValueLabelLayer::ValueLabelLayer(QCPAxis *keyAxis, QCPAxis *valueAxis, const QFont &font)
+    : QCPLayerable(keyAxis->parentPlot()), keyAxis(keyAxis), valueAxis(valueAxis), font(font)
+{
+}
+
+void ValueLabelLayer::clear()
+{
+    spans.clear();
+}
+
+void ValueLabelLayer::append(double x, double y, const QString &text)
+{
+    if (!spans.isEmpty() && spans.last().text == text)
+    {
+        spans.last().end = x;
+        return;
+    }
+    //the previous span runs right up to where this one starts
+    if (!spans.isEmpty()) spans.last().end = x;
+    appendSpan(x, x, y, text);
+}
+
+void ValueLabelLayer::appendSpan(double start, double end, double y, const QString &text)
+{
+    Span span;
+    span.start = start;
+    span.end = end;
+    span.y = y;
+    span.text = text;
+    spans.append(span);
+}
+
+int ValueLabelLayer::spanCount() const
+{
+    return spans.count();
+}
+
+QRect ValueLabelLayer::clipRect() const
+{
+    if (keyAxis) return keyAxis->axisRect()->rect();
+    return QRect();
+}
+
+void ValueLabelLayer::applyDefaultAntialiasingHint(QCPPainter *painter) const
+{
+    applyAntialiasingHint(painter, mAntialiased, QCP::aeItems);
+}
+
+void ValueLabelLayer::draw(QCPPainter *painter)
+{
+    if (!keyAxis || !valueAxis || spans.isEmpty()) return;
+
+    QCPRange range = keyAxis->range();
+    QFontMetrics metrics(font);
+    painter->setPen(QPen(Qt::black));
+    painter->setBrush(Qt::NoBrush);
+    painter->setFont(font);
+
+    //spans are in key order and don't overlap so their ends are sorted too. Start with the first one reaching into view
+    QVector<Span>::const_iterator firstVisible = std::lower_bound(spans.constBegin(), spans.constEnd(), range.lower,
+                                                  [](const Span &span, double key) { return span.end < key; });
+
+    bool merging = false;
+    double mergeLeft = 0, mergeRight = 0, mergeY = 0;
+    for (int i = static_cast<int>(firstVisible - spans.constBegin()); i < spans.count(); i++)
+    {
+        const Span &span = spans.at(i);
+        if (span.start > range.upper) break;
+
+        double x1 = keyAxis->coordToPixel(span.start);
+        double x2 = keyAxis->coordToPixel(span.end);
+        double left = qMin(x1, x2);
+        double right = qMax(x1, x2);
+        double y = valueAxis->coordToPixel(span.y);
+
+        if (right - left < MIN_SPAN_PIXELS)
+        {
+            if (!merging)
+            {
+                merging = true;
+                mergeLeft = left;
+                mergeRight = right;
+                mergeY = y;
+            }
+            mergeLeft = qMin(mergeLeft, left);
+            mergeRight = qMax(mergeRight, right);
+
+            //every span starting within the next pixel is just as narrow, except maybe the last of them. Skip right to that one
+            double nextKey = keyAxis->pixelToCoord(keyAxis->rangeReversed() ? left - 1.0 : right + 1.0);
+            QVector<Span>::const_iterator next = std::lower_bound(spans.constBegin() + i + 1, spans.constEnd(), nextKey,
+                                                 [](const Span &s, double key) { return s.start < key; });
+            int nextIdx = static_cast<int>(next - spans.constBegin());
+            if (nextIdx - 1 > i) i = nextIdx - 2;
+            continue;
+        }
+
+        if (merging)
+        {
+            drawBracket(painter, metrics, mergeLeft, qMax(mergeRight, left), mergeY, QString());
+            merging = false;
+        }
+        drawBracket(painter, metrics, left, right, y, span.text);
+    }
+    if (merging) drawBracket(painter, metrics, mergeLeft, mergeRight, mergeY, QString());
+}
+
+void ValueLabelLayer::drawBracket(QCPPainter *painter, const QFontMetrics &metrics, double left, double right, double y, const QString &text)
+{
+    double top = y - BRACKET_RAISE;
+    painter->drawLine(QLineF(left, top, right, top));
+    painter->drawLine(QLineF(left, top, left, y));
+    painter->drawLine(QLineF(right, top, right, y));
+
+    if (text.isEmpty()) return;
+    int width = metrics.boundingRect(text).width();
+    if (width > right - left) return; //would just pile up on top of the neighbouring labels
+    QRectF textRect(((left + right) / 2.0) - (width / 2.0), top - TEXT_GAP - metrics.height(), width, metrics.height());
+    painter->drawText(textRect, Qt::AlignCenter, text);
+}
@@ -0,0 +1,48 @@
+#ifndef VALUELABELLAYER_H
+#define VALUELABELLAYER_H
+
+#include "qcustomplot.h"
+
+/*
+ * The value table labels of one graph, kept as a run length encoded list of spans: each span is a stretch of the graph
+ * over which the signal kept the same value table description. A noisy signal changes value constantly so adding a
+ * bracket and a text item per change quickly buried QCustomPlot in tens of thousands of items. Instead this one layerable
+ * draws the labels itself and only those in view. Neighbouring spans narrower than a couple of pixels are merged into a
+ * single unlabelled bracket and a label is only written out if it fits over its span, so the drawing work depends on the
+ * width of the plot rather than on how many spans there are.
+*/
+class ValueLabelLayer : public QCPLayerable
+{
+public:
+    ValueLabelLayer(QCPAxis *keyAxis, QCPAxis *valueAxis, const QFont &font);
+
+    void clear();
+    //a new point of the graph. Extends the last span if the description didn't change and starts a new one otherwise
+    void append(double x, double y, const QString &text);
+    //a whole span at once, from start over to end at the height y
+    void appendSpan(double start, double end, double y, const QString &text);
+    int spanCount() const;
+
+protected:
+    QRect clipRect() const override;
+    void applyDefaultAntialiasingHint(QCPPainter *painter) const override;
+    void draw(QCPPainter *painter) override;
+
+private:
+    struct Span
+    {
+        double start;
+        double end;
+        double y;
+        QString text;
+    };
+
+    QPointer<QCPAxis> keyAxis;
+    QPointer<QCPAxis> valueAxis;
+    QFont font;
+    QVector<Span> spans;
+
+    void drawBracket(QCPPainter *painter, const QFontMetrics &metrics, double left, double right, double y, const QString &text);
+};
+
+#endif // VALUELABELLAYER_H
@@ -3,6 +3,7 @@
 #include "helpwindow.h"
 #include "mainwindow.h"
 #include "utility.h"
+#include "dbc/signaldecoder.h"
 #include <QDebug>
 
 #define MSG_COL     1
@@ -70,10 +71,23 @@ void SignalViewerWindow::updatedFrames(int numFrames)
     }
     else if (numFrames == -2) //all new set of frames. Reset
     {
-        for (int i = 0; i < modelFrames->count(); i++)
+        //only the last value of each signal gets displayed so only the frame it came from is needed
+        SignalDecoder decoder(signalList);
+        QVector<int> lastFrames = decoder.lastFrames(modelFrames);
+        QString sigString;
+        for (int i = 0; i < lastFrames.count(); i++)
         {
-            thisFrame = modelFrames->at(i);
-            processFrame(thisFrame);
+            if (lastFrames[i] < 0) continue;
+            if (signalList[i]->processAsText(modelFrames->at(lastFrames[i]), sigString, false))
+            {
+                QTableWidgetItem *item = ui->tableViewer->item(i, VALUE_COL);
+                if (!item)
+                {
+                    item = new QTableWidgetItem(sigString);
+                    ui->tableViewer->setItem(i, VALUE_COL, item);
+                }
+                else item->setText(sigString);
+            }
         }
     }
     else //just got some new frames. See if they are relevant.
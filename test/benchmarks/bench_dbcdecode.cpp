@@ -0,0 +1,657 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtMath>
+#include <string.h>
+
+#include "dbc/signaldecoder.h"
+#include "utility.h"
+#include "bench_dbcdecode.h"
+
+/* SavvyCAN marks float signals in the byte order field: @2/@3 big endian single/double, @5/@6 little endian */
+static const char *referenceDBC =
+    "VERSION \"\"\n"
+    "\n"
+    "NS_ :\n"
+    "\n"
+    "BS_:\n"
+    "\n"
+    "BU_: ECU TESTER\n"
+    "\n"
+    "BO_ 256 IntelInts: 8 ECU\n"
+    " SG_ U8 : 0|8@1+ (1,0) [0|255] \"\" TESTER\n"
+    " SG_ U12 : 8|12@1+ (0.5,-10) [-10|2037.5] \"V\" TESTER\n"
+    " SG_ S7 : 20|7@1- (1,0) [-64|63] \"\" TESTER\n"
+    " SG_ S13 : 27|13@1- (0.25,3) [-1021|1026.75] \"A\" TESTER\n"
+    " SG_ U24 : 40|24@1+ (1,0) [0|16777215] \"\" TESTER\n"
+    "\n"
+    "BO_ 512 MotorolaInts: 8 ECU\n"
+    " SG_ M8 : 7|8@0+ (1,0) [0|255] \"\" TESTER\n"
+    " SG_ M12 : 11|12@0+ (2,1) [1|8191] \"\" TESTER\n"
+    " SG_ MS10 : 29|10@0- (1,0) [-512|511] \"\" TESTER\n"
+    " SG_ MS16 : 47|16@0- (0.1,0) [-3276.8|3276.7] \"rpm\" TESTER\n"
+    " SG_ M1 : 56|1@0+ (1,0) [0|1] \"\" TESTER\n"
+    "\n"
+    "BO_ 768 Floats: 8 ECU\n"
+    " SG_ F32I : 0|32@5- (1,0) [0|0] \"\" TESTER\n"
+    " SG_ F32M : 39|32@2- (2,0.5) [0|0] \"\" TESTER\n"
+    "\n"
+    "BO_ 769 Doubles: 8 ECU\n"
+    " SG_ D64 : 0|64@6- (1,0) [0|0] \"\" TESTER\n"
+    "\n"
+    "BO_ 1024 Muxed: 8 ECU\n"
+    " SG_ Mux M : 0|4@1+ (1,0) [0|15] \"\" TESTER\n"
+    " SG_ A m0 : 8|16@1+ (0.01,0) [0|655.35] \"\" TESTER\n"
+    " SG_ B m1 : 8|16@1- (1,-100) [-32868|32667] \"\" TESTER\n"
+    " SG_ C m2 : 8|8@1+ (1,0) [0|255] \"\" TESTER\n"
+    " SG_ Sub m2M : 16|4@1+ (1,0) [0|15] \"\" TESTER\n"
+    " SG_ D m3 : 31|8@0+ (1,0) [0|255] \"\" TESTER\n"
+    " SG_ E m4 : 40|8@1+ (1,0) [0|255] \"\" TESTER\n"
+    " SG_ Always : 56|8@1+ (1,0) [0|255] \"\" TESTER\n"
+    "\n"
+    "BO_ 2566848528 CanFD: 64 ECU\n"
+    " SG_ FDIntel : 300|20@1+ (1,0) [0|1048575] \"\" TESTER\n"
+    " SG_ FDMoto : 455|24@0- (1,0) [-8388608|8388607] \"\" TESTER\n"
+    " SG_ FDWide : 128|64@1- (1,0) [0|0] \"\" TESTER\n"
+    " SG_ FDLast : 504|8@1+ (0.5,0) [0|127.5] \"\" TESTER\n"
+    "\n"
+    "VAL_ 256 U8 0 \"Off\" 1 \"On\" 255 \"Invalid\" ;\n"
+    "VAL_ 1024 Mux 0 \"Zero\" 2 \"Two\" ;\n"
+    "\n"
+    "SG_MUL_VAL_ 1024 D Sub 3-5;\n"
+    "SG_MUL_VAL_ 1024 E Mux 4-6;\n";
+
+struct RefMessage
+{
+    uint32_t    id;
+    int         len;
+    bool        extended;
+};
+
+static const RefMessage refMessages[] = {
+    { 0x100,      8,  false },
+    { 0x200,      8,  false },
+    { 0x300,      8,  false },
+    { 0x301,      8,  false },
+    { 0x400,      8,  false },
+    { 0x18FF0010, 64, true  },
+};
+
+/* what the reference file is supposed to say, written out independently of the loader */
+struct RefSignal
+{
+    const char *name;
+    uint32_t    id;
+    int         startBit;
+    int         size;
+    bool        intel;
+    DBC_SIG_VAL_TYPE type;
+    double      factor;
+    double      bias;
+    const char *muxParent;  /* nullptr if not multiplexed */
+    int         muxLow;
+    int         muxHigh;
+};
+
+static const RefSignal refSignals[] = {
+    { "U8",      0x100,      0,   8,  true,  UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "U12",     0x100,      8,   12, true,  UNSIGNED_INT, 0.5,  -10.0, nullptr, 0, 0 },
+    { "S7",      0x100,      20,  7,  true,  SIGNED_INT,   1.0,  0.0,   nullptr, 0, 0 },
+    { "S13",     0x100,      27,  13, true,  SIGNED_INT,   0.25, 3.0,   nullptr, 0, 0 },
+    { "U24",     0x100,      40,  24, true,  UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "M8",      0x200,      7,   8,  false, UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "M12",     0x200,      11,  12, false, UNSIGNED_INT, 2.0,  1.0,   nullptr, 0, 0 },
+    { "MS10",    0x200,      29,  10, false, SIGNED_INT,   1.0,  0.0,   nullptr, 0, 0 },
+    { "MS16",    0x200,      47,  16, false, SIGNED_INT,   0.1,  0.0,   nullptr, 0, 0 },
+    { "M1",      0x200,      56,  1,  false, UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "F32I",    0x300,      0,   32, true,  SP_FLOAT,     1.0,  0.0,   nullptr, 0, 0 },
+    { "F32M",    0x300,      39,  32, false, SP_FLOAT,     2.0,  0.5,   nullptr, 0, 0 },
+    { "D64",     0x301,      0,   64, true,  DP_FLOAT,     1.0,  0.0,   nullptr, 0, 0 },
+    { "Mux",     0x400,      0,   4,  true,  UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "A",       0x400,      8,   16, true,  UNSIGNED_INT, 0.01, 0.0,   "Mux",   0, 0 },
+    { "B",       0x400,      8,   16, true,  SIGNED_INT,   1.0,  -100.0,"Mux",   1, 1 },
+    { "C",       0x400,      8,   8,  true,  UNSIGNED_INT, 1.0,  0.0,   "Mux",   2, 2 },
+    { "Sub",     0x400,      16,  4,  true,  UNSIGNED_INT, 1.0,  0.0,   "Mux",   2, 2 },
+    { "D",       0x400,      31,  8,  false, UNSIGNED_INT, 1.0,  0.0,   "Sub",   3, 5 },
+    { "E",       0x400,      40,  8,  true,  UNSIGNED_INT, 1.0,  0.0,   "Mux",   4, 6 },
+    { "Always",  0x400,      56,  8,  true,  UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "FDIntel", 0x18FF0010, 300, 20, true,  UNSIGNED_INT, 1.0,  0.0,   nullptr, 0, 0 },
+    { "FDMoto",  0x18FF0010, 455, 24, false, SIGNED_INT,   1.0,  0.0,   nullptr, 0, 0 },
+    { "FDWide",  0x18FF0010, 128, 64, true,  SIGNED_INT,   1.0,  0.0,   nullptr, 0, 0 },
+    { "FDLast",  0x18FF0010, 504, 8,  true,  UNSIGNED_INT, 0.5,  0.0,   nullptr, 0, 0 },
+};
+
+static const int refSignalCount = sizeof(refSignals) / sizeof(refSignals[0]);
+
+struct RefValue
+{
+    const char *signal;
+    int64_t     value;
+    const char *text;
+};
+
+static const RefValue refValues[] = {
+    { "U8",  0,   "Off"     },
+    { "U8",  1,   "On"      },
+    { "U8",  255, "Invalid" },
+    { "Mux", 0,   "Zero"    },
+    { "Mux", 2,   "Two"     },
+};
+
+struct RefDecoded
+{
+    bool    valid;
+    int64_t raw;            /* the bits as an integer, sign extended for signed signals */
+    int64_t intValue;
+    double  doubleValue;
+};
+
+static const RefSignal* findRefSignal(uint32_t pID, const char *pName)
+{
+    for (int i = 0; i < refSignalCount; i++)
+        if (refSignals[i].id == pID && qstrcmp(refSignals[i].name, pName) == 0) return &refSignals[i];
+    return nullptr;
+}
+
+/* indexes into refSignals of the signals each ID carries */
+static const QHash<uint32_t, QVector<int>>& refSignalsByID()
+{
+    static QHash<uint32_t, QVector<int>> byID;
+    if (byID.isEmpty())
+        for (int i = 0; i < refSignalCount; i++) byID[refSignals[i].id].append(i);
+    return byID;
+}
+
+/*
+ * The reference decoder. Walks the signal one bit at a time in the order the DBC format numbers them: Intel counts up
+ * from the start bit, Motorola starts at the most significant bit and counts down within a byte then jumps to the top
+ * of the next byte. Nothing is precomputed and nothing is shared with the code under test.
+*/
+static bool refExtract(const QByteArray &pData, int pStartBit, int pSize, bool pIntel, bool pSigned, int64_t &pValue)
+{
+    uint64_t raw = 0;
+    int bit = pStartBit;
+    int lastByte = 0;
+
+    for (int i = 0; i < pSize; i++)
+    {
+        int byte = bit / 8;
+        lastByte = qMax(lastByte, byte);
+        bool set = (byte < pData.size()) && ((static_cast<uchar>(pData.at(byte)) >> (bit % 8)) & 1);
+        if (pIntel)
+        {
+            if (set) raw |= 1ULL << i;
+            bit++;
+        }
+        else
+        {
+            if (set) raw |= 1ULL << (pSize - 1 - i);
+            bit = ((bit % 8) == 0) ? bit + 15 : bit - 1;
+        }
+    }
+    if (pSigned && pSize < 64 && (raw & (1ULL << (pSize - 1)))) raw |= ~((1ULL << pSize) - 1);
+    pValue = static_cast<int64_t>(raw);
+
+    /* every byte the signal touches has to be there, plus the (startBit + size) / 8 length check the decoders have always made */
+    return (lastByte < pData.size()) && (pData.size() >= (pStartBit + pSize) / 8);
+}
+
+static RefDecoded refDecode(const RefSignal &pSig, const QByteArray &pData)
+{
+    RefDecoded out;
+    out.valid = false;
+    out.raw = 0;
+    out.intValue = 0;
+    out.doubleValue = 0.0;
+
+    if (pSig.type == SP_FLOAT)
+    {
+        out.valid = refExtract(pData, pSig.startBit, 32, pSig.intel, false, out.raw);
+        uint32_t bits = static_cast<uint32_t>(out.raw);
+        float asFloat;
+        memcpy(&asFloat, &bits, 4);
+        out.intValue = bits;
+        out.doubleValue = (asFloat * pSig.factor) + pSig.bias;
+    }
+    else if (pSig.type == DP_FLOAT)
+    {
+        out.valid = refExtract(pData, pSig.startBit, 64, pSig.intel, false, out.raw) && (pData.size() >= 8);
+        double asDouble;
+        memcpy(&asDouble, &out.raw, 8);
+        out.intValue = out.raw;
+        out.doubleValue = (asDouble * pSig.factor) + pSig.bias;
+    }
+    else
+    {
+        out.valid = refExtract(pData, pSig.startBit, pSig.size, pSig.intel, pSig.type == SIGNED_INT, out.raw);
+        out.doubleValue = (static_cast<double>(out.raw) * pSig.factor) + pSig.bias;
+        out.intValue = static_cast<int64_t>(out.doubleValue);
+    }
+    return out;
+}
+
+/* whether the signal is in the frame at all: decodable and selected by every multiplexor above it */
+static bool refPresent(const RefSignal &pSig, const QByteArray &pData)
+{
+    if (!refDecode(pSig, pData).valid) return false;
+    if (!pSig.muxParent) return true;
+
+    const RefSignal *parent = findRefSignal(pSig.id, pSig.muxParent);
+    if (!parent || !refPresent(*parent, pData)) return false;
+    if (parent->type != SIGNED_INT && parent->type != UNSIGNED_INT) return false;
+    int32_t muxVal = static_cast<int32_t>(refDecode(*parent, pData).intValue);
+    return (muxVal >= pSig.muxLow) && (muxVal <= pSig.muxHigh);
+}
+
+/* processAsText without the name and unit */
+static QString refText(const RefSignal &pSig, const RefDecoded &pValue)
+{
+    bool hasTable = false;
+    for (const RefValue &val : refValues)
+    {
+        if (qstrcmp(val.signal, pSig.name) != 0) continue;
+        hasTable = true;
+        if (val.value == pValue.intValue) return QString(val.text);
+    }
+    if (hasTable) return QString::number(pValue.intValue);
+
+    bool isInteger = (pSig.type == SIGNED_INT || pSig.type == UNSIGNED_INT) && (pSig.factor == qFloor(pSig.factor));
+    return isInteger ? QString::number(pValue.intValue) : QString::number(pValue.doubleValue);
+}
+
+/* random float bits make plenty of NaNs, which never compare equal */
+static bool sameValue(double pA, double pB)
+{
+    return (qIsNaN(pA) && qIsNaN(pB)) || (pA == pB);
+}
+
+static QByteArray describe(const char *pWhat, const char *pSignal, int pFrame, const QByteArray &pData)
+{
+    return QByteArray(pWhat) + " differs for " + pSignal + " on frame " + QByteArray::number(pFrame)
+            + " (" + QByteArray::number(pData.size()) + " bytes: " + pData.toHex(' ') + ")";
+}
+
+/* xorshift so every run gets the same frames. One frame in eight is shorter than its message to exercise the length checks */
+static QVector<CANFrame> generateFrames(int pCount)
+{
+    static const int fdLengths[] = { 0, 1, 4, 8, 12, 16, 20, 24, 32, 48 };
+    const int numMessages = sizeof(refMessages) / sizeof(refMessages[0]);
+    QVector<CANFrame> frames;
+    uint32_t seed = 0x2468ACE;
+    auto next = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    };
+
+    uint64_t timeStamp = 1000000;
+    frames.reserve(pCount);
+    for (int i = 0; i < pCount; i++)
+    {
+        const RefMessage &msg = refMessages[next() % numMessages];
+        int len = msg.len;
+        if ((next() % 8) == 0)
+        {
+            if (msg.len > 8) len = fdLengths[next() % (sizeof(fdLengths) / sizeof(fdLengths[0]))];
+            else len = next() % msg.len;
+        }
+
+        QByteArray payload(len, 0);
+        for (int b = 0; b < len; b++) payload[b] = static_cast<char>(next() & 0xFF);
+        /* keep the multiplexors within the range the file defines so every branch gets used */
+        if (msg.id == 0x400 && len > 0) payload[0] = static_cast<char>((payload[0] & 0xF0) | (next() % 8));
+        if (msg.id == 0x400 && len > 2) payload[2] = static_cast<char>((payload[2] & 0xF0) | (next() % 8));
+
+        CANFrame frame;
+        timeStamp += 100 + (next() % 900);
+        frame.setFrameId(msg.id);
+        frame.setExtendedFrameFormat(msg.extended);
+        frame.setFlexibleDataRateFormat(msg.len > 8);
+        frame.setFrameType(QCanBusFrame::DataFrame);
+        frame.setPayload(payload);
+        frame.setTimeStamp(QCanBusFrame::TimeStamp(0, timeStamp));
+        frame.bus = 0;
+        frame.isReceived = true;
+        frames.append(frame);
+    }
+    return frames;
+}
+
+BenchDBCDecode::BenchDBCDecode(int pNumFrames) :
+    mNumFrames(pNumFrames)
+{
+}
+
+DBC_SIGNAL* BenchDBCDecode::findSignal(uint32_t pID, const char *pName)
+{
+    DBC_MESSAGE *msg = mFile.messageHandler->findMsgByID(pID);
+    if (!msg) return nullptr;
+    return msg->sigHandler->findSignalByName(pName);
+}
+
+void BenchDBCDecode::report(const QString &pWhat, qint64 pNumSignals, qint64 pNanoSecs)
+{
+    double secs = qMax<qint64>(pNanoSecs, 1) / 1000000000.0;
+
+    qInfo("%-24s %10lld signals %8.1f ms %12.0f signals/s", pWhat.toUtf8().constData(), pNumSignals,
+          pNanoSecs / 1000000.0, pNumSignals / secs);
+}
+
+void BenchDBCDecode::initTestCase()
+{
+    QVERIFY(mTempDir.isValid());
+
+    QString filename = mTempDir.filePath("reference.dbc");
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(referenceDBC);
+    file.close();
+    QVERIFY(mFile.loadFile(filename));
+
+    mFrames = generateFrames(mNumFrames);
+    for (const CANFrame &frame : mFrames) mFramesByID[frame.frameId()].append(frame);
+
+    for (int i = 0; i < refSignalCount; i++)
+    {
+        DBC_SIGNAL *sig = findSignal(refSignals[i].id, refSignals[i].name);
+        QVERIFY2(sig, refSignals[i].name);
+        mSignalsByID[refSignals[i].id].append(sig);
+    }
+}
+
+void BenchDBCDecode::layout_data()
+{
+    QTest::addColumn<int>("index");
+
+    for (int i = 0; i < refSignalCount; i++) QTest::newRow(refSignals[i].name) << i;
+}
+
+/* the loader has to have understood the reference file before any of the decoding results mean anything */
+void BenchDBCDecode::layout()
+{
+    QFETCH(int, index);
+    const RefSignal &ref = refSignals[index];
+    DBC_SIGNAL *sig = findSignal(ref.id, ref.name);
+    QVERIFY(sig);
+
+    const RefMessage *refMsg = nullptr;
+    for (const RefMessage &msg : refMessages)
+        if (msg.id == ref.id) refMsg = &msg;
+    QVERIFY(refMsg);
+    QCOMPARE(sig->parentMessage->ID, ref.id);
+    QCOMPARE(static_cast<int>(sig->parentMessage->len), refMsg->len);
+    QCOMPARE(sig->parentMessage->extendedID, refMsg->extended);
+
+    QCOMPARE(sig->startBit, ref.startBit);
+    QCOMPARE(sig->signalSize, ref.size);
+    QCOMPARE(sig->intelByteOrder, ref.intel);
+    QCOMPARE(static_cast<int>(sig->valType), static_cast<int>(ref.type));
+    QCOMPARE(sig->factor, ref.factor);
+    QCOMPARE(sig->bias, ref.bias);
+
+    QCOMPARE(sig->isMultiplexed, ref.muxParent != nullptr);
+    if (ref.muxParent)
+    {
+        QVERIFY(sig->multiplexParent);
+        QCOMPARE(sig->multiplexParent->name, QString(ref.muxParent));
+        QVERIFY(sig->multiplexParent->multiplexedChildren.contains(sig));
+        QCOMPARE(sig->multiplexLowValue, ref.muxLow);
+        QCOMPARE(sig->multiplexHighValue, ref.muxHigh);
+    }
+    else QVERIFY(!sig->multiplexParent);
+}
+
+void BenchDBCDecode::decode_data()
+{
+    layout_data();
+}
+
+/* every single signal decode path against the reference, frame by frame */
+void BenchDBCDecode::decode()
+{
+    QFETCH(int, index);
+    const RefSignal &ref = refSignals[index];
+    DBC_SIGNAL *sig = findSignal(ref.id, ref.name);
+    QVERIFY(sig);
+
+    const QVector<CANFrame> frames = mFramesByID.value(ref.id);
+    QVERIFY(!frames.isEmpty());
+
+    QVector<double> batch(frames.count());
+    QVector<bool> batchValid(frames.count());
+    int good = sig->processAsDouble(frames.constData(), frames.count(), batch.data(), batchValid.data());
+    int expectedGood = 0;
+    bool isInteger = (ref.type == SIGNED_INT || ref.type == UNSIGNED_INT);
+
+    for (int i = 0; i < frames.count(); i++)
+    {
+        const CANFrame &frame = frames.at(i);
+        const QByteArray payload = frame.payload();
+        RefDecoded expected = refDecode(ref, payload);
+
+        DBC_SIGNAL_VALUE value = sig->decode(frame);
+        double asDouble = 0.0;
+        int32_t asInt = 0;
+        QString asText;
+        bool doubleOK = sig->processAsDouble(frame, asDouble);
+        bool intOK = sig->processAsInt(frame, asInt);
+        bool textOK = sig->processAsText(frame, asText, false, false);
+
+        if (value.valid != expected.valid) QFAIL(describe("decode validity", ref.name, i, payload).constData());
+        if (doubleOK != expected.valid) QFAIL(describe("processAsDouble validity", ref.name, i, payload).constData());
+        if (textOK != expected.valid) QFAIL(describe("processAsText validity", ref.name, i, payload).constData());
+        if (batchValid[i] != expected.valid) QFAIL(describe("batch processAsDouble validity", ref.name, i, payload).constData());
+        if (intOK != (expected.valid && isInteger)) QFAIL(describe("processAsInt validity", ref.name, i, payload).constData());
+        if (!expected.valid) continue;
+        expectedGood++;
+
+        if (value.intValue != expected.intValue) QFAIL(describe("decode integer value", ref.name, i, payload).constData());
+        if (!sameValue(value.doubleValue, expected.doubleValue)) QFAIL(describe("decode value", ref.name, i, payload).constData());
+        if (!sameValue(asDouble, expected.doubleValue)) QFAIL(describe("processAsDouble", ref.name, i, payload).constData());
+        if (!sameValue(batch[i], expected.doubleValue)) QFAIL(describe("batch processAsDouble", ref.name, i, payload).constData());
+        if (asText != refText(ref, expected)) QFAIL(describe("processAsText", ref.name, i, payload).constData());
+        if (isInteger)
+        {
+            if (asInt != static_cast<int32_t>(expected.intValue)) QFAIL(describe("processAsInt", ref.name, i, payload).constData());
+            if (Utility::processIntegerSignal(payload, ref.startBit, ref.size, ref.intel, ref.type == SIGNED_INT) != expected.raw)
+                QFAIL(describe("processIntegerSignal", ref.name, i, payload).constData());
+        }
+    }
+    QCOMPARE(good, expectedGood);
+}
+
+/* which signals DBCSignalHandler::decodeFrame finds in each frame and what it decodes them to */
+void BenchDBCDecode::multiplex()
+{
+    QVector<DBC_DECODED_SIGNAL> decoded;
+
+    for (int i = 0; i < mFrames.count(); i++)
+    {
+        const CANFrame &frame = mFrames.at(i);
+        const QByteArray payload = frame.payload();
+        DBC_MESSAGE *msg = mFile.messageHandler->findMsgByID(frame.frameId());
+        QVERIFY(msg);
+        msg->sigHandler->decodeFrame(frame, decoded);
+
+        QHash<QString, DBC_SIGNAL_VALUE> found;
+        for (const DBC_DECODED_SIGNAL &sig : decoded)
+        {
+            if (found.contains(sig.signal->name)) QFAIL(describe("decodeFrame duplicate", qPrintable(sig.signal->name), i, payload).constData());
+            found.insert(sig.signal->name, sig.value);
+        }
+
+        int expectedCount = 0;
+        for (int idx : refSignalsByID().value(frame.frameId()))
+        {
+            const RefSignal &ref = refSignals[idx];
+            bool present = refPresent(ref, payload);
+            if (found.contains(ref.name) != present) QFAIL(describe("decodeFrame presence", ref.name, i, payload).constData());
+            if (!present) continue;
+            expectedCount++;
+
+            RefDecoded expected = refDecode(ref, payload);
+            const DBC_SIGNAL_VALUE value = found.value(ref.name);
+            if (value.intValue != expected.intValue || !sameValue(value.doubleValue, expected.doubleValue))
+                QFAIL(describe("decodeFrame value", ref.name, i, payload).constData());
+        }
+        QCOMPARE(found.count(), expectedCount);
+    }
+}
+
+/* SignalDecoder over the whole capture at once */
+void BenchDBCDecode::bulk()
+{
+    QList<DBC_SIGNAL *> sigs;
+    for (int i = 0; i < refSignalCount; i++) sigs.append(findSignal(refSignals[i].id, refSignals[i].name));
+
+    SignalDecoder decoder(sigs);
+    QVector<SignalColumn> columns = decoder.decode(&mFrames);
+    QCOMPARE(columns.count(), refSignalCount);
+
+    for (int s = 0; s < refSignalCount; s++)
+    {
+        const RefSignal &ref = refSignals[s];
+        const SignalColumn &col = columns.at(s);
+        QCOMPARE(col.signal, sigs[s]);
+        QCOMPARE(col.frameIndices.count(), col.values.count());
+        QCOMPARE(col.timeStamps.count(), col.values.count());
+
+        int k = 0;
+        for (int i = 0; i < mFrames.count(); i++)
+        {
+            const CANFrame &frame = mFrames.at(i);
+            if (frame.frameId() != ref.id) continue;
+            const QByteArray payload = frame.payload();
+            if (!refPresent(ref, payload)) continue;
+
+            if (k >= col.values.count() || col.frameIndices[k] != i) QFAIL(describe("SignalDecoder frame", ref.name, i, payload).constData());
+            if (col.timeStamps[k] != static_cast<int64_t>(frame.timeStamp().microSeconds()))
+                QFAIL(describe("SignalDecoder time stamp", ref.name, i, payload).constData());
+            if (!sameValue(col.values[k], refDecode(ref, payload).doubleValue))
+                QFAIL(describe("SignalDecoder value", ref.name, i, payload).constData());
+            k++;
+        }
+        QCOMPARE(col.values.count(), k);
+    }
+
+    //the backwards scan has to land on the same frame the full decode ended on
+    QVector<int> lastFrames = decoder.lastFrames(&mFrames);
+    QCOMPARE(lastFrames.count(), refSignalCount);
+    for (int s = 0; s < refSignalCount; s++)
+    {
+        const SignalColumn &col = columns.at(s);
+        QCOMPARE(lastFrames[s], col.frameIndices.isEmpty() ? -1 : col.frameIndices.last());
+    }
+}
+
+void BenchDBCDecode::throughput_data()
+{
+    QTest::addColumn<QString>("path");
+
+    QTest::newRow("reference") << QString("reference");
+    QTest::newRow("processIntegerSignal") << QString("processIntegerSignal");
+    QTest::newRow("processAsDouble") << QString("processAsDouble");
+    QTest::newRow("processAsDouble batch") << QString("processAsDouble batch");
+    QTest::newRow("decodeFrame") << QString("decodeFrame");
+    QTest::newRow("SignalDecoder") << QString("SignalDecoder");
+}
+
+/* each row decodes every signal of every frame. processIntegerSignal can't report failure so its row counts calls */
+void BenchDBCDecode::throughput()
+{
+    QFETCH(QString, path);
+    QElapsedTimer timer;
+    qint64 nanoSecs = 0;
+    qint64 numSignals = 0;
+    volatile double sink = 0.0; /* keeps the results alive so nothing gets optimized away */
+
+    QBENCHMARK_ONCE {
+        timer.start();
+        if (path == "reference")
+        {
+            for (const CANFrame &frame : mFrames)
+            {
+                const QByteArray payload = frame.payload();
+                for (int idx : refSignalsByID().value(frame.frameId()))
+                {
+                    RefDecoded value = refDecode(refSignals[idx], payload);
+                    if (value.valid) numSignals++;
+                    sink += value.doubleValue;
+                }
+            }
+        }
+        else if (path == "processIntegerSignal")
+        {
+            for (const CANFrame &frame : mFrames)
+            {
+                const QByteArray payload = frame.payload();
+                for (const DBC_SIGNAL *sig : mSignalsByID.value(frame.frameId()))
+                {
+                    if (sig->valType != SIGNED_INT && sig->valType != UNSIGNED_INT) continue;
+                    sink += Utility::processIntegerSignal(payload, sig->startBit, sig->signalSize, sig->intelByteOrder,
+                                                          sig->valType == SIGNED_INT);
+                    numSignals++;
+                }
+            }
+        }
+        else if (path == "processAsDouble")
+        {
+            for (const CANFrame &frame : mFrames)
+            {
+                for (const DBC_SIGNAL *sig : mSignalsByID.value(frame.frameId()))
+                {
+                    double value;
+                    if (sig->processAsDouble(frame, value))
+                    {
+                        numSignals++;
+                        sink += value;
+                    }
+                }
+            }
+        }
+        else if (path == "processAsDouble batch")
+        {
+            QVector<double> values;
+            for (QHash<uint32_t, QVector<CANFrame>>::const_iterator it = mFramesByID.constBegin(); it != mFramesByID.constEnd(); ++it)
+            {
+                values.resize(it.value().count());
+                for (const DBC_SIGNAL *sig : mSignalsByID.value(it.key()))
+                {
+                    numSignals += sig->processAsDouble(it.value().constData(), it.value().count(), values.data());
+                    sink += values[0];
+                }
+            }
+        }
+        else if (path == "decodeFrame")
+        {
+            QVector<DBC_DECODED_SIGNAL> decoded;
+            for (const CANFrame &frame : mFrames)
+            {
+                DBC_MESSAGE *msg = mFile.messageHandler->findMsgByID(frame.frameId());
+                if (!msg) continue;
+                msg->sigHandler->decodeFrame(frame, decoded);
+                numSignals += decoded.count();
+                if (!decoded.isEmpty()) sink += decoded[0].value.doubleValue;
+            }
+        }
+        else if (path == "SignalDecoder")
+        {
+            QList<DBC_SIGNAL *> sigs;
+            for (QHash<uint32_t, QVector<DBC_SIGNAL *>>::const_iterator it = mSignalsByID.constBegin(); it != mSignalsByID.constEnd(); ++it)
+                for (DBC_SIGNAL *sig : it.value()) sigs.append(sig);
+
+            SignalDecoder decoder(sigs);
+            QVector<SignalColumn> columns = decoder.decode(&mFrames);
+            for (const SignalColumn &col : columns)
+            {
+                numSignals += col.values.count();
+                if (!col.values.isEmpty()) sink += col.values[0];
+            }
+        }
+        nanoSecs = timer.nsecsElapsed();
+    }
+
+    QVERIFY(numSignals > 0);
+    report(path, numSignals, nanoSecs);
+}
@@ -0,0 +1,49 @@
+#ifndef BENCH_DBCDECODE_H
+#define BENCH_DBCDECODE_H
+
+#include <QObject>
+#include <QHash>
+#include <QTemporaryDir>
+#include <QVector>
+#include "can_structs.h"
+#include "dbc/dbchandler.h"
+
+/*
+ * Correctness and throughput of DBC signal decoding. A reference DBC file covering Intel and Motorola integers, signed
+ * values, single and double precision floats, simple and extended multiplexing and CAN-FD frames with signals up to
+ * byte 63 is written out and loaded with DBCFile::loadFile. Every decode path (Utility::processIntegerSignal, the
+ * DBC_SIGNAL processAs functions, the batch processAsDouble, DBCSignalHandler::decodeFrame and SignalDecoder) is compared
+ * against a deliberately simple reference decoder which walks each signal one bit at a time, frame by frame.
+ * The throughput rows report decoded signals per second for each path, the reference decoder included as a baseline.
+ * The number of frames defaults to 100000 and can be changed with the SAVVYCAN_BENCH_FRAMES environment variable.
+*/
+class BenchDBCDecode: public QObject
+{
+    Q_OBJECT
+public:
+    explicit BenchDBCDecode(int pNumFrames);
+
+private:
+    int          mNumFrames;
+    QTemporaryDir mTempDir;
+    DBCFile      mFile;
+    QVector<CANFrame> mFrames;
+    QHash<uint32_t, QVector<CANFrame>> mFramesByID;     /* the same frames grouped by ID, for the batch decoder */
+    QHash<uint32_t, QVector<DBC_SIGNAL *>> mSignalsByID;
+
+    DBC_SIGNAL *findSignal(uint32_t pID, const char *pName);
+    void report(const QString &pWhat, qint64 pNumSignals, qint64 pNanoSecs);
+
+private slots:
+    void initTestCase();
+    void layout_data();
+    void layout();
+    void decode_data();
+    void decode();
+    void multiplex();
+    void bulk();
+    void throughput_data();
+    void throughput();
+};
+
+#endif // BENCH_DBCDECODE_H
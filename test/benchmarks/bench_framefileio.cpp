@@ -0,0 +1,408 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QtEndian>
+#include <functional>
+
+#include "framefileio.h"
+#include "blfhandler.h"
+#include "continuouslogger.h"
+#include "bench_framefileio.h"
+
+typedef std::function<bool(QString, const QVector<CANFrame>*)> SaveFunc;
+typedef std::function<bool(QString, QVector<CANFrame>*)> LoadFunc;
+
+/* writers for the formats FrameFileIO can load but not save */
+static bool writeVehicleSpyFile(QString pFilename, const QVector<CANFrame>* pFrames);
+static bool writePCANFile(QString pFilename, const QVector<CANFrame>* pFrames);
+static bool writeKvaserFile(QString pFilename, const QVector<CANFrame>* pFrames);
+static bool writeBLFFile(QString pFilename, const QVector<CANFrame>* pFrames);
+static bool writeSavvyBinaryFile(QString pFilename, const QVector<CANFrame>* pFrames);
+
+struct BenchFormat
+{
+    const char *name;
+    SaveFunc    save;
+    LoadFunc    load;
+    bool        hasSaver;       /* save is FrameFileIO's own saver and so gets benchmarked too */
+    bool        keepsEverything;/* the format round trips every generated frame so the count can be checked */
+};
+
+static const QVector<BenchFormat>& formats()
+{
+    static const QVector<BenchFormat> list = {
+        { "GVRET CSV",      FrameFileIO::saveNativeCSVFile,  FrameFileIO::loadNativeCSVFile,  true,  true  },
+        { "CRTD",           FrameFileIO::saveCRTDFile,       FrameFileIO::loadCRTDFile,       true,  false },
+        { "Generic CSV",    FrameFileIO::saveGenericCSVFile, FrameFileIO::loadGenericCSVFile, true,  false },
+        { "BusMaster",      FrameFileIO::saveLogFile,        FrameFileIO::loadLogFile,        true,  false },
+        { "Microchip",      FrameFileIO::saveMicrochipFile,  FrameFileIO::loadMicrochipFile,  true,  false },
+        { "Vector Trace",   FrameFileIO::saveTraceFile,      FrameFileIO::loadTraceFile,      true,  false },
+        { "IXXAT",          FrameFileIO::saveIXXATFile,      FrameFileIO::loadIXXATFile,      true,  false },
+        { "CAN-DO",         FrameFileIO::saveCANDOFile,      FrameFileIO::loadCANDOFile,      true,  false },
+        { "candump",        FrameFileIO::saveCanDumpFile,    FrameFileIO::loadCanDumpFile,    true,  false },
+        { "Cabana",         FrameFileIO::saveCabanaFile,     FrameFileIO::loadCabanaFile,     true,  false },
+        { "CANalyzer ASC",  FrameFileIO::saveCanalyzerASC,   FrameFileIO::loadCanalyzerASC,   true,  false },
+        { "CARBUS",         FrameFileIO::saveCARBUSAnalzyer, FrameFileIO::loadCARBUSAnalyzerFile, true, false },
+        { "pcapng",
+          [](QString f, const QVector<CANFrame>* p) { return FrameFileIO::saveWiresharkFile(f, p, true); },
+          FrameFileIO::loadWiresharkFile, true, true },
+        { "pcap",
+          [](QString f, const QVector<CANFrame>* p) { return FrameFileIO::saveWiresharkFile(f, p, false); },
+          FrameFileIO::loadWiresharkFile, true, true },
+        { "Vehicle Spy",    writeVehicleSpyFile, FrameFileIO::loadVehicleSpyFile, false, true },
+        { "PCAN",           writePCANFile,   FrameFileIO::loadPCANFile,     false, false },
+        { "Kvaser",         writeKvaserFile,
+          [](QString f, QVector<CANFrame>* p) { return FrameFileIO::loadKvaserFile(f, p, true); }, false, false },
+        { "CANalyzer BLF",  writeBLFFile,    FrameFileIO::loadCanalyzerBLF, false, true },
+        { "SavvyCAN binary", writeSavvyBinaryFile, FrameFileIO::loadSavvyBinaryFile, false, true },
+    };
+    return list;
+}
+
+static const BenchFormat* findFormat(const QString& pName)
+{
+    for (const BenchFormat& format : formats())
+        if (pName == format.name) return &format;
+    return nullptr;
+}
+
+/* peak resident memory. Linux lets the high water mark be reset so each row can be measured on its own */
+static qint64 readProcStatusKB(const char* pField)
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    QByteArray line;
+    while (!(line = file.readLine()).isEmpty())
+    {
+        if (line.startsWith(pField))
+            return line.mid(qstrlen(pField)).simplified().split(' ').value(0).toLongLong();
+    }
+#else
+    Q_UNUSED(pField);
+#endif
+    return -1;
+}
+
+static void resetPeakMemory()
+{
+#ifdef Q_OS_LINUX
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly)) file.write("5");
+#endif
+}
+
+/* xorshift so every run (and every machine) gets the same frames */
+static QVector<CANFrame> generateFrames(int pCount)
+{
+    QVector<CANFrame> frames;
+    QVector<uint32_t> ids;
+    uint32_t seed = 0x1234567;
+    auto next = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    };
+
+    /* a realistic mix: mostly standard IDs with a few extended ones */
+    for (int i = 0; i < 40; i++) ids.append(next() & 0x7FF);
+    for (int i = 0; i < 8; i++) ids.append((next() & 0x1FFFFFFF) | 0x800);
+
+    uint64_t timeStamp = 1000000;
+    frames.reserve(pCount);
+    for (int i = 0; i < pCount; i++)
+    {
+        CANFrame frame;
+        uint32_t id = ids[next() % ids.count()];
+        int len = 1 + (next() % 8); /* never 0, some loaders can't cope with an empty frame */
+        QByteArray payload(len, 0);
+        for (int b = 0; b < len; b++) payload[b] = static_cast<char>(next() & 0xFF);
+
+        timeStamp += 100 + (next() % 900);
+        frame.setFrameId(id);
+        frame.setExtendedFrameFormat(id > 0x7FF);
+        frame.setFrameType(QCanBusFrame::DataFrame);
+        frame.setPayload(payload);
+        frame.setTimeStamp(QCanBusFrame::TimeStamp(0, timeStamp));
+        frame.bus = next() & 1;
+        frame.isReceived = true;
+        frames.append(frame);
+    }
+    return frames;
+}
+
+/* Vehicle Spy CSV export. FrameFileIO::saveVehicleSpyFile doesn't write anything so the fixture comes from here.
+   The loader skips everything up to the second line starting with "Line" and wants more than 20 columns after that */
+static bool writeVehicleSpyFile(QString pFilename, const QVector<CANFrame>* pFrames)
+{
+    QFile file(pFilename);
+    char line[192];
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    file.write("Line,Abs Time(Sec),Rel Time (Sec),Status,Er,Tx,Description,Network,Node,Arb ID,Remote,Xtd,"
+               "B1,B2,B3,B4,B5,B6,B7,B8,Value,Trigger,Signals\n");
+    file.write("Line,,,,,,,,,,,,,,,,,,,,,,\n");
+    for (int i = 0; i < pFrames->count(); i++)
+    {
+        const CANFrame& frame = pFrames->at(i);
+        const QByteArray payload = frame.payload();
+        int pos = qsnprintf(line, sizeof(line), "%d,%.6f,0,0,F,F,,HS CAN,,%X,F,%s", i + 1,
+                            frame.timeStamp().microSeconds() / 1000000.0, frame.frameId(),
+                            frame.hasExtendedFrameFormat() ? "T" : "F");
+        for (int b = 0; b < 8; b++)
+        {
+            if (b < payload.count()) pos += qsnprintf(line + pos, sizeof(line) - pos, ",%02X", static_cast<uint8_t>(payload[b]));
+            else pos += qsnprintf(line + pos, sizeof(line) - pos, ",");
+        }
+        pos += qsnprintf(line + pos, sizeof(line) - pos, ",,,\n");
+        file.write(line, pos);
+    }
+    return true;
+}
+
+/* PCAN-View trace, file version 1.3 */
+static bool writePCANFile(QString pFilename, const QVector<CANFrame>* pFrames)
+{
+    QFile file(pFilename);
+    char line[128];
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    file.write(";$FILEVERSION=1.3\n;$STARTTIME=43000.0000000000\n");
+    for (int i = 0; i < pFrames->count(); i++)
+    {
+        const CANFrame& frame = pFrames->at(i);
+        const QByteArray payload = frame.payload();
+        int pos = qsnprintf(line, sizeof(line), "%6d) %13.3f %d  Rx %8X -  %d   ", i + 1,
+                            frame.timeStamp().microSeconds() / 1000.0, frame.bus, frame.frameId(), payload.count());
+        for (int b = 0; b < payload.count(); b++)
+            pos += qsnprintf(line + pos, sizeof(line) - pos, " %02X", static_cast<uint8_t>(payload[b]));
+        line[pos++] = '\n';
+        file.write(line, pos);
+    }
+    return true;
+}
+
+/* Kvaser text export in hex. The loader works on fixed columns so the layout has to be exact */
+static bool writeKvaserFile(QString pFilename, const QVector<CANFrame>* pFrames)
+{
+    QFile file(pFilename);
+    char line[128];
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    file.write("Chn Identifier Flg   DLC  D0...1...2...3...4...5...6..D7       Time     Dir\n");
+    for (int i = 0; i < pFrames->count(); i++)
+    {
+        const CANFrame& frame = pFrames->at(i);
+        const QByteArray payload = frame.payload();
+        int pos = qsnprintf(line, sizeof(line), "%3d %10X       %3d ", frame.bus, frame.frameId(), payload.count());
+        for (int b = 0; b < 8; b++)
+        {
+            if (b < payload.count()) pos += qsnprintf(line + pos, sizeof(line) - pos, "%3X ", static_cast<uint8_t>(payload[b]));
+            else pos += qsnprintf(line + pos, sizeof(line) - pos, "    ");
+        }
+        pos += qsnprintf(line + pos, sizeof(line) - pos, "%14.6f R\n", frame.timeStamp().microSeconds() / 1000000.0);
+        file.write(line, pos);
+    }
+    return true;
+}
+
+/* BLF with uncompressed containers of CAN_MSG objects. See blfhandler.h for the structures */
+static bool writeBLFFile(QString pFilename, const QVector<CANFrame>* pFrames)
+{
+    const int framesPerContainer = 1000;
+    const int objSize = sizeof(BLF_OBJ_HEADER_BASE) + sizeof(BLF_OBJ_HEADER_V1) + sizeof(BLF_CAN_OBJ);
+    QFile file(pFilename);
+
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    BLF_FILE_HEADER header;
+    memset(&header, 0, sizeof(header));
+    header.sig = qToLittleEndian<quint32>(0x47474F4C);
+    header.headerSize = qToLittleEndian<quint32>(sizeof(header));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (int first = 0; first < pFrames->count(); first += framesPerContainer)
+    {
+        int last = qMin(first + framesPerContainer, pFrames->count());
+        QByteArray objects;
+
+        for (int i = first; i < last; i++)
+        {
+            const CANFrame& frame = pFrames->at(i);
+            const QByteArray payload = frame.payload();
+            BLF_OBJ_HEADER_BASE base;
+            BLF_OBJ_HEADER_V1 v1;
+            BLF_CAN_OBJ can;
+
+            base.sig = 0x4A424F4C;
+            base.headerSize = sizeof(BLF_OBJ_HEADER_BASE) + sizeof(BLF_OBJ_HEADER_V1);
+            base.headerVersion = 1;
+            base.objSize = objSize;
+            base.objType = BLF_CAN_MSG;
+            v1.flags = 2;
+            v1.clientIdx = 0;
+            v1.objVer = 0;
+            v1.uncompSize = static_cast<uint64_t>(frame.timeStamp().microSeconds()) * 1000; /* nanoseconds */
+            memset(&can, 0, sizeof(can));
+            can.channel = static_cast<uint16_t>(frame.bus);
+            can.dlc = static_cast<uint8_t>(payload.count());
+            can.id = frame.frameId() | (frame.hasExtendedFrameFormat() ? 0x80000000u : 0);
+            memcpy(can.data, payload.constData(), qMin(payload.count(), 8));
+
+            objects.append(reinterpret_cast<const char*>(&base), sizeof(base));
+            objects.append(reinterpret_cast<const char*>(&v1), sizeof(v1));
+            objects.append(reinterpret_cast<const char*>(&can), sizeof(can));
+        }
+
+        BLF_OBJ_HEADER_BASE containerBase;
+        BLF_OBJ_HEADER_CONTAINER container;
+        containerBase.sig = 0x4A424F4C;
+        containerBase.headerSize = sizeof(BLF_OBJ_HEADER_BASE);
+        containerBase.headerVersion = 1;
+        containerBase.objSize = sizeof(containerBase) + sizeof(container) + objects.size();
+        containerBase.objType = BLF_CONTAINER;
+        memset(&container, 0, sizeof(container));
+        container.compressionMethod = BLF_CONT_NO_COMPRESSION;
+        container.uncompressedSize = objects.size();
+
+        file.write(reinterpret_cast<const char*>(&containerBase), sizeof(containerBase));
+        file.write(reinterpret_cast<const char*>(&container), sizeof(container));
+        file.write(objects);
+    }
+    return true;
+}
+
+/* SavvyCAN binary log as ContinuousLogger writes it, see continuouslogger.h */
+static bool writeSavvyBinaryFile(QString pFilename, const QVector<CANFrame>* pFrames)
+{
+    QFile file(pFilename);
+    char record[SVCLOG_RECORD_HDR_SIZE + 64];
+
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(SVCLOG_MAGIC);
+    file.putChar(SVCLOG_VERSION);
+    file.putChar(0);
+    for (int i = 0; i < pFrames->count(); i++)
+    {
+        const CANFrame& frame = pFrames->at(i);
+        const QByteArray payload = frame.payload();
+        int len = qMin(payload.count(), 64);
+        qToLittleEndian<quint64>(static_cast<quint64>(frame.timeStamp().microSeconds()), record);
+        qToLittleEndian<quint32>(frame.frameId(), record + 8);
+        record[12] = static_cast<char>(frame.bus);
+        record[13] = static_cast<char>((frame.hasExtendedFrameFormat() ? SVCLOG_FLAG_EXTENDED : 0) | SVCLOG_FLAG_RECEIVED);
+        record[14] = static_cast<char>(len);
+        memcpy(record + SVCLOG_RECORD_HDR_SIZE, payload.constData(), len);
+        file.write(record, SVCLOG_RECORD_HDR_SIZE + len);
+    }
+    return true;
+}
+
+BenchFrameFileIO::BenchFrameFileIO(int pNumFrames) :
+    mNumFrames(pNumFrames)
+{
+}
+
+QString BenchFrameFileIO::fileFor(const QString &pFormat)
+{
+    QString name = pFormat;
+    name.replace(' ', '_');
+    return mTempDir.filePath(name);
+}
+
+void BenchFrameFileIO::report(const char *pWhat, const QString &pFormat, qint64 pNumFrames, qint64 pBytes,
+                              qint64 pNanoSecs, qint64 pPeakKB)
+{
+    double secs = qMax<qint64>(pNanoSecs, 1) / 1000000000.0;
+    QByteArray peak = (pPeakKB < 0) ? QByteArray("n/a") : QByteArray::number(pPeakKB / 1024) + " MB";
+
+    qInfo("%-4s %-16s %9lld frames %8.1f MB %10.0f frames/s %7.1f MB/s  peak memory +%s", pWhat,
+          pFormat.toUtf8().constData(), pNumFrames, pBytes / 1048576.0, pNumFrames / secs, (pBytes / 1048576.0) / secs,
+          peak.constData());
+}
+
+void BenchFrameFileIO::initTestCase()
+{
+    QVERIFY(mTempDir.isValid());
+    mFrames = generateFrames(mNumFrames);
+
+    /* every format gets written up front so the load benchmarks don't depend on the save ones */
+    for (const BenchFormat& format : formats())
+        QVERIFY2(format.save(fileFor(format.name), &mFrames), format.name);
+}
+
+void BenchFrameFileIO::save_data()
+{
+    QTest::addColumn<QString>("format");
+
+    for (const BenchFormat& format : formats())
+        if (format.hasSaver) QTest::newRow(format.name) << QString(format.name);
+}
+
+void BenchFrameFileIO::save()
+{
+    QFETCH(QString, format);
+    const BenchFormat* bench = findFormat(format);
+    QVERIFY(bench);
+
+    QString filename = fileFor(format) + "_saved";
+    QElapsedTimer timer;
+    qint64 baseKB = readProcStatusKB("VmRSS:");
+    qint64 nanoSecs = 0;
+    bool result = false;
+
+    resetPeakMemory();
+    QBENCHMARK_ONCE {
+        timer.start();
+        result = bench->save(filename, &mFrames);
+        nanoSecs = timer.nsecsElapsed();
+    }
+    qint64 peakKB = readProcStatusKB("VmHWM:");
+
+    QVERIFY(result);
+    report("save", format, mFrames.count(), QFileInfo(filename).size(), nanoSecs,
+           (baseKB < 0 || peakKB < 0) ? -1 : peakKB - baseKB);
+    QFile::remove(filename);
+}
+
+void BenchFrameFileIO::load_data()
+{
+    QTest::addColumn<QString>("format");
+
+    for (const BenchFormat& format : formats())
+        QTest::newRow(format.name) << QString(format.name);
+}
+
+void BenchFrameFileIO::load()
+{
+    QFETCH(QString, format);
+    const BenchFormat* bench = findFormat(format);
+    QVERIFY(bench);
+
+    QString filename = fileFor(format);
+    QVector<CANFrame> loaded;
+    QElapsedTimer timer;
+    qint64 baseKB = readProcStatusKB("VmRSS:");
+    qint64 nanoSecs = 0;
+
+    resetPeakMemory();
+    QBENCHMARK_ONCE {
+        timer.start();
+        bench->load(filename, &loaded);
+        nanoSecs = timer.nsecsElapsed();
+    }
+    qint64 peakKB = readProcStatusKB("VmHWM:");
+
+    /* some loaders report errors for harmless things like a missing trailer so only what was loaded is checked */
+    QVERIFY(loaded.count() > 0);
+    if (bench->keepsEverything)
+    {
+        QCOMPARE(loaded.count(), mFrames.count());
+        QCOMPARE(loaded.last().frameId(), mFrames.last().frameId());
+        QCOMPARE(loaded.last().payload(), mFrames.last().payload());
+    }
+    report("load", format, loaded.count(), QFileInfo(filename).size(), nanoSecs,
+           (baseKB < 0 || peakKB < 0) ? -1 : peakKB - baseKB);
+}
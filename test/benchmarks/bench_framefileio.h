@@ -0,0 +1,38 @@
+#ifndef BENCH_FRAMEFILEIO_H
+#define BENCH_FRAMEFILEIO_H
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QVector>
+#include "can_structs.h"
+
+/*
+ * Load and save throughput for every file format FrameFileIO handles. A deterministic generator builds the same set of
+ * frames every run, which is written out once in each format (with FrameFileIO's own savers where they exist, otherwise
+ * with the small writers in the .cpp) and then loaded back. Each row reports frames per second, MB per second and how
+ * much the peak resident memory grew while it ran (Linux only).
+ * The number of frames defaults to 100000 and can be changed with the SAVVYCAN_BENCH_FRAMES environment variable.
+*/
+class BenchFrameFileIO: public QObject
+{
+    Q_OBJECT
+public:
+    explicit BenchFrameFileIO(int pNumFrames);
+
+private:
+    int          mNumFrames;
+    QVector<CANFrame> mFrames;
+    QTemporaryDir mTempDir;
+
+    QString fileFor(const QString &pFormat);
+    void report(const char *pWhat, const QString &pFormat, qint64 pNumFrames, qint64 pBytes, qint64 pNanoSecs, qint64 pPeakKB);
+
+private slots:
+    void initTestCase();
+    void save_data();
+    void save();
+    void load_data();
+    void load();
+};
+
+#endif // BENCH_FRAMEFILEIO_H
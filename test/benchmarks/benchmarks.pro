@@ -0,0 +1,39 @@
+QT += core gui concurrent serialbus widgets testlib
+
+CONFIG += c++11
+
+INCLUDEPATH += ../../
+
+SOURCES += \
+    main.cpp \
+    bench_framefileio.cpp \
+    bench_dbcdecode.cpp \
+    ../../framefileio.cpp \
+    ../../frameexporter.cpp \
+    ../../blfhandler.cpp \
+    ../../pcaphandler.cpp \
+    ../../utility.cpp \
+    ../../can_structs.cpp \
+    ../../dbc/dbc_classes.cpp \
+    ../../dbc/dbchandler.cpp \
+    ../../dbc/dbcsnapshot.cpp \
+    ../../dbc/signaldecoder.cpp
+
+HEADERS += \
+    bench_framefileio.h \
+    bench_dbcdecode.h \
+    ../../framefileio.h \
+    ../../frameexporter.h \
+    ../../blfhandler.h \
+    ../../pcaphandler.h \
+    ../../utility.h \
+    ../../can_structs.h \
+    ../../utils/fastformat.h \
+    ../../utils/bitextractor.h \
+    ../../dbc/dbc_classes.h \
+    ../../dbc/dbchandler.h \
+    ../../dbc/dbcsnapshot.h \
+    ../../dbc/signaldecoder.h
+
+target.path= .
+INSTALLS += target
@@ -0,0 +1,24 @@
+#include <QtTest>
+#include <QApplication>
+
+#include "bench_framefileio.h"
+#include "bench_dbcdecode.h"
+
+
+int main(int argc, char** argv)
+{
+   /* the loaders and savers live alongside GUI code so a QApplication is needed, but never a display */
+   if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+       qputenv("QT_QPA_PLATFORM", "offscreen");
+
+   QApplication app(argc, argv);
+
+   int numFrames = qEnvironmentVariableIntValue("SAVVYCAN_BENCH_FRAMES");
+   if (numFrames <= 0) numFrames = 100000;
+
+   BenchFrameFileIO bench(numFrames);
+   BenchDBCDecode dbcBench(numFrames);
+   int status = QTest::qExec(&bench, argc, argv);
+   status |= QTest::qExec(&dbcBench, argc, argv);
+   return status;
+}
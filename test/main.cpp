@@ -2,6 +2,10 @@
 
 #include "tst_lfqueue.h"
 #include "tst_cancon.h"
+#include "tst_spreadsheetexport.h"
+#include "tst_minmaxpyramid.h"
+#include "tst_frameidindex.h"
+#include "tst_temporalbins.h"
 
 
 int main(int argc, char** argv)
@@ -16,6 +20,10 @@ int main(int argc, char** argv)
 
    ASSERT_TEST(new TestLFQueue());
    ASSERT_TEST(new TestCanCon(CANCon::SOCKETCAN, "vcan0", 1));
+   ASSERT_TEST(new TestSpreadsheetExport());
+   ASSERT_TEST(new TestMinMaxPyramid());
+   ASSERT_TEST(new TestFrameIDIndex());
+   ASSERT_TEST(new TestTemporalBins());
 
    return status;
 }
@@ -1,4 +1,4 @@
-QT += core gui serialbus widgets testlib serialbus
+QT += core gui concurrent serialbus widgets testlib serialbus
 
 
 CONFIG += c++11
@@ -9,6 +9,11 @@ SOURCES += \
     tst_lfqueue.cpp \
     main.cpp \
     tst_cancon.cpp \
+    tst_spreadsheetexport.cpp \
+    tst_minmaxpyramid.cpp \
+    tst_frameidindex.cpp \
+    tst_temporalbins.cpp \
+    ../re/spreadsheetexportjob.cpp \
     ../connections/canconfactory.cpp \
     ../connections/canconnection.cpp \
     ../connections/gvretserial.cpp \
@@ -25,6 +30,14 @@ INSTALLS += target
 HEADERS += \
     tst_lfqueue.h \
     tst_cancon.h \
+    tst_spreadsheetexport.h \
+    tst_minmaxpyramid.h \
+    tst_frameidindex.h \
+    tst_temporalbins.h \
+    ../re/spreadsheetexportjob.h \
+    ../utils/minmaxpyramid.h \
+    ../utils/frameidindex.h \
+    ../utils/temporalbins.h \
     ../connections/canconconst.h \
     ../connections/canconfactory.h \
     ../connections/canconnection.h \
@@ -0,0 +1,129 @@
+#include <QtTest>
+
+#include "utils/frameidindex.h"
+#include "tst_frameidindex.h"
+
+
+//frame number n of a made up capture. Three IDs taking turns, a millisecond apart
+static CANFrame makeFrame(int n)
+{
+    static const uint32_t ids[3] = { 0x100, 0x7DF, 0x18FEF100 };
+    CANFrame frame;
+    frame.setFrameId(ids[n % 3]);
+    frame.bus = n % 2;
+    frame.setTimeStamp(QCanBusFrame::TimeStamp(0, n * 1000));
+    return frame;
+}
+
+
+static void appendFrames(QVector<CANFrame> &frames, int first, int count)
+{
+    for (int n = first; n < first + count; n++) frames.append(makeFrame(n));
+}
+
+
+/* The index has to agree with a plain scan of the list, IDs in the order they showed up included */
+static void checkIndex(const FrameIDIndex &index, const QVector<CANFrame> &frames)
+{
+    QList<uint32_t> ids;
+    QHash<uint32_t, QVector<int>> rows;
+    for (int i = 0; i < frames.count(); i++)
+    {
+        uint32_t id = frames.at(i).frameId();
+        if (!rows.contains(id)) ids.append(id);
+        rows[id].append(i);
+    }
+
+    QCOMPARE(index.count(), frames.count());
+    QCOMPARE(index.ids(), ids);
+    for (int i = 0; i < ids.count(); i++) QCOMPARE(index.rows(ids[i]), rows.value(ids[i]));
+    QVERIFY(index.rows(0x555).isEmpty());
+}
+
+
+void TestFrameIDIndex::appendOnly()
+{
+    QVector<CANFrame> frames;
+    FrameIDIndex index;
+    QCOMPARE(index.sync(frames), false);
+    checkIndex(index, frames);
+
+    appendFrames(frames, 0, 10);
+    QCOMPARE(index.sync(frames), false);
+    checkIndex(index, frames);
+
+    //new frames only, rows from before stay good
+    appendFrames(frames, 10, 25);
+    QCOMPARE(index.sync(frames), false);
+    checkIndex(index, frames);
+
+    QCOMPARE(index.sync(frames), false); //nothing new at all
+    checkIndex(index, frames);
+}
+
+
+void TestFrameIDIndex::frontTrimmed()
+{
+    QVector<CANFrame> frames;
+    FrameIDIndex index;
+    appendFrames(frames, 0, 100);
+    index.sync(frames);
+
+    //what the model does once its list is full: the oldest frames go and every row moves down
+    frames.remove(0, 5);
+    QCOMPARE(index.sync(frames), true);
+    checkIndex(index, frames);
+
+    //trimmed and then topped up past the old length, the count alone can't give it away
+    frames.remove(0, 5);
+    appendFrames(frames, 100, 20);
+    QCOMPARE(index.sync(frames), true);
+    checkIndex(index, frames);
+
+    appendFrames(frames, 120, 3);
+    QCOMPARE(index.sync(frames), false);
+    checkIndex(index, frames);
+}
+
+
+void TestFrameIDIndex::replaced()
+{
+    QVector<CANFrame> frames;
+    FrameIDIndex index;
+    appendFrames(frames, 0, 50);
+    index.sync(frames);
+
+    //same length, same first frame, but the list was built again (a filter changed) and the rest is different
+    QVector<CANFrame> refiltered;
+    refiltered.append(frames.first());
+    appendFrames(refiltered, 1000, 49);
+    QCOMPARE(index.sync(refiltered), true);
+    checkIndex(index, refiltered);
+
+    //a different first frame gives it away too
+    QVector<CANFrame> other;
+    appendFrames(other, 500, 60);
+    QCOMPARE(index.sync(other), true);
+    checkIndex(index, other);
+}
+
+
+void TestFrameIDIndex::shrunk()
+{
+    QVector<CANFrame> frames;
+    FrameIDIndex index;
+    appendFrames(frames, 0, 30);
+    index.sync(frames);
+
+    frames.resize(10);
+    QCOMPARE(index.sync(frames), true);
+    checkIndex(index, frames);
+
+    frames.clear();
+    QCOMPARE(index.sync(frames), true);
+    checkIndex(index, frames);
+
+    index.clear();
+    QCOMPARE(index.sync(frames), false);
+    checkIndex(index, frames);
+}
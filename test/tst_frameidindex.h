@@ -0,0 +1,18 @@
+#ifndef TST_FRAMEIDINDEX_H
+#define TST_FRAMEIDINDEX_H
+
+#include <QObject>
+
+class TestFrameIDIndex: public QObject
+{
+    Q_OBJECT
+private:
+
+private slots:
+    void appendOnly();
+    void frontTrimmed();
+    void replaced();
+    void shrunk();
+};
+
+#endif // TST_FRAMEIDINDEX_H
@@ -0,0 +1,129 @@
+#include <QtTest>
+
+#include "utils/minmaxpyramid.h"
+#include "tst_minmaxpyramid.h"
+
+
+//values with plenty of ties, so which of several equal points a bucket picks gets checked too
+static double testValue(int i)
+{
+    return static_cast<double>(((static_cast<uint32_t>(i) * 2654435761u) >> 16) % 50);
+}
+
+
+/* What render() should come up with, worked out the slow way: every bucket of the chosen level scanned point by point */
+static void bruteRender(int count, int lower, int upper, int pixelWidth, QVector<double> &outKeys, QVector<double> &outValues)
+{
+    outKeys.clear();
+    outValues.clear();
+
+    //keys are the point numbers. One point either side of the range
+    int first = qMax(lower - 1, 0);
+    int last = qMin(upper + 1, count - 1);
+    int span = last - first + 1;
+
+    //level l is there once there are more than 4^l points
+    int levelCount = 0;
+    while (levelCount < 14 && (1LL << (2 * (levelCount + 1))) < count) levelCount++;
+    int level = 0;
+    while (level < levelCount && (span >> (2 * (level + 1))) >= pixelWidth) level++;
+
+    if (level == 0)
+    {
+        for (int i = first; i <= last; i++)
+        {
+            outKeys.append(i);
+            outValues.append(testValue(i));
+        }
+        return;
+    }
+
+    int size = 1 << (2 * level);
+    for (int b = first / size; b <= last / size; b++)
+    {
+        int minIdx = b * size, maxIdx = b * size;
+        for (int i = b * size; i < qMin((b + 1) * size, count); i++)
+        {
+            if (testValue(i) < testValue(minIdx)) minIdx = i;
+            if (testValue(i) > testValue(maxIdx)) maxIdx = i;
+        }
+        int lowIdx = qMin(minIdx, maxIdx);
+        int highIdx = qMax(minIdx, maxIdx);
+        outKeys.append(lowIdx);
+        outValues.append(testValue(lowIdx));
+        if (highIdx != lowIdx)
+        {
+            outKeys.append(highIdx);
+            outValues.append(testValue(highIdx));
+        }
+    }
+}
+
+
+void TestMinMaxPyramid::render_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    for (int n = 1; n <= 7; n++)
+    {
+        int edge = 1 << (2 * n);
+        QTest::newRow(QByteArray::number(edge - 1).constData()) << edge - 1;
+        QTest::newRow(QByteArray::number(edge).constData()) << edge;
+        QTest::newRow(QByteArray::number(edge + 1).constData()) << edge + 1;
+    }
+}
+
+
+void TestMinMaxPyramid::render()
+{
+    QFETCH(int, count);
+
+    MinMaxPyramid pyramid;
+    for (int i = 0; i < count; i++) pyramid.append(i, testValue(i));
+    QCOMPARE(pyramid.count(), count);
+    QVERIFY(pyramid.isSorted());
+
+    const int widths[] = { 1, 3, 10, 100, 1000 };
+    for (int w = 0; w < 5; w++)
+    {
+        //the whole series, then a stretch out of the middle
+        for (int part = 0; part < 2; part++)
+        {
+            int lower = (part == 0) ? 0 : count / 3;
+            int upper = (part == 0) ? count - 1 : (2 * count) / 3;
+
+            QVector<double> keys, values, expectedKeys, expectedValues;
+            pyramid.render(lower, upper, widths[w], keys, values);
+            bruteRender(count, lower, upper, widths[w], expectedKeys, expectedValues);
+            QCOMPARE(keys, expectedKeys);
+            QCOMPARE(values, expectedValues);
+        }
+    }
+}
+
+
+void TestMinMaxPyramid::unsorted()
+{
+    MinMaxPyramid pyramid;
+    for (int i = 0; i < 100; i++) pyramid.append(i, testValue(i));
+    pyramid.append(-5.0, 1.0); //back in time, like a merged capture
+    for (int i = 100; i < 200; i++) pyramid.append(i, testValue(i));
+    QVERIFY(!pyramid.isSorted());
+
+    //every point comes back no matter the view
+    QVector<double> keys, values;
+    pyramid.render(150, 160, 2, keys, values);
+    QCOMPARE(keys, pyramid.keys());
+    QCOMPARE(values, pyramid.values());
+
+    double lower, upper;
+    QVERIFY(pyramid.keyRange(lower, upper));
+    QCOMPARE(lower, -5.0);
+    QCOMPARE(upper, 199.0);
+
+    pyramid.clear();
+    QVERIFY(pyramid.isSorted());
+    QVERIFY(!pyramid.keyRange(lower, upper));
+}
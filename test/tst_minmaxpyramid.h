@@ -0,0 +1,17 @@
+#ifndef TST_MINMAXPYRAMID_H
+#define TST_MINMAXPYRAMID_H
+
+#include <QObject>
+
+class TestMinMaxPyramid: public QObject
+{
+    Q_OBJECT
+private:
+
+private slots:
+    void render_data();
+    void render();
+    void unsorted();
+};
+
+#endif // TST_MINMAXPYRAMID_H
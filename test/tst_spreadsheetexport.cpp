@@ -0,0 +1,102 @@
+#include <QtTest>
+
+#include "re/spreadsheetexportjob.h"
+#include "tst_spreadsheetexport.h"
+
+
+static SpreadsheetSeries makeSeries(const QString &pName, const QVector<double> &pKeys, const QVector<double> &pValues)
+{
+    SpreadsheetSeries ser;
+    ser.name = pName;
+    ser.keys = pKeys;
+    ser.values = pValues;
+    return ser;
+}
+
+
+/* A: points at 1, 2, 3. B starts at 2, so its first cell stays empty, and has a point at 4 after A is done */
+static QVector<SpreadsheetSeries> twoSeries()
+{
+    QVector<SpreadsheetSeries> series;
+    series.append(makeSeries("A", QVector<double>() << 1.0 << 2.0 << 3.0, QVector<double>() << 10 << 20 << 30));
+    series.append(makeSeries("B", QVector<double>() << 2.0 << 4.0, QVector<double>() << 5 << 6));
+    return series;
+}
+
+
+QStringList TestSpreadsheetExport::exportLines(const QString &pName, double pInterval)
+{
+    QString path = mDir.filePath(pName);
+    SpreadsheetExportJob job(path, twoSeries(), pInterval);
+    QSignalSpy spy(&job, SIGNAL(finished()));
+    job.start();
+    if (!spy.wait(10000) || !job.succeeded()) return QStringList();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QStringList();
+    return QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+}
+
+
+void TestSpreadsheetExport::mergeRows()
+{
+    QVERIFY(mDir.isValid());
+    QStringList lines = exportLines("merge.csv", 0.0);
+
+    QStringList expected;
+    expected << "TimeStamp,A,B"
+             << "1.000000,10,"      //B hasn't started yet
+             << "2.000000,20,5"     //both have a point at 2, one row
+             << "3.000000,30,5"
+             << "4.000000,30,6";    //A holds its last value
+    QCOMPARE(lines, expected);
+}
+
+
+void TestSpreadsheetExport::resampleRows()
+{
+    QVERIFY(mDir.isValid());
+    QStringList lines = exportLines("resample.csv", 0.5);
+
+    QStringList expected;
+    expected << "TimeStamp,A,B"
+             << "1.000000,10,"
+             << "1.500000,10,"
+             << "2.000000,20,5"
+             << "2.500000,20,5"
+             << "3.000000,30,5"
+             << "3.500000,30,5"
+             << "4.000000,30,6";
+    QCOMPARE(lines, expected);
+
+    //adding up 0.1 ten times comes out just short of 1.0 so a point at 1.0 would show up a row late
+    QVector<SpreadsheetSeries> series;
+    series.append(makeSeries("C", QVector<double>() << 0.0 << 1.0, QVector<double>() << 1 << 7));
+    QString path = mDir.filePath("drift.csv");
+    SpreadsheetExportJob job(path, series, 0.1);
+    QSignalSpy spy(&job, SIGNAL(finished()));
+    job.start();
+    QVERIFY(spy.wait(10000));
+    QVERIFY(job.succeeded());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    lines = QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+    QCOMPARE(lines.count(), 12);
+    QCOMPARE(lines.at(10), QString("0.900000,1"));
+    QCOMPARE(lines.at(11), QString("1.000000,7"));
+}
+
+
+void TestSpreadsheetExport::cancel()
+{
+    QVERIFY(mDir.isValid());
+    QString path = mDir.filePath("cancel.csv");
+    SpreadsheetExportJob job(path, twoSeries(), 0.0);
+    QSignalSpy spy(&job, SIGNAL(finished()));
+    job.cancel(); //before it even starts so it can't be done before the cancel is seen
+    job.start();
+    QVERIFY(spy.wait(10000));
+    QVERIFY(!job.succeeded());
+    QVERIFY(!QFile::exists(path));
+}
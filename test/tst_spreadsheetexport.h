@@ -0,0 +1,22 @@
+#ifndef TST_SPREADSHEETEXPORT_H
+#define TST_SPREADSHEETEXPORT_H
+
+#include <QObject>
+#include <QStringList>
+#include <QTemporaryDir>
+
+class TestSpreadsheetExport: public QObject
+{
+    Q_OBJECT
+private:
+    QTemporaryDir mDir;
+
+    QStringList exportLines(const QString &pName, double pInterval);
+
+private slots:
+    void mergeRows();
+    void resampleRows();
+    void cancel();
+};
+
+#endif // TST_SPREADSHEETEXPORT_H
@@ -0,0 +1,97 @@
+#include <QtTest>
+
+#include <map>
+#include <vector>
+
+#include "utils/temporalbins.h"
+#include "tst_temporalbins.h"
+
+
+/* A made up capture: a handful of IDs in a jumbled order with uneven gaps between frames, some of them none at all */
+static std::map<uint32_t, std::vector<double>> makeCapture(TemporalBins &bins)
+{
+    static const uint32_t ids[6] = { 0x10, 0x20, 0x21, 0x100, 0x7FF, 0x1FF };
+    std::map<uint32_t, std::vector<double>> tracks;
+    double time = 0.5;
+    for (int i = 0; i < 20000; i++)
+    {
+        uint32_t hash = static_cast<uint32_t>(i) * 2654435761u;
+        time += ((hash >> 20) % 97) * 0.0137;
+        uint32_t id = ids[(hash >> 8) % 6];
+        bins.append(time, id);
+        tracks[id].push_back(time);
+    }
+    return tracks;
+}
+
+
+void TestTemporalBins::binning_data()
+{
+    QTest::addColumn<double>("timeLower");
+    QTest::addColumn<double>("timeUpper");
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<double>("idLower");
+    QTest::addColumn<double>("idUpper");
+    QTest::addColumn<int>("rows");
+
+    //NaN time bounds stand for the time range of the whole capture
+    double all = qQNaN();
+    QTest::newRow("whole capture")  << all      << all      << 800  << 0.0   << 2047.0 << 600;
+    QTest::newRow("one cell")       << all      << all      << 1    << 0.0   << 2047.0 << 1;
+    QTest::newRow("zoomed in")      << 3.3      << 57.91    << 37   << 31.0  << 257.0  << 5;
+    QTest::newRow("narrow")         << 100.25   << 100.26   << 10   << 0.0   << 2047.0 << 10;
+    QTest::newRow("zoomed out")     << -10.0    << 2000.0   << 123  << -5.0  << 3000.0 << 77;
+    QTest::newRow("single id")      << all      << all      << 4000 << 32.0  << 32.0   << 3;
+}
+
+
+/* render() and density() skip from pixel column to pixel column with binary searches. Both have to come out the same
+   as going through every frame and working out its cell */
+void TestTemporalBins::binning()
+{
+    QFETCH(double, timeLower);
+    QFETCH(double, timeUpper);
+    QFETCH(int, columns);
+    QFETCH(double, idLower);
+    QFETCH(double, idUpper);
+    QFETCH(int, rows);
+
+    TemporalBins bins;
+    std::map<uint32_t, std::vector<double>> tracks = makeCapture(bins);
+    double first, last;
+    QVERIFY(bins.timeRange(first, last));
+    if (qIsNaN(timeLower)) timeLower = first;
+    if (qIsNaN(timeUpper)) timeUpper = last;
+
+    double colWidth = (timeUpper - timeLower) / columns;
+    double rowHeight = qMax(idUpper - idLower, 1.0) / rows;
+    QVector<int> expectedCounts(columns * rows, 0);
+    QVector<double> expectedTimes, expectedIDs;
+    QVector<bool> taken(columns * rows, false);
+    for (std::map<uint32_t, std::vector<double>>::const_iterator it = tracks.begin(); it != tracks.end(); ++it)
+    {
+        if (it->first < idLower || it->first > idUpper) continue;
+        int row = qBound(0, static_cast<int>((it->first - idLower) / rowHeight), rows - 1);
+        for (size_t i = 0; i < it->second.size(); i++)
+        {
+            double time = it->second[i];
+            if (time < timeLower || time > timeUpper) continue;
+            int col = qBound(0, static_cast<int>((time - timeLower) / colWidth), columns - 1);
+            int cell = (row * columns) + col;
+            expectedCounts[cell]++;
+            if (taken[cell]) continue;
+            taken[cell] = true;
+            expectedTimes.append(time);
+            expectedIDs.append(it->first);
+        }
+    }
+
+    QVector<int> counts;
+    bins.density(timeLower, timeUpper, columns, idLower, idUpper, rows, counts);
+    QCOMPARE(counts, expectedCounts);
+
+    QVector<double> times, ids;
+    bins.render(timeLower, timeUpper, columns, idLower, idUpper, rows, times, ids);
+    QCOMPARE(times, expectedTimes);
+    QCOMPARE(ids, expectedIDs);
+}
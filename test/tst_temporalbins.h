@@ -0,0 +1,16 @@
+#ifndef TST_TEMPORALBINS_H
+#define TST_TEMPORALBINS_H
+
+#include <QObject>
+
+class TestTemporalBins: public QObject
+{
+    Q_OBJECT
+private:
+
+private slots:
+    void binning_data();
+    void binning();
+};
+
+#endif // TST_TEMPORALBINS_H
@@ -0,0 +1,155 @@
+#ifndef BITEXTRACTOR_H
+#define BITEXTRACTOR_H
+
+#include <stdint.h>
+#include <string.h>
+#include <QByteArray>
+#include <QtEndian>
+#include "can_structs.h"
+#include "utility.h"
+
+/*
+ * Precomputed extraction of an integer signal from the data bytes of a frame. Utility::processIntegerSignal walks a signal
+ * one bit at a time which is fine for the odd lookup but slow when the same signal has to be pulled out of every frame in a log.
+ * Once the bytes are read in the byte order of the signal both Intel and Motorola signals are a contiguous run of bits
+ * (for Motorola that means numbering the bits from the most significant bit of byte 0 on up) so any signal which fits within
+ * eight bytes can be read with a single 64 bit load, a shift and a mask. Everything which depends only on the signal
+ * definition is worked out once when the extractor is built.
+ * Results are identical to processIntegerSignal, including returning 0 when the frame is too short to hold the signal.
+ * Signals which can't be done this way (over 64 bits, spread over nine bytes or reaching past byte 63) fall back to it.
+*/
+class BitExtractor
+{
+public:
+    BitExtractor()
+    {
+        build(0, 1, true, false);
+    }
+
+    BitExtractor(int startBit, int sigSize, bool littleEndian, bool isSigned)
+    {
+        build(startBit, sigSize, littleEndian, isSigned);
+    }
+
+    //whether this extractor was built for the given signal layout. Used to notice when a signal definition has been edited
+    inline bool matches(int startBit, int sigSize, bool littleEndian, bool isSigned) const
+    {
+        return (this->startBit == startBit) && (this->sigSize == sigSize) && (this->littleEndian == littleEndian) && (this->isSigned == isSigned);
+    }
+
+    //whether a frame with length data bytes is long enough to hold the signal. extract() returns 0 for frames which aren't
+    inline bool fits(int length) const
+    {
+        if (fallback) return (length * 8) >= (startBit + sigSize);
+        return length >= minLength;
+    }
+
+    inline int64_t extract(const QByteArray &data) const
+    {
+        return extract(reinterpret_cast<const uchar *>(data.constData()), data.size());
+    }
+
+    inline int64_t extract(const uchar *data, int length) const
+    {
+        if (fallback)
+        {
+            return Utility::processIntegerSignal(QByteArray::fromRawData(reinterpret_cast<const char *>(data), length),
+                                                 startBit, sigSize, littleEndian, isSigned);
+        }
+        if (length < minLength) return 0;
+
+        quint64 word; //quint64 rather than uint64_t so the qFromLittleEndian/qFromBigEndian specializations are picked up
+        if (length - firstByte >= 8)
+        {
+            memcpy(&word, data + firstByte, 8);
+            word = littleEndian ? qFromLittleEndian(word) : qFromBigEndian(word);
+        }
+        else //near the end of the frame so only load the bytes the signal actually touches
+        {
+            word = 0;
+            if (littleEndian)
+            {
+                for (int i = 0; i < byteCount; i++) word |= static_cast<uint64_t>(data[firstByte + i]) << (8 * i);
+            }
+            else
+            {
+                for (int i = 0; i < byteCount; i++) word |= static_cast<uint64_t>(data[firstByte + i]) << (56 - (8 * i));
+            }
+        }
+
+        uint64_t value = (word >> shift) & mask;
+        if (value & signBit) value |= ~mask;
+        return static_cast<int64_t>(value);
+    }
+
+    //Extract the signal from count frames in a row. There are no per frame decisions left to make here so this is just loads and shifts
+    void extract(const CANFrame *frames, int count, int64_t *out) const
+    {
+        for (int i = 0; i < count; i++)
+        {
+            const QByteArray payload = frames[i].payload();
+            out[i] = extract(reinterpret_cast<const uchar *>(payload.constData()), payload.size());
+        }
+    }
+
+    //Apply factor and bias to a whole column of raw values. Written as a plain loop over flat arrays so the compiler can vectorize it
+    static void scale(const int64_t *raw, int count, double factor, double bias, double *out)
+    {
+        for (int i = 0; i < count; i++) out[i] = (static_cast<double>(raw[i]) * factor) + bias;
+    }
+
+private:
+    int startBit;
+    int sigSize;
+    bool littleEndian;
+    bool isSigned;
+
+    bool fallback;
+    int firstByte;  //first byte the signal touches
+    int byteCount;  //how many bytes starting at firstByte the signal touches
+    int minLength;  //frames shorter than this produce 0, same as processIntegerSignal
+    int shift;      //how far to shift the loaded 64 bit word right to line the signal up with bit 0
+    uint64_t mask;
+    uint64_t signBit; //0 for unsigned signals
+
+    void build(int startBit, int sigSize, bool littleEndian, bool isSigned)
+    {
+        this->startBit = startBit;
+        this->sigSize = sigSize;
+        this->littleEndian = littleEndian;
+        this->isSigned = isSigned;
+
+        fallback = true;
+        firstByte = 0;
+        byteCount = 0;
+        minLength = 0;
+        shift = 0;
+        mask = 0;
+        signBit = 0;
+
+        if (startBit < 0 || sigSize < 1 || sigSize > 64) return;
+
+        int lastByte;
+        firstByte = startBit / 8;
+        if (littleEndian)
+        {
+            lastByte = (startBit + sigSize - 1) / 8;
+            shift = startBit % 8;
+        }
+        else
+        {
+            int msbFirstBit = (firstByte * 8) + (7 - (startBit % 8));
+            lastByte = (msbFirstBit + sigSize - 1) / 8;
+            shift = 64 - ((msbFirstBit % 8) + sigSize);
+        }
+        byteCount = lastByte - firstByte + 1;
+        if (byteCount > 8 || lastByte > 63) return;
+
+        minLength = qMax(lastByte + 1, (startBit + sigSize) / 8);
+        mask = (sigSize == 64) ? ~0ULL : ((1ULL << sigSize) - 1);
+        if (isSigned && sigSize < 64) signBit = 1ULL << (sigSize - 1);
+        fallback = false;
+    }
+};
+
+#endif // BITEXTRACTOR_H
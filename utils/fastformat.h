@@ -0,0 +1,183 @@
+#ifndef FASTFORMAT_H
+#define FASTFORMAT_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Table driven number to text conversion for the frame writers. Going through QString::number().toUpper().rightJustified().toUtf8()
+ * allocates several times for every single field and that ends up dominating the time it takes to write a log. These routines
+ * instead write straight into a caller supplied char buffer and return a pointer just past the last character written.
+ * No terminating zero is written and the caller is responsible for making sure there is room in the buffer. 20 characters is
+ * enough for any 64 bit decimal number and 16 for any 64 bit hex number.
+*/
+class FastFormat
+{
+public:
+    //upper case hex, always exactly "digits" characters long. Zero padded on the left, excess high digits are dropped
+    static inline char *hex(char *out, uint64_t value, int digits)
+    {
+        int i = digits;
+        while (i >= 2)
+        {
+            const char *pair = hexPairs() + ((value & 0xFF) * 2);
+            out[--i] = pair[1];
+            out[--i] = pair[0];
+            value >>= 8;
+        }
+        if (i) out[0] = hexPairs()[((value & 0xF) * 2) + 1];
+        return out + digits;
+    }
+
+    //upper case hex, at least "digits" characters long. Unlike above, numbers needing more digits are not cut off
+    static inline char *hexAtLeast(char *out, uint64_t value, int digits)
+    {
+        int needed = 1;
+        uint64_t temp = value >> 4;
+        while (temp)
+        {
+            needed++;
+            temp >>= 4;
+        }
+        return hex(out, value, (needed > digits) ? needed : digits);
+    }
+
+    //upper case hex with only as many digits as needed (at least one)
+    static inline char *hex(char *out, uint64_t value)
+    {
+        return hexAtLeast(out, value, 1);
+    }
+
+    static inline char *hexByte(char *out, uint8_t value)
+    {
+        const char *pair = hexPairs() + (value * 2);
+        out[0] = pair[0];
+        out[1] = pair[1];
+        return out + 2;
+    }
+
+    //unsigned decimal with no padding
+    static inline char *dec(char *out, uint64_t value)
+    {
+        char temp[20];
+        char *p = temp + 20;
+        while (value >= 100)
+        {
+            const char *pair = decPairs() + ((value % 100) * 2);
+            value /= 100;
+            *--p = pair[1];
+            *--p = pair[0];
+        }
+        if (value >= 10)
+        {
+            const char *pair = decPairs() + (value * 2);
+            *--p = pair[1];
+            *--p = pair[0];
+        }
+        else *--p = static_cast<char>('0' + value);
+
+        int len = static_cast<int>((temp + 20) - p);
+        memcpy(out, p, len);
+        return out + len;
+    }
+
+    static inline char *decSigned(char *out, int64_t value)
+    {
+        if (value < 0)
+        {
+            *out++ = '-';
+            return dec(out, static_cast<uint64_t>(0) - static_cast<uint64_t>(value));
+        }
+        return dec(out, static_cast<uint64_t>(value));
+    }
+
+    //unsigned decimal, always exactly "digits" characters long. Zero padded on the left, excess high digits are dropped
+    static inline char *decPadded(char *out, uint64_t value, int digits)
+    {
+        int i = digits;
+        while (i >= 2)
+        {
+            const char *pair = decPairs() + ((value % 100) * 2);
+            value /= 100;
+            out[--i] = pair[1];
+            out[--i] = pair[0];
+        }
+        if (i) out[0] = static_cast<char>('0' + (value % 10));
+        return out + digits;
+    }
+
+    //unsigned decimal right justified in a field at least "width" characters wide. Longer numbers are not cut off
+    static inline char *decWidth(char *out, uint64_t value, int width, char fill)
+    {
+        char temp[20];
+        int len = static_cast<int>(dec(temp, value) - temp);
+        for (; width > len; width--) *out++ = fill;
+        memcpy(out, temp, len);
+        return out + len;
+    }
+
+    //a microsecond count written out as seconds with 6 digits after the decimal point (ie 12.000345)
+    static inline char *seconds(char *out, uint64_t micros)
+    {
+        out = dec(out, micros / 1000000ull);
+        *out++ = '.';
+        return decPadded(out, micros % 1000000ull, 6);
+    }
+
+    //a microsecond count written out as milliseconds with "decimals" digits after the decimal point (ie 12.345 for 3)
+    static inline char *millis(char *out, uint64_t micros, int decimals)
+    {
+        out = dec(out, micros / 1000ull);
+        if (decimals <= 0) return out;
+        *out++ = '.';
+        uint64_t frac = micros % 1000ull;
+        if (decimals < 3)
+        {
+            for (int i = decimals; i < 3; i++) frac /= 10;
+            return decPadded(out, frac, decimals);
+        }
+        out = decPadded(out, frac, 3);
+        for (int i = 3; i < decimals; i++) *out++ = '0';
+        return out;
+    }
+
+    static inline char *str(char *out, const char *text)
+    {
+        while (*text) *out++ = *text++;
+        return out;
+    }
+
+    static inline char *str(char *out, const char *text, int len)
+    {
+        memcpy(out, text, len);
+        return out + len;
+    }
+
+private:
+    static inline const char *hexPairs()
+    {
+        static const char table[] =
+            "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+            "202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+            "404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+            "606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+            "808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+            "A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+            "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+            "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+        return table;
+    }
+
+    static inline const char *decPairs()
+    {
+        static const char table[] =
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        return table;
+    }
+};
+
+#endif // FASTFORMAT_H
@@ -0,0 +1,97 @@
+#ifndef FRAMEIDINDEX_H
+#define FRAMEIDINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "can_structs.h"
+
+/*
+ * Positions of the frames of every ID within a frame list, so a window can jump straight to the frames of one ID instead
+ * of scanning or copying the whole capture. The index only stores row numbers. It gets brought up to date with sync(),
+ * which only looks at frames appended since the last call. The main frame list isn't only ever appended to though: the
+ * oldest frames get dropped once the list is full and changing filters rebuilds the filtered list. sync() notices
+ * that by checking that the first and last frame it indexed are still where it left them and indexes everything again
+ * if they aren't.
+*/
+class FrameIDIndex
+{
+public:
+    FrameIDIndex()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        rowsByID.clear();
+        idOrder.clear();
+        indexedCount = 0;
+    }
+
+    //Returns true if the whole list had to be indexed again, meaning row numbers from before are no good any more.
+    //Otherwise frames from the count() before the call up to the new count() are the ones which are new
+    bool sync(const QVector<CANFrame> &frames)
+    {
+        bool rebuilt = false;
+        if (indexedCount > 0 && (frames.count() < indexedCount || !sameFrame(frames.at(0), firstFrame)
+                                 || !sameFrame(frames.at(indexedCount - 1), lastFrame)))
+        {
+            clear();
+            rebuilt = true;
+        }
+
+        for (int i = indexedCount; i < frames.count(); i++)
+        {
+            uint32_t id = frames.at(i).frameId();
+            QHash<uint32_t, QVector<int>>::iterator it = rowsByID.find(id);
+            if (it == rowsByID.end())
+            {
+                it = rowsByID.insert(id, QVector<int>());
+                idOrder.append(id);
+            }
+            it.value().append(i);
+        }
+        indexedCount = frames.count();
+        if (indexedCount > 0)
+        {
+            firstFrame = frames.at(0);
+            lastFrame = frames.at(indexedCount - 1);
+        }
+        return rebuilt;
+    }
+
+    int count() const
+    {
+        return indexedCount;
+    }
+
+    //every ID seen, in the order they first showed up
+    const QList<uint32_t> &ids() const
+    {
+        return idOrder;
+    }
+
+    //rows of the frames with this ID, in list order
+    const QVector<int> &rows(uint32_t id) const
+    {
+        static const QVector<int> none;
+        QHash<uint32_t, QVector<int>>::const_iterator it = rowsByID.constFind(id);
+        if (it == rowsByID.constEnd()) return none;
+        return it.value();
+    }
+
+private:
+    QHash<uint32_t, QVector<int>> rowsByID;
+    QList<uint32_t> idOrder;
+    int indexedCount;
+    CANFrame firstFrame;
+    CANFrame lastFrame;
+
+    static bool sameFrame(const CANFrame &a, const CANFrame &b)
+    {
+        return a.frameId() == b.frameId() && a.bus == b.bus && a.timeStamp().microSeconds() == b.timeStamp().microSeconds();
+    }
+};
+
+#endif // FRAMEIDINDEX_H
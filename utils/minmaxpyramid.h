@@ -0,0 +1,201 @@
+#ifndef MINMAXPYRAMID_H
+#define MINMAXPYRAMID_H
+
+#include <QVector>
+#include <algorithm>
+#include <limits>
+
+/*
+ * A series of (key, value) points along with a level of detail pyramid over them, for plotting series far longer than
+ * the plot is wide. Level 1 splits the points into buckets of 4 and remembers which point in each bucket has the lowest
+ * and which has the highest value. Every level above groups 4 buckets of the level below. Points are only ever appended
+ * and the pyramid is kept up to date as they are, so a live capture costs a few comparisons per point.
+ * render() picks the coarsest level which still has at least one bucket per pixel over the visible range and hands back
+ * just the min and max point of each of those buckets. Spikes survive no matter how far out the view is zoomed and the
+ * work done per replot depends on the width of the plot instead of the length of the series.
+ * Keys are expected to never decrease (time stamps in capture order) but merged or hand edited captures and clock
+ * style time stamps wrapping at midnight can break that. The series keeps track of whether its keys are still in order
+ * and once they aren't render() just hands back every point, unsorted, and leaves the sorting up to the plot.
+*/
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        keyData.clear();
+        valueData.clear();
+        levels.clear();
+        minValue = std::numeric_limits<double>::max();
+        maxValue = std::numeric_limits<double>::lowest();
+        minKey = std::numeric_limits<double>::max();
+        maxKey = std::numeric_limits<double>::lowest();
+        sorted = true;
+    }
+
+    void reserve(int count)
+    {
+        keyData.reserve(count);
+        valueData.reserve(count);
+    }
+
+    void append(double key, double value)
+    {
+        int idx = keyData.count();
+        if (idx > 0 && key < keyData.last()) sorted = false;
+        if (key < minKey) minKey = key;
+        if (key > maxKey) maxKey = key;
+        keyData.append(key);
+        valueData.append(value);
+        if (value < minValue) minValue = value;
+        if (value > maxValue) maxValue = value;
+
+        //a new level is started the moment the one below it needs a second bucket. Its first bucket covers everything so far
+        if (levels.count() < MAX_LEVELS && idx == (1 << (2 * (levels.count() + 1))))
+        {
+            Bucket first;
+            first.minIndex = first.maxIndex = 0;
+            for (int i = 1; i < idx; i++)
+            {
+                if (valueData.at(i) < valueData.at(first.minIndex)) first.minIndex = i;
+                if (valueData.at(i) > valueData.at(first.maxIndex)) first.maxIndex = i;
+            }
+            levels.append(QVector<Bucket>());
+            levels.last().append(first);
+        }
+
+        for (int l = 0; l < levels.count(); l++)
+        {
+            QVector<Bucket> &level = levels[l];
+            if ((idx >> (2 * (l + 1))) == level.count())
+            {
+                Bucket bucket;
+                bucket.minIndex = bucket.maxIndex = idx;
+                level.append(bucket);
+            }
+            else
+            {
+                Bucket &bucket = level.last();
+                if (value < valueData.at(bucket.minIndex)) bucket.minIndex = idx;
+                if (value > valueData.at(bucket.maxIndex)) bucket.maxIndex = idx;
+            }
+        }
+    }
+
+    int count() const
+    {
+        return keyData.count();
+    }
+
+    const QVector<double> &keys() const
+    {
+        return keyData;
+    }
+
+    const QVector<double> &values() const
+    {
+        return valueData;
+    }
+
+    //true as long as no key was ever lower than the one before it
+    bool isSorted() const
+    {
+        return sorted;
+    }
+
+    bool keyRange(double &lower, double &upper) const
+    {
+        if (keyData.isEmpty()) return false;
+        lower = minKey;
+        upper = maxKey;
+        return true;
+    }
+
+    bool valueRange(double &lower, double &upper) const
+    {
+        if (valueData.isEmpty()) return false;
+        lower = minValue;
+        upper = maxValue;
+        return true;
+    }
+
+    //The points to draw for keys keyLower to keyUpper across pixelWidth pixels, in key order. One point either side
+    //of the range is included so lines run off the edges of the plot instead of stopping short of them.
+    //If the keys aren't sorted (see isSorted()) this is every point of the series in the order it was appended.
+    void render(double keyLower, double keyUpper, int pixelWidth, QVector<double> &outKeys, QVector<double> &outValues) const
+    {
+        outKeys.clear();
+        outValues.clear();
+        if (keyData.isEmpty()) return;
+        if (!sorted)
+        {
+            outKeys = keyData;
+            outValues = valueData;
+            return;
+        }
+
+        int first = static_cast<int>(std::lower_bound(keyData.constBegin(), keyData.constEnd(), keyLower) - keyData.constBegin()) - 1;
+        int last = static_cast<int>(std::upper_bound(keyData.constBegin(), keyData.constEnd(), keyUpper) - keyData.constBegin());
+        first = qMax(first, 0);
+        last = qMin(last, keyData.count() - 1);
+        if (last < first) return;
+
+        int span = last - first + 1;
+        int level = 0;
+        if (pixelWidth > 0)
+        {
+            while (level < levels.count() && (span >> (2 * (level + 1))) >= pixelWidth) level++;
+        }
+
+        if (level == 0)
+        {
+            outKeys = keyData.mid(first, span);
+            outValues = valueData.mid(first, span);
+            return;
+        }
+
+        const QVector<Bucket> &buckets = levels.at(level - 1);
+        int shift = 2 * level;
+        int firstBucket = first >> shift;
+        int lastBucket = qMin(last >> shift, buckets.count() - 1);
+        outKeys.reserve((lastBucket - firstBucket + 1) * 2);
+        outValues.reserve((lastBucket - firstBucket + 1) * 2);
+        for (int b = firstBucket; b <= lastBucket; b++)
+        {
+            const Bucket &bucket = buckets.at(b);
+            int lowIdx = qMin(bucket.minIndex, bucket.maxIndex);
+            int highIdx = qMax(bucket.minIndex, bucket.maxIndex);
+            outKeys.append(keyData.at(lowIdx));
+            outValues.append(valueData.at(lowIdx));
+            if (highIdx != lowIdx)
+            {
+                outKeys.append(keyData.at(highIdx));
+                outValues.append(valueData.at(highIdx));
+            }
+        }
+    }
+
+private:
+    static const int MAX_LEVELS = 14; //buckets of 4^14 points, leaves a handful at the top for the longest series an int can index
+
+    struct Bucket
+    {
+        int minIndex;
+        int maxIndex;
+    };
+
+    QVector<double> keyData;
+    QVector<double> valueData;
+    QVector<QVector<Bucket>> levels; //levels[0] is level 1, buckets of 4 points
+    double minValue;
+    double maxValue;
+    double minKey;
+    double maxKey;
+    bool sorted;
+};
+
+#endif // MINMAXPYRAMID_H
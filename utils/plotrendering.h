@@ -0,0 +1,153 @@
+#ifndef PLOTRENDERING_H
+#define PLOTRENDERING_H
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QTimer>
+#include <functional>
+#include "qcustomplot.h"
+
+/*
+ * Rendering setup shared by every window with a QCustomPlot in it. OpenGL is only ever used when the user turned it on
+ * (Main/UseOpenGL). QCustomPlot quietly goes back to its raster paint buffers when it can't get an OpenGL context or
+ * frame buffer objects but would leave the plot fully antialiased, which is much slower than the raster default. So
+ * after asking for OpenGL the plot is checked to see whether it really got it and if not is set up for raster again.
+ * Software OpenGL (Mesa llvmpipe and friends) counts as OpenGL here, the frame time readout shows whether it pays off.
+*/
+class PlotRendering
+{
+public:
+    //Returns true if the plot ended up rendering through OpenGL
+    static bool setup(QCustomPlot *plot, bool useOpenGL)
+    {
+        if (useOpenGL)
+        {
+            plot->setOpenGl(true);
+            if (plot->openGl())
+            {
+                plot->setAntialiasedElements(QCP::aeAll);
+                return true;
+            }
+            qDebug() << "OpenGL isn't available, falling back to raster plotting";
+        }
+        plot->setOpenGl(false);
+        plot->setAntialiasedElements(QCP::aeNone);
+        return false;
+    }
+
+    //Layer for things which are only there for whoever is looking at the plot on screen (frame times, progress) and
+    //have no business in a saved image. Created above the legend the first time it's asked for. See PlotExportGuard
+    static QCPLayer *diagnosticsLayer(QCustomPlot *plot)
+    {
+        QCPLayer *layer = plot->layer("diagnostics");
+        if (!layer)
+        {
+            plot->addLayer("diagnostics", plot->layer("legend"), QCustomPlot::limAbove);
+            layer = plot->layer("diagnostics");
+        }
+        return layer;
+    }
+
+    //A small label in the bottom right corner of the plot showing which renderer is in use and the average time replots
+    //take, as measured by QCustomPlot itself. It is refreshed right before every replot so it shows the time up to the
+    //one before. Goes away with the rest of the items if the plot's items get cleared.
+    static QCPItemText *addFrameTimeReadout(QCustomPlot *plot)
+    {
+        QCPItemText *readout = new QCPItemText(plot);
+        readout->setLayer(diagnosticsLayer(plot));
+        readout->position->setType(QCPItemPosition::ptAxisRectRatio);
+        readout->position->setCoords(QPointF(0.99, 0.99));
+        readout->setPositionAlignment(Qt::AlignRight|Qt::AlignBottom);
+        readout->setColor(Qt::gray);
+        readout->setFont(QFont(plot->font().family(), 8));
+        readout->setSelectable(false);
+        readout->setText(frameTimeText(plot));
+        QObject::connect(plot, &QCustomPlot::beforeReplot, readout, [plot, readout]()
+        {
+            readout->setText(frameTimeText(plot));
+        });
+        return readout;
+    }
+
+    static QString frameTimeText(const QCustomPlot *plot)
+    {
+        return QString("%1 %2 ms").arg(plot->openGl() ? "OpenGL" : "Raster").arg(plot->replotTime(true), 0, 'f', 1);
+    }
+};
+
+//Keeps the diagnostics layer out of the picture for as long as it exists. Put one in front of savePdf(), savePng()
+//and friends
+class PlotExportGuard
+{
+public:
+    explicit PlotExportGuard(QCustomPlot *plot)
+    {
+        layer = PlotRendering::diagnosticsLayer(plot);
+        wasVisible = layer->visible();
+        layer->setVisible(false);
+    }
+
+    ~PlotExportGuard()
+    {
+        layer->setVisible(wasVisible);
+    }
+
+private:
+    QCPLayer *layer;
+    bool wasVisible;
+};
+
+/*
+ * Live captures can deliver new frames far more often than it makes sense to redraw. Instead of replotting for every
+ * batch a window only calls schedule(), and any batches arriving before the replot happens get picked up by that same
+ * replot. Replots are spaced out to at most the configured rate (Graphing/MaxReplotFPS) and never closer together than
+ * twice the time the last one took, so a slow machine or a huge plot can't end up spending all of its time redrawing.
+ * When the time comes the callback given to the constructor runs. It does whatever the window needs done first and
+ * then calls replot() so the time the replot took is known for the next schedule().
+*/
+class ReplotScheduler
+{
+public:
+    ReplotScheduler(QObject *owner, std::function<void()> callback)
+    {
+        timer = new QTimer(owner);
+        timer->setSingleShot(true);
+        QObject::connect(timer, &QTimer::timeout, owner, callback);
+        lastReplotMs = 0;
+        maxReplotFPS = 30;
+    }
+
+    void readSettings()
+    {
+        QSettings settings;
+        maxReplotFPS = settings.value("Graphing/MaxReplotFPS", 30).toInt();
+        if (maxReplotFPS < 1) maxReplotFPS = 1;
+    }
+
+    void schedule()
+    {
+        if (timer->isActive()) return;
+
+        qint64 interval = qMax(static_cast<qint64>(1000 / maxReplotFPS), 2 * lastReplotMs);
+        qint64 sinceLast = replotClock.isValid() ? replotClock.elapsed() : interval;
+        timer->start(static_cast<int>(qMax(static_cast<qint64>(0), interval - sinceLast)));
+    }
+
+    void replot(QCustomPlot *plot)
+    {
+        QElapsedTimer replotTime;
+        replotTime.start();
+        plot->replot();
+        lastReplotMs = replotTime.elapsed();
+        replotClock.start();
+    }
+
+private:
+    QTimer *timer;              //owned by the window passed to the constructor
+    QElapsedTimer replotClock;  //time since the last replot
+    qint64 lastReplotMs;        //how long that replot took
+    int maxReplotFPS;
+};
+
+#endif // PLOTRENDERING_H
@@ -0,0 +1,144 @@
+#ifndef TEMPORALBINS_H
+#define TEMPORALBINS_H
+
+#include <QBitArray>
+#include <QMap>
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+
+/*
+ * The frames of a capture sorted by ID, each ID holding the times its frames came in. Appending a frame is one map lookup
+ * and one append so a live capture costs next to nothing per batch no matter how long it already is.
+ * Nothing is ever drawn straight out of here. render() and density() boil whatever part is in view down to the resolution
+ * it is shown at: render() hands back at most one point per pixel and density() counts frames per cell of a coarse grid.
+ * Both binary search their way from one pixel column to the next so the work depends on the size of the view and the number
+ * of IDs in it, not on how many frames there are.
+ * Times for each ID are expected to never decrease (capture order). If they do some points can be left out around there.
+*/
+class TemporalBins
+{
+public:
+    TemporalBins()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        tracks.clear();
+        frameCount = 0;
+        minTime = std::numeric_limits<double>::max();
+        maxTime = std::numeric_limits<double>::lowest();
+    }
+
+    void append(double time, uint32_t id)
+    {
+        tracks[id].append(time);
+        frameCount++;
+        if (time < minTime) minTime = time;
+        if (time > maxTime) maxTime = time;
+    }
+
+    int count() const
+    {
+        return frameCount;
+    }
+
+    bool timeRange(double &lower, double &upper) const
+    {
+        if (frameCount == 0) return false;
+        lower = minTime;
+        upper = maxTime;
+        return true;
+    }
+
+    bool idRange(double &lower, double &upper) const
+    {
+        if (tracks.isEmpty()) return false;
+        lower = tracks.firstKey();
+        upper = tracks.lastKey();
+        return true;
+    }
+
+    //Points to draw for the view timeLower to timeUpper across pixelWidth pixels and idLower to idUpper across pixelHeight
+    //pixels. Only the first frame to land on any one pixel makes it into the output.
+    void render(double timeLower, double timeUpper, int pixelWidth, double idLower, double idUpper, int pixelHeight,
+                QVector<double> &outTimes, QVector<double> &outIDs) const
+    {
+        outTimes.clear();
+        outIDs.clear();
+        if (pixelWidth < 1 || pixelHeight < 1 || timeUpper <= timeLower || idUpper < idLower || idUpper < 0) return;
+
+        double colWidth = (timeUpper - timeLower) / pixelWidth;
+        double rowHeight = qMax(idUpper - idLower, 1.0) / pixelHeight;
+        QBitArray taken(pixelWidth * pixelHeight);
+
+        QMap<uint32_t, QVector<double>>::const_iterator it = tracks.lowerBound(firstID(idLower));
+        for (; it != tracks.constEnd() && it.key() <= idUpper; ++it)
+        {
+            int row = qBound(0, static_cast<int>((it.key() - idLower) / rowHeight), pixelHeight - 1);
+            const QVector<double> &times = it.value();
+            QVector<double>::const_iterator pos = std::lower_bound(times.constBegin(), times.constEnd(), timeLower);
+            while (pos != times.constEnd() && *pos <= timeUpper)
+            {
+                int col = qBound(0, static_cast<int>((*pos - timeLower) / colWidth), pixelWidth - 1);
+                if (!taken.testBit((row * pixelWidth) + col))
+                {
+                    taken.setBit((row * pixelWidth) + col);
+                    outTimes.append(*pos);
+                    outIDs.append(it.key());
+                }
+                //skip straight to the first frame of the next pixel column
+                pos = std::lower_bound(pos + 1, times.constEnd(), timeLower + ((col + 1) * colWidth));
+            }
+        }
+    }
+
+    //Number of frames in each cell of a columns by rows grid laid over the view. outCounts[row * columns + column], row 0
+    //at idLower
+    void density(double timeLower, double timeUpper, int columns, double idLower, double idUpper, int rows,
+                 QVector<int> &outCounts) const
+    {
+        outCounts.fill(0, qMax(columns, 0) * qMax(rows, 0));
+        if (columns < 1 || rows < 1 || timeUpper <= timeLower || idUpper < idLower || idUpper < 0) return;
+
+        double colWidth = (timeUpper - timeLower) / columns;
+        double rowHeight = qMax(idUpper - idLower, 1.0) / rows;
+
+        QMap<uint32_t, QVector<double>>::const_iterator it = tracks.lowerBound(firstID(idLower));
+        for (; it != tracks.constEnd() && it.key() <= idUpper; ++it)
+        {
+            int row = qBound(0, static_cast<int>((it.key() - idLower) / rowHeight), rows - 1);
+            int *counts = outCounts.data() + (row * columns);
+            const QVector<double> &times = it.value();
+            QVector<double>::const_iterator pos = std::lower_bound(times.constBegin(), times.constEnd(), timeLower);
+            QVector<double>::const_iterator end = std::upper_bound(pos, times.constEnd(), timeUpper);
+            while (pos != end)
+            {
+                int col = qBound(0, static_cast<int>((*pos - timeLower) / colWidth), columns - 1);
+                QVector<double>::const_iterator next = (col == columns - 1) ? end
+                        : std::lower_bound(pos + 1, end, timeLower + ((col + 1) * colWidth));
+                counts[col] += static_cast<int>(next - pos);
+                pos = next;
+            }
+        }
+    }
+
+private:
+    QMap<uint32_t, QVector<double>> tracks;
+    int frameCount;
+    double minTime;
+    double maxTime;
+
+    static uint32_t firstID(double idLower)
+    {
+        if (idLower <= 0) return 0;
+        if (idLower >= std::numeric_limits<uint32_t>::max()) return std::numeric_limits<uint32_t>::max();
+        return static_cast<uint32_t>(std::ceil(idLower));
+    }
+};
+
+#endif // TEMPORALBINS_H